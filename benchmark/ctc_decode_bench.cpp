@@ -0,0 +1,153 @@
+/**
+ * CTC 解码微基准（合成 logits，不需要 NPU）
+ *
+ * 对每个识别 ratio 模型的时间步数（输入宽度 / 8）比较:
+ * - legacy: 标量 argmax + 每次调用的 std::vector + std::string 拼接（原实现）
+ * - fused : SIMD argmax + 连续字典表 + decodeInto 写入调用者缓冲
+ *
+ * 用法: ctc_decode_bench [iterations]
+ */
+#include "recognition/rec_postprocess.h"
+#include "recognition/ctc_kernels.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int kNumClasses = 18385;  // PP-OCRv5: 18383 字符 + blank + space
+
+// 原实现：逐时间步标量 argmax，去重/去 blank 后用 vector<string> 拼接文本
+std::pair<std::string, float> legacyDecode(const float* data, int time_steps, int num_classes,
+                                           const std::vector<std::string>& dict) {
+    std::vector<int> pred_indices;
+    std::vector<float> pred_probs;
+    pred_indices.reserve(time_steps);
+    pred_probs.reserve(time_steps);
+    for (int t = 0; t < time_steps; t++) {
+        const float* timestep_data = data + t * num_classes;
+        int max_idx = 0;
+        float max_prob = timestep_data[0];
+        for (int c = 1; c < num_classes; c++) {
+            if (timestep_data[c] > max_prob) {
+                max_prob = timestep_data[c];
+                max_idx = c;
+            }
+        }
+        pred_indices.push_back(max_idx);
+        pred_probs.push_back(max_prob);
+    }
+
+    std::vector<int> deduped_indices;
+    std::vector<float> deduped_probs;
+    deduped_indices.push_back(pred_indices[0]);
+    deduped_probs.push_back(pred_probs[0]);
+    for (size_t i = 1; i < pred_indices.size(); i++) {
+        if (pred_indices[i] != pred_indices[i - 1]) {
+            deduped_indices.push_back(pred_indices[i]);
+            deduped_probs.push_back(pred_probs[i]);
+        }
+    }
+
+    std::string text;
+    std::vector<float> confidences;
+    for (size_t i = 0; i < deduped_indices.size(); i++) {
+        if (deduped_indices[i] != 0) {
+            text += dict[deduped_indices[i]];
+            confidences.push_back(deduped_probs[i]);
+        }
+    }
+    float avg = confidences.empty() ? 0.0f
+        : std::accumulate(confidences.begin(), confidences.end(), 0.0f) / confidences.size();
+    return {text, avg};
+}
+
+// softmax 风格的合成输出：背景为小噪声，每个时间步一个尖峰（约一半是 blank）
+std::vector<float> syntheticLogits(int time_steps, std::mt19937& rng) {
+    std::uniform_real_distribution<float> noise(0.0f, 1e-4f);
+    std::uniform_int_distribution<int> cls(1, kNumClasses - 1);
+    std::vector<float> logits(static_cast<size_t>(time_steps) * kNumClasses);
+    for (auto& v : logits) v = noise(rng);
+    for (int t = 0; t < time_steps; t++) {
+        int idx = (t % 2 == 0) ? 0 : cls(rng);
+        logits[static_cast<size_t>(t) * kNumClasses + idx] = 0.9f;
+    }
+    return logits;
+}
+
+template <typename Fn>
+double timeUs(int iterations, Fn&& fn) {
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        fn();
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::micro>(t1 - t0).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iterations = 200;
+    if (argc > 1) {
+        iterations = std::atoi(argv[1]);
+        if (iterations < 1) iterations = 200;
+    }
+
+    // 合成字典：使用 3 字节 UTF-8 字符（与中文字典相同的编码长度）
+    std::vector<std::string> chars;
+    chars.reserve(kNumClasses - 2);
+    for (int i = 0; i < kNumClasses - 2; i++) {
+        uint32_t cp = 0x4E00 + i;
+        std::string ch;
+        ch += static_cast<char>(0xE0 | (cp >> 12));
+        ch += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        ch += static_cast<char>(0x80 | (cp & 0x3F));
+        chars.push_back(ch);
+    }
+    ocr::CTCDecoder decoder(chars, true);
+    std::vector<std::string> legacyDict;
+    legacyDict.push_back("blank");
+    legacyDict.insert(legacyDict.end(), chars.begin(), chars.end());
+    legacyDict.push_back(" ");
+
+    std::printf("CTC decode microbenchmark: %d classes, argmax ISA = %s, %d iterations\n",
+                kNumClasses, ocr::ctc_kernels::argmaxIsaName(), iterations);
+    std::printf("%-10s %10s %14s %14s %9s\n", "model", "timesteps", "legacy (us)", "fused (us)", "speedup");
+
+    std::mt19937 rng(42);
+    const int ratios[] = {3, 5, 10, 15, 25, 35};
+    for (int ratio : ratios) {
+        int width = (ratio == 3) ? 120 : 48 * ratio;
+        int time_steps = width / 8;
+        auto logits = syntheticLogits(time_steps, rng);
+
+        std::string text(decoder.maxTextBytes(time_steps), '\0');
+        size_t length = 0;
+
+        // 结果一致性检查
+        auto expected = legacyDecode(logits.data(), time_steps, kNumClasses, legacyDict);
+        decoder.decodeInto(logits.data(), time_steps, &text[0], text.size(), length);
+        if (expected.first != text.substr(0, length)) {
+            std::fprintf(stderr, "ratio_%d: decoded text mismatch\n", ratio);
+            return 1;
+        }
+
+        volatile size_t sink = 0;
+        double legacyUs = timeUs(iterations, [&]() {
+            sink = sink + legacyDecode(logits.data(), time_steps, kNumClasses, legacyDict).first.size();
+        });
+        double fusedUs = timeUs(iterations, [&]() {
+            decoder.decodeInto(logits.data(), time_steps, &text[0], text.size(), length);
+            sink = sink + length;
+        });
+
+        std::printf("ratio_%-4d %10d %14.1f %14.1f %8.2fx\n",
+                    ratio, time_steps, legacyUs, fusedUs, legacyUs / fusedUs);
+    }
+    return 0;
+}
@@ -62,6 +62,11 @@ if [ "$BUILD_TESTS" = true ]; then
     echo "========================================="
     echo "Running unit tests..."
     echo "========================================="
+    if [ -f "bin/core_tests" ]; then
+        ./bin/core_tests --gtest_color=yes
+    else
+        echo "Warning: core_tests not found"
+    fi
     if [ -f "bin/server_tests" ]; then
         ./bin/server_tests --gtest_color=yes
     else
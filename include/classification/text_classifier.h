@@ -9,6 +9,8 @@
 
 #include "common/logger.hpp"
 #include "common/types.hpp"
+#include "common/buffer_pool.hpp"
+#include "preprocessing/text_crop.h"
 
 namespace ocr {
 
@@ -79,6 +81,16 @@ public:
      */
     int ClassifyAsync(const cv::Mat& textImage, void* userArg);
     
+    /**
+     * @brief Classify a text box asynchronously, sampled straight from the full image
+     * @param image Full input image
+     * @param geom Crop geometry of the text box
+     * @param userArg User-provided context passed to callback
+     * @return 0 on success, -1 on error
+     * @note The box is rendered into a pooled 80x160 input buffer in one pass (no intermediate crop)
+     */
+    int ClassifyRegionAsync(const cv::Mat& image, const TextCropGeometry& geom, void* userArg);
+    
     // Check if image needs rotation based on classification result
     bool NeedsRotation(const std::string& label, float confidence) const {
         return (label == "180" && confidence > config_.threshold);
@@ -94,6 +106,7 @@ public:
 private:
     ClassifierConfig config_;
     std::unique_ptr<dxrt::InferenceEngine> engine_;
+    std::shared_ptr<BufferPool> inputPool_;  // Pooled 80x160 input buffers (async path)
     std::vector<std::string> labels_ = {"0", "180"};
     bool initialized_ = false;
     
@@ -102,7 +115,7 @@ private:
     
     // Context for async classification
     struct ClassificationContext {
-        cv::Mat preprocessed;  // Keep preprocessed image alive during async inference
+        BufferLease input;  // Pooled input buffer, returned to its pool when the context is deleted
         void* userArg;
     };
     
@@ -116,6 +129,11 @@ private:
     
     // Preprocessing
     cv::Mat Preprocess(const cv::Mat& image);
+    // Preprocess into dst (reused when it already has the input shape, e.g. a pooled buffer)
+    bool PreprocessInto(const cv::Mat& image, cv::Mat& dst);
+    
+    // Submit a preprocessed input; the context owns the buffer until the callback
+    void SubmitAsync(BufferLease input, void* userArg);
     
     // Postprocessing (argmax + softmax)
     std::pair<std::string, float> Postprocess(dxrt::TensorPtrs& outputs);
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ocr {
+
+class BufferPool;
+
+/**
+ * @brief 从 BufferPool 借出的输入缓冲（只能移动）
+ *
+ * 析构时缓冲自动归还给所属的池。mat() 返回指向该缓冲的 cv::Mat 头，
+ * 前处理直接写入其中，推理提交时把 data() 交给引擎。
+ * 池不可用（或输入类型与池不符）时也可以用 unpooled() 包装普通 cv::Mat。
+ */
+class BufferLease {
+public:
+    BufferLease() = default;
+    ~BufferLease() { reset(); }
+
+    BufferLease(BufferLease&& other) noexcept { *this = std::move(other); }
+    BufferLease& operator=(BufferLease&& other) noexcept {
+        if (this != &other) {
+            reset();
+            pool_ = std::move(other.pool_);
+            buffer_ = other.buffer_;
+            mat_ = other.mat_;
+            other.buffer_ = nullptr;
+            other.mat_ = cv::Mat();
+        }
+        return *this;
+    }
+    BufferLease(const BufferLease&) = delete;
+    BufferLease& operator=(const BufferLease&) = delete;
+
+    /**
+     * @brief 包装一个不属于任何池的 cv::Mat（由其引用计数管理内存）
+     */
+    static BufferLease unpooled(cv::Mat mat) {
+        BufferLease lease;
+        lease.mat_ = std::move(mat);
+        return lease;
+    }
+
+    cv::Mat& mat() { return mat_; }
+    const cv::Mat& mat() const { return mat_; }
+    void* data() const { return mat_.data; }
+    bool empty() const { return mat_.empty(); }
+    bool pooled() const { return buffer_ != nullptr; }
+
+    /**
+     * @brief 立即归还缓冲（析构时也会自动调用）
+     */
+    inline void reset();
+
+private:
+    friend class BufferPool;
+
+    std::shared_ptr<BufferPool> pool_;
+    void* buffer_ = nullptr;
+    cv::Mat mat_;
+};
+
+/**
+ * @brief 固定形状、页对齐的推理输入缓冲池（线程安全）
+ *
+ * 每个推理引擎（det 640/960、各 rec ratio、cls）各一个池。
+ * 借出的缓冲在异步回调结束、BufferLease 析构时归还，避免每次提交都分配/拷贝输入。
+ * 池通过 shared_ptr 被 BufferLease 持有，引擎先于在途任务销毁也是安全的。
+ */
+class BufferPool : public std::enable_shared_from_this<BufferPool> {
+public:
+    static constexpr size_t kAlignment = 4096;
+
+    /**
+     * @brief 创建缓冲池
+     * @param rows 缓冲高度
+     * @param cols 缓冲宽度
+     * @param type OpenCV 类型（如 CV_8UC3）
+     * @param maxIdle 最多保留的空闲缓冲数，超过的归还时直接释放
+     */
+    static std::shared_ptr<BufferPool> create(int rows, int cols, int type, size_t maxIdle = 16) {
+        return std::shared_ptr<BufferPool>(new BufferPool(rows, cols, type, maxIdle));
+    }
+
+    ~BufferPool() {
+        for (void* buffer : idle_) {
+            std::free(buffer);
+        }
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * @brief 借出一个缓冲（有空闲则复用，否则新分配）
+     * @return 缓冲租约；内存不足时返回 empty() 的租约
+     */
+    BufferLease acquire() {
+        void* buffer = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!idle_.empty()) {
+                buffer = idle_.back();
+                idle_.pop_back();
+            }
+        }
+        if (buffer) {
+            reused_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            buffer = std::aligned_alloc(kAlignment, allocSize_);
+            if (!buffer) return BufferLease();
+            allocated_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        BufferLease lease;
+        lease.pool_ = shared_from_this();
+        lease.buffer_ = buffer;
+        lease.mat_ = cv::Mat(rows_, cols_, type_, buffer);
+        return lease;
+    }
+
+    /**
+     * @brief 池中缓冲是否能直接承载该形状/类型
+     */
+    bool matches(int rows, int cols, int type) const {
+        return rows == rows_ && cols == cols_ && type == type_;
+    }
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    int type() const { return type_; }
+
+    // 统计：新分配次数、复用次数、当前空闲数
+    uint64_t allocated() const { return allocated_.load(std::memory_order_relaxed); }
+    uint64_t reused() const { return reused_.load(std::memory_order_relaxed); }
+    size_t idle() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return idle_.size();
+    }
+
+private:
+    friend class BufferLease;
+
+    BufferPool(int rows, int cols, int type, size_t maxIdle)
+        : rows_(rows), cols_(cols), type_(type), maxIdle_(maxIdle) {
+        size_t bytes = static_cast<size_t>(rows) * cols * CV_ELEM_SIZE(type);
+        allocSize_ = (bytes + kAlignment - 1) / kAlignment * kAlignment;
+    }
+
+    void release(void* buffer) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (idle_.size() < maxIdle_) {
+                idle_.push_back(buffer);
+                return;
+            }
+        }
+        std::free(buffer);
+    }
+
+    const int rows_;
+    const int cols_;
+    const int type_;
+    const size_t maxIdle_;
+    size_t allocSize_ = 0;
+
+    mutable std::mutex mutex_;
+    std::vector<void*> idle_;
+    std::atomic<uint64_t> allocated_{0};
+    std::atomic<uint64_t> reused_{0};
+};
+
+inline void BufferLease::reset() {
+    mat_ = cv::Mat();
+    if (pool_ && buffer_) {
+        pool_->release(buffer_);
+    }
+    buffer_ = nullptr;
+    pool_.reset();
+}
+
+} // namespace ocr
@@ -31,11 +31,19 @@ public:
         _cv_pop.notify_one();
     }
 
+    // push data with move semantics (wait if the queue is full)
+    void push(T&& value) {
+        std::unique_lock<std::mutex> lock(_mtx);
+        _cv_push.wait(lock, [this]() { return _q.size() < _max_size; });
+        _q.push(std::move(value));
+        _cv_pop.notify_one();
+    }
+
     // pop data (wait if the queue is empty)
     T pop() {
         std::unique_lock<std::mutex> lock(_mtx);
         _cv_pop.wait(lock, [this]() { return !_q.empty(); });
-        T value = _q.front();
+        T value = std::move(_q.front());
         _q.pop();
         _cv_push.notify_one();
         return value;
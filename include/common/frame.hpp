@@ -0,0 +1,111 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace ocr {
+
+class Frame;
+using FramePtr = std::shared_ptr<const Frame>;
+
+/**
+ * @brief 不可变、引用计数的图像帧
+ *
+ * 一张输入图片从提交到结果输出只持有一份像素缓冲，各阶段之间传递 FramePtr，
+ * 不再逐阶段 clone()。帧创建后像素不得再被修改（包括调用者手里的原 cv::Mat）。
+ *
+ * 仍然需要的深拷贝必须通过 Frame::copy() / Frame::clone() / Frame::derive() 完成，
+ * 或者在不经过 Frame 的拷贝处（缩放、拼图）调用 recordCopy()，
+ * 它们会计入本帧和全局的拷贝计数，便于定位剩余的内存拷贝。
+ */
+class Frame {
+public:
+    /**
+     * @brief 共享 image 的像素缓冲创建帧（不拷贝）
+     * @note 调用者之后不得再修改 image 的像素
+     */
+    static FramePtr share(const cv::Mat& image) {
+        return FramePtr(new Frame(image));
+    }
+
+    /**
+     * @brief 深拷贝 image 创建帧（计入拷贝计数）
+     */
+    static FramePtr copy(const cv::Mat& image) {
+        auto* frame = new Frame(image.clone());
+        frame->recordCopy(frame->bytes());
+        return FramePtr(frame);
+    }
+
+    /**
+     * @brief 由 source 派生的新图像创建帧（如文档预处理的输出；计入拷贝计数）
+     *
+     * image 由某个阶段从 source 生成（已是独立缓冲，这里不再拷贝），
+     * 新帧继承 source 的拷贝计数，并把 image 计为一次深拷贝。
+     */
+    static FramePtr derive(const cv::Mat& image, const FramePtr& source) {
+        auto* frame = new Frame(image);
+        if (source) {
+            frame->copies_.store(source->deepCopies(), std::memory_order_relaxed);
+            frame->copyBytes_.store(source->deepCopyBytes(), std::memory_order_relaxed);
+        }
+        frame->recordCopy(frame->bytes());
+        return FramePtr(frame);
+    }
+
+    Frame(const Frame&) = delete;
+    Frame& operator=(const Frame&) = delete;
+
+    const cv::Mat& image() const { return image_; }
+    bool empty() const { return image_.empty(); }
+    int rows() const { return image_.rows; }
+    int cols() const { return image_.cols; }
+    size_t bytes() const { return image_.total() * image_.elemSize(); }
+
+    /**
+     * @brief 需要可写副本时显式深拷贝（计入拷贝计数）
+     */
+    cv::Mat clone() const {
+        recordCopy(bytes());
+        return image_.clone();
+    }
+
+    /**
+     * @brief 记录一次不经过 Frame 的、由本帧像素生成的深拷贝（如检测前缩放、拼到 mosaic 画布）
+     */
+    void recordCopy(size_t nbytes) const {
+        copies_.fetch_add(1, std::memory_order_relaxed);
+        copyBytes_.fetch_add(nbytes, std::memory_order_relaxed);
+        globalCopies().fetch_add(1, std::memory_order_relaxed);
+        globalCopyBytes().fetch_add(nbytes, std::memory_order_relaxed);
+    }
+
+    // 本帧发生的深拷贝次数/字节数
+    int deepCopies() const { return copies_.load(std::memory_order_relaxed); }
+    size_t deepCopyBytes() const { return copyBytes_.load(std::memory_order_relaxed); }
+
+    // 进程内所有帧的深拷贝次数/字节数
+    static uint64_t totalDeepCopies() { return globalCopies().load(std::memory_order_relaxed); }
+    static uint64_t totalDeepCopyBytes() { return globalCopyBytes().load(std::memory_order_relaxed); }
+
+private:
+    explicit Frame(cv::Mat image) : image_(std::move(image)) {}
+
+    static std::atomic<uint64_t>& globalCopies() {
+        static std::atomic<uint64_t> count{0};
+        return count;
+    }
+
+    static std::atomic<uint64_t>& globalCopyBytes() {
+        static std::atomic<uint64_t> bytes{0};
+        return bytes;
+    }
+
+    cv::Mat image_;
+    mutable std::atomic<int> copies_{0};
+    mutable std::atomic<size_t> copyBytes_{0};
+};
+
+} // namespace ocr
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <cstring>
+
+namespace ocr {
+
+/**
+ * @brief 64 位 xxHash（XXH64），用于像素内容的缓存键
+ *
+ * 非加密哈希，单线程约 10 GB/s 量级；48x1680 的识别输入（~240KB）哈希耗时远小于一次 NPU 推理。
+ * 结果与参考实现 XXH64(data, len, seed) 一致（小端机器）。
+ */
+namespace xxh64_detail {
+
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline uint64_t read64(const uint8_t* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+inline uint32_t read32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+
+inline uint64_t round(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t val) {
+    acc ^= round(0, val);
+    return acc * kPrime1 + kPrime4;
+}
+
+} // namespace xxh64_detail
+
+inline uint64_t xxh64(const void* data, size_t len, uint64_t seed = 0) {
+    using namespace xxh64_detail;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        const uint8_t* limit = end - 32;
+        uint64_t v1 = seed + kPrime1 + kPrime2;
+        uint64_t v2 = seed + kPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - kPrime1;
+        do {
+            v1 = round(v1, read64(p)); p += 8;
+            v2 = round(v2, read64(p)); p += 8;
+            v3 = round(v3, read64(p)); p += 8;
+            v4 = round(v4, read64(p)); p += 8;
+        } while (p <= limit);
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    } else {
+        h = seed + kPrime5;
+    }
+
+    h += static_cast<uint64_t>(len);
+
+    while (p + 8 <= end) {
+        h ^= round(0, read64(p));
+        h = rotl(h, 27) * kPrime1 + kPrime4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * kPrime1;
+        h = rotl(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * kPrime5;
+        h = rotl(h, 11) * kPrime1;
+        p++;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+/**
+ * @brief 图像内容哈希（尺寸、类型与像素）
+ *
+ * 总是逐行串联（上一行的哈希作为下一行的种子），与内存布局无关：
+ * 非连续的 ROI 与它的连续拷贝得到相同的键。
+ */
+inline uint64_t hashMat(const cv::Mat& mat, uint64_t seed = 0) {
+    const int header[3] = {mat.rows, mat.cols, mat.type()};
+    uint64_t h = xxh64(header, sizeof(header), seed);
+    if (mat.empty()) {
+        return h;
+    }
+    const size_t rowBytes = static_cast<size_t>(mat.cols) * mat.elemSize();
+    for (int y = 0; y < mat.rows; y++) {
+        h = xxh64(mat.ptr(y), rowBytes, h);
+    }
+    return h;
+}
+
+} // namespace ocr
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ocr {
+
+/**
+ * @brief 分段加锁的 LRU 缓存（键为 64 位哈希，线程安全）
+ *
+ * 键按低位分到 stripes 个分段，每段一把锁、一条 LRU 链表，容量平均分配；
+ * 多个识别回调线程并发查询时只在同一分段上竞争。淘汰只在分段内进行，是近似的全局 LRU。
+ * capacity 为 0 时缓存关闭（get 总是未命中且不计数，put 忽略）。
+ */
+template <typename Value>
+class StripedLruCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t capacity = 0;
+
+        double hitRate() const {
+            uint64_t lookups = hits + misses;
+            return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+        }
+    };
+
+    explicit StripedLruCache(size_t capacity, size_t stripes = 16)
+        : capacity_(capacity) {
+        stripes = std::max<size_t>(1, std::min(stripes, std::max<size_t>(capacity, 1)));
+        stripes_.reserve(stripes);
+        for (size_t i = 0; i < stripes; i++) {
+            // 前 capacity % stripes 个分段多分一个，总容量恰好为 capacity
+            size_t share = capacity / stripes + (i < capacity % stripes ? 1 : 0);
+            stripes_.push_back(std::make_unique<Stripe>(share));
+        }
+    }
+
+    StripedLruCache(const StripedLruCache&) = delete;
+    StripedLruCache& operator=(const StripedLruCache&) = delete;
+
+    bool enabled() const { return capacity_ > 0; }
+
+    /**
+     * @brief 查询；命中时拷贝到 value 并移到链表头
+     */
+    bool get(uint64_t key, Value& value) {
+        if (!enabled()) {
+            return false;
+        }
+        Stripe& stripe = stripeOf(key);
+        {
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            auto it = stripe.index.find(key);
+            if (it != stripe.index.end()) {
+                stripe.lru.splice(stripe.lru.begin(), stripe.lru, it->second);
+                value = it->second->second;
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * @brief 插入或更新；分段满时淘汰最久未使用的条目
+     */
+    void put(uint64_t key, Value value) {
+        if (!enabled()) {
+            return;
+        }
+        Stripe& stripe = stripeOf(key);
+        if (stripe.capacity == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        auto it = stripe.index.find(key);
+        if (it != stripe.index.end()) {
+            it->second->second = std::move(value);
+            stripe.lru.splice(stripe.lru.begin(), stripe.lru, it->second);
+            return;
+        }
+        if (stripe.lru.size() >= stripe.capacity) {
+            stripe.index.erase(stripe.lru.back().first);
+            stripe.lru.pop_back();
+            evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+        stripe.lru.emplace_front(key, std::move(value));
+        stripe.index[key] = stripe.lru.begin();
+    }
+
+    void clear() {
+        for (auto& stripe : stripes_) {
+            std::lock_guard<std::mutex> lock(stripe->mutex);
+            stripe->lru.clear();
+            stripe->index.clear();
+        }
+    }
+
+    Stats stats() const {
+        Stats stats;
+        stats.hits = hits_.load(std::memory_order_relaxed);
+        stats.misses = misses_.load(std::memory_order_relaxed);
+        stats.evictions = evictions_.load(std::memory_order_relaxed);
+        stats.capacity = capacity_;
+        for (const auto& stripe : stripes_) {
+            std::lock_guard<std::mutex> lock(stripe->mutex);
+            stats.entries += stripe->lru.size();
+        }
+        return stats;
+    }
+
+private:
+    struct Stripe {
+        explicit Stripe(size_t cap) : capacity(cap) {}
+
+        const size_t capacity;
+        mutable std::mutex mutex;
+        std::list<std::pair<uint64_t, Value>> lru;  // 头部为最近使用
+        std::unordered_map<uint64_t, typename std::list<std::pair<uint64_t, Value>>::iterator> index;
+    };
+
+    Stripe& stripeOf(uint64_t key) {
+        // 键本身是哈希，折叠高位后取模即可均匀分布
+        return *stripes_[(key ^ (key >> 32)) % stripes_.size()];
+    }
+
+    const size_t capacity_;
+    std::vector<std::unique_ptr<Stripe>> stripes_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+};
+
+} // namespace ocr
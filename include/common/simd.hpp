@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ocr {
+namespace simd {
+
+/**
+ * @brief Instruction set used by the hand-vectorized CPU kernels
+ *
+ * The project is compiled for the baseline ISA, so AVX2/AVX-512 kernels are
+ * built with per-function target attributes and selected at runtime.
+ * NEON is part of the aarch64 baseline and is selected at compile time.
+ */
+enum class Isa {
+    Scalar,
+    NEON,
+    AVX2,
+    AVX512
+};
+
+inline bool hasAvx2() {
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+inline bool hasAvx512() {
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    static const bool supported = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+inline bool hasNeon() {
+#if defined(__aarch64__) && defined(__ARM_NEON)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Best instruction set available on the running CPU
+ */
+inline Isa detectIsa() {
+    if (hasAvx512()) return Isa::AVX512;
+    if (hasAvx2()) return Isa::AVX2;
+    if (hasNeon()) return Isa::NEON;
+    return Isa::Scalar;
+}
+
+inline const char* isaName(Isa isa) {
+    switch (isa) {
+        case Isa::AVX512: return "avx512";
+        case Isa::AVX2:   return "avx2";
+        case Isa::NEON:   return "neon";
+        default:          return "scalar";
+    }
+}
+
+} // namespace simd
+} // namespace ocr
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+namespace ocr {
+namespace db_components {
+
+/**
+ * @brief 单个连通域的统计信息（单次扫描得到）
+ */
+struct ComponentStats {
+    cv::Rect bbox;                  // 外接矩形
+    double probSum = 0.0;           // 概率图在连通域内的累加值（与 score map 同单位）
+    int pixelCount = 0;             // 像素个数
+    std::vector<cv::Point> points;  // 每行 run 的左右端点，凸包与全部像素一致，可直接用于 minAreaRect
+
+    double meanProb() const { return pixelCount > 0 ? probSum / pixelCount : 0.0; }
+};
+
+/**
+ * @brief 8 邻域连通域标记（基于行 run 的并查集，单次扫描）
+ *
+ * 扫描二值图时同时累加 score map 的概率和、像素数、外接矩形和 run 端点，
+ * 代价只与概率图大小线性相关，不随连通域数量增长。
+ * 输出顺序为连通域首个像素的光栅扫描顺序（从上到下，从左到右）。
+ *
+ * @param bitmap 二值图 CV_8UC1 (非零为前景)
+ * @param scoreMap 概率图 CV_32FC1 或量化后的 CV_8UC1，尺寸与 bitmap 相同
+ * @return 每个连通域的统计信息
+ */
+std::vector<ComponentStats> label(const cv::Mat& bitmap, const cv::Mat& scoreMap);
+
+} // namespace db_components
+} // namespace ocr
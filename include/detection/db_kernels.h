@@ -0,0 +1,41 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+
+namespace ocr {
+namespace db_kernels {
+
+/**
+ * @brief 单行概率图二值化（AVX2 / NEON / 标量实现，运行时选择）
+ *
+ * 一次读取概率值，同时输出:
+ * - bitmap[i]    = prob[i] > thresh ? 255 : 0   (与 cv::threshold + convertTo 结果一致)
+ * - quantized[i] = round(clamp(prob[i], 0, 1) * 255)   (可选，nullptr 表示不输出)
+ *
+ * @param prob 概率值 (float)
+ * @param n 像素个数
+ * @param thresh 二值化阈值
+ * @param bitmap 输出二值图 (uint8, 0/255)
+ * @param quantized 输出量化概率 (uint8)，可为 nullptr
+ */
+void binarizeRow(const float* prob, int n, float thresh,
+                 uint8_t* bitmap, uint8_t* quantized);
+
+/**
+ * @brief 概率图二值化（融合 threshold + convertTo + 可选量化）
+ * @param pred 网络输出的概率图 CV_32FC1
+ * @param thresh 二值化阈值
+ * @param bitmap 输出二值图 CV_8UC1 (0/255)
+ * @param quantized 输出量化概率图 CV_8UC1，nullptr 表示不需要
+ */
+void binarize(const cv::Mat& pred, float thresh,
+              cv::Mat& bitmap, cv::Mat* quantized = nullptr);
+
+/**
+ * @brief 当前 CPU 上 binarize 使用的指令集名称（用于日志）
+ */
+const char* binarizeIsaName();
+
+} // namespace db_kernels
+} // namespace ocr
@@ -2,7 +2,10 @@
 
 #include <opencv2/opencv.hpp>
 #include <vector>
+#include <memory>
+#include <functional>
 #include "common/types.hpp"
+#include "common/thread_pool.hpp"
 
 namespace ocr {
 
@@ -18,11 +21,23 @@ public:
      * @param box_thresh 检测框置信度阈值 (默认0.6)
      * @param max_candidates 最大候选框数量 (默认1000)
      * @param unclip_ratio 检测框扩展比例 (默认1.5)
+     * @param quantized_score 是否使用 uint8 量化概率图计算框分数 (默认false)
+     *        开启后二值化时顺带输出量化图，boxScoreFast 按 1/255 精度计算均值
+     * @param component_score 是否使用连通域统计代替逐轮廓填充掩码计算框分数 (默认false)
+     *        单次扫描得到所有区域的分数与点集，耗时与候选框数量无关
+     * @param num_workers 逐候选框后处理（打分/minAreaRect/unclip）的并行度 (默认1，串行)
+     *        >1 时候选框数超过阈值会分块并行处理，结果顺序与串行一致
+     * @param rect_unclip 是否对矩形框使用解析外扩代替 Clipper2 (默认true)
+     *        直接得到外扩后的有向矩形，省去多边形偏移和第二次 minAreaRect
      */
     DBPostProcessor(float thresh = 0.3f,
                    float box_thresh = 0.6f,
                    int max_candidates = 1000,
-                   float unclip_ratio = 1.5f);
+                   float unclip_ratio = 1.5f,
+                   bool quantized_score = false,
+                   bool component_score = false,
+                   int num_workers = 1,
+                   bool rect_unclip = true);
 
     /**
      * @brief 处理检测输出（使用成员变量中的默认参数）
@@ -68,8 +83,28 @@ private:
     std::vector<cv::Point2f> getMinBoxes(const std::vector<cv::Point>& contour,
                                          float& min_side);
 
+    /**
+     * @brief 对 [0, num_candidates) 逐个调用 build，按下标顺序收集成功生成的文本框
+     * @details 配置了 workers_ 且候选数足够多时分块并行执行
+     */
+    std::vector<DeepXOCR::TextBox> collectBoxes(
+        int num_candidates,
+        const std::function<bool(int, DeepXOCR::TextBox&)>& build);
+
+    /**
+     * @brief 由轮廓（或连通域点集）生成最终文本框
+     * @details minAreaRect → 过滤小框 → unclip → 映射回原图坐标
+     * @return false 表示框太小被过滤
+     */
+    bool buildTextBox(const std::vector<cv::Point>& contour,
+                      float score, float unclip_ratio,
+                      float scale_x, float scale_y,
+                      int src_h, int src_w,
+                      DeepXOCR::TextBox& text_box);
+
     /**
      * @brief 计算检测框的置信度分数
+     * @param bitmap 概率图，CV_32FC1 或量化后的 CV_8UC1 (0-255)
      */
     float boxScoreFast(const cv::Mat& bitmap,
                       const std::vector<cv::Point>& contour);
@@ -86,6 +121,16 @@ private:
      */
     std::vector<cv::Point2f> unclip(const std::vector<cv::Point2f>& box, float unclip_ratio);
 
+    /**
+     * @brief 矩形框的解析外扩（Clipper2 圆角外扩后取最小外接矩形的闭式解）
+     * @param box 有序矩形顶点（左上、右上、右下、左下）
+     * @param unclip_ratio 扩展比例
+     * @param expanded 输出外扩后的四个顶点
+     * @return false 表示退化矩形，需回退到 Clipper2 路径
+     */
+    bool unclipRect(const std::vector<cv::Point2f>& box, float unclip_ratio,
+                    std::vector<cv::Point2f>& expanded);
+
     /**
      * @brief 计算多边形面积
      */
@@ -101,6 +146,14 @@ private:
     float box_thresh_;      // 框置信度阈值
     int max_candidates_;    // 最大候选框数
     float unclip_ratio_;    // 扩展比例
+    bool quantized_score_;  // 使用量化概率图计算框分数
+    bool component_score_;  // 使用连通域统计计算框分数
+    bool rect_unclip_;      // 矩形框使用解析外扩
+
+    // 并行后处理（nullptr 表示串行）
+    std::unique_ptr<ThreadPool> workers_;
+    static constexpr int kParallelMinCandidates = 64;  // 少于该数量的候选框直接串行处理
+    static constexpr int kParallelMinChunk = 16;       // 每个并行块的最少候选框数
 };
 
 } // namespace ocr
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+#include "common/types.hpp"
+
+namespace ocr {
+namespace mosaic {
+
+/**
+ * @brief 把多张小图按原始尺寸排进一张正方形画布（按行排布，保留输入顺序）
+ *
+ * 从左上角开始逐行放置，同一行放不下时换到下一行；图与图之间留 margin 像素的隔离带
+ * （检测时填充为背景色，避免相邻图片的文字连成一个框）。
+ *
+ * @param sizes 各图像尺寸（按放置顺序）
+ * @param canvasSize 画布边长（检测模型输入尺寸）
+ * @param margin 图像间的隔离带宽度
+ * @return 放进画布的图像位置；画布放满时只返回前面能放下的部分（size() < sizes.size()）
+ */
+std::vector<cv::Rect> pack(const std::vector<cv::Size>& sizes, int canvasSize, int margin);
+
+/**
+ * @brief 把画布上的检测框分回各自的源图像
+ *
+ * 框按中心点所在的放置区域归属，减去放置偏移并裁剪到源图像范围；
+ * 中心点落在隔离带或空白区域的框丢弃。
+ *
+ * @param boxes 画布坐标下的检测框
+ * @param placements pack() 的输出
+ * @return 每张源图像的检测框（源图像坐标），与 placements 一一对应
+ */
+std::vector<std::vector<DeepXOCR::TextBox>> splitBoxes(const std::vector<DeepXOCR::TextBox>& boxes,
+                                                       const std::vector<cv::Rect>& placements);
+
+} // namespace mosaic
+} // namespace ocr
@@ -7,14 +7,30 @@
 #include <memory>
 #include <string>
 #include <functional>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 #include "common/logger.hpp"
 #include "common/types.hpp"
+#include "common/frame.hpp"
+#include "common/buffer_pool.hpp"
+#include "common/lru_cache.hpp"
 
 namespace ocr {
 
 // Forward declaration
 class DBPostProcessor;
+struct TiledDetectionJob;  // Shared state of one tiled page (text_detector.cpp)
+struct MosaicDetectionJob; // Source images of one mosaic canvas (text_detector.cpp)
+
+/**
+ * @brief One source image of a mosaic canvas
+ */
+struct MosaicItem {
+    int64_t taskId;
+    FramePtr frame;  // BGR image placed on the canvas at its own size
+};
 
 struct DetectionContext {
     int orig_h;
@@ -22,17 +38,47 @@ struct DetectionContext {
     int resized_h;
     int resized_w;
     int64_t taskId;
-    cv::Mat originalImage;
-    cv::Mat inputImage; // Keep input data alive
+    FramePtr frame;     // Original image for next stage (shared, not copied)
+    BufferLease input;  // Pooled input buffer, returned to its pool when the context is destroyed
     double preprocess_time; // Pass preprocess time to callback
     
     // Per-task detection parameters (覆盖默认值)
     float thresh = 0.3f;          // 二值化阈值
     float boxThresh = 0.6f;       // 检测框置信度阈值
     float unclipRatio = 1.5f;     // 检测扩张系数
+    
+    uint64_t probMapKey = 0;      // 非 0 时把概率图写入缓存（见 TextDetector::probMapKey）
+    
+    // Tiled detection: orig_h/orig_w are the tile size, boxes are offset into the page
+    std::shared_ptr<TiledDetectionJob> tiledJob;
+    size_t tileIndex = 0;
+    
+    // Mosaic detection: boxes are split back to the source images (one callback per image)
+    std::shared_ptr<MosaicDetectionJob> mosaicJob;
 };
 
-using DetectionCallback = std::function<void(std::vector<DeepXOCR::TextBox> boxes, int64_t taskId, cv::Mat image, double preprocess_time, double inference_time, double postprocess_time)>;
+/**
+ * @brief Model resolution decisions of a detector (single-shot detections, not tiles or mosaics)
+ */
+struct DetectionResolutionStats {
+    std::string policy;           // "max-side" (sizeThreshold) or "text-scale" (adaptiveResolution)
+    uint64_t model640 = 0;        // Images sent to det_640
+    uint64_t model960 = 0;        // Images sent to det_960
+    uint64_t estimated = 0;       // Decided by the text-scale estimate
+    uint64_t fallback = 0;        // Estimate inconclusive (too little ink), sizeThreshold used
+    uint64_t downgraded = 0;      // Estimate chose 640 where sizeThreshold would choose 960
+    uint64_t upgraded = 0;        // Estimate chose 960 where sizeThreshold would choose 640
+    double estimateTimeMs = 0.0;  // Total time spent estimating
+    
+    double share640() const {
+        uint64_t total = model640 + model960;
+        return total > 0 ? static_cast<double>(model640) / total : 0.0;
+    }
+    void add(const DetectionResolutionStats& other);
+    void Show() const;
+};
+
+using DetectionCallback = std::function<void(std::vector<DeepXOCR::TextBox> boxes, int64_t taskId, FramePtr frame, double preprocess_time, double inference_time, double postprocess_time)>;
 
 /**
  * Text Detector Configuration
@@ -44,6 +90,10 @@ struct DetectorConfig {
     float boxThresh = 0.6f;       // Box confidence threshold
     float unclipRatio = 1.5f;     // Box expansion ratio
     int maxCandidates = 1500;     // Max number of candidate boxes
+    bool quantizedBoxScore = false;  // Score boxes on a uint8-quantized prob map (1/255 precision)
+    bool componentBoxScore = false;  // Score boxes from one-pass connected-component stats instead of per-contour masks
+    int postprocessWorkers = 1;      // Threads for per-contour postprocess (1 = serial, output order is identical)
+    bool rectUnclip = true;          // Closed-form unclip for rectangular boxes (false = Clipper2 round-trip)
     
     // Model paths for different resolutions (default paths - will be resolved to absolute paths)
     std::string model640Path = std::string(PROJECT_ROOT_DIR) + "/engine/model_files/server/det_v5_640.dxnn";
@@ -55,6 +105,30 @@ struct DetectorConfig {
     // Image size threshold for model selection
     int sizeThreshold = 800;      // Use 640 if max(w,h) < threshold, else 960
     
+    // Adaptive resolution: choose the model from the estimated text size instead of sizeThreshold.
+    // Stroke width is measured on a <=960 px thumbnail (see estimateTextScale); an image goes to
+    // det_640 when its thin strokes (strokePercentile) stay at least minStrokePx wide at 640,
+    // else to det_960. Images with too little ink fall back to sizeThreshold.
+    bool adaptiveResolution = false;
+    float minStrokePx = 2.0f;
+    float strokePercentile = 0.25f;
+    
+    // Probability map cache: keeps the last N pred maps (quantized to u8, ~0.9MB at 960)
+    // keyed by image hash + model size, so a re-run of the same image with different
+    // thresh/boxThresh/unclipRatio only runs the CPU postprocess. 0 = disabled.
+    // Cached maps carry 1/255 precision, so a hit may differ marginally from fresh inference.
+    size_t probMapCacheSize = 0;
+    
+    // Tiled detection for pages far larger than the model input (long receipts, large
+    // drawings): instead of squeezing the whole page into one 960 input, the page is cut
+    // into overlapping tiles detected at (close to) native resolution and the boxes merged.
+    bool useTiling = false;
+    int tileSize = 960;               // Tile side in page pixels (a model size avoids resizing)
+    int tileOverlap = 128;            // Overlap between neighbouring tiles, should exceed the tallest text line
+    float tileMinDownscale = 4.0f;    // Tile only pages the single-shot path would downscale more than this
+    int maxTiles = 64;                // More tiles than this: tiles grow (downscaled into the model) to fit
+    int maxTilesInFlight = 4;         // Tiles submitted but not returned (bounds pooled input buffers)
+    
     // Mean and scale for normalization
     std::vector<float> mean = {0.485f, 0.456f, 0.406f};
     std::vector<float> scale = {0.229f, 0.224f, 0.225f};
@@ -63,6 +137,16 @@ struct DetectorConfig {
     bool saveIntermediates = false;
     std::string outputDir = "test";
     
+    // Mobile model set (det_mobile_640/960), e.g. the fast tier of a two-tier pipeline
+    static DetectorConfig Mobile() {
+        DetectorConfig config;
+        const std::string root = std::string(PROJECT_ROOT_DIR) + "/engine/model_files/mobile";
+        config.model640Path = root + "/det_mobile_640.dxnn";
+        config.model960Path = root + "/det_mobile_960.dxnn";
+        config.useMobileModel = true;
+        return config;
+    }
+    
     void Show() const;
 };
 
@@ -101,6 +185,18 @@ public:
      * @return Target size (640 or 960)
      */
     int getTargetSize(int height, int width);
+    
+    /**
+     * @brief Choose the target size for an image (sizeThreshold, or the text-scale estimate
+     *        when adaptiveResolution is on) and record the decision in the resolution stats
+     * @return Target size (640 or 960)
+     */
+    int chooseTargetSize(const cv::Mat& image);
+    
+    /**
+     * @brief Resolution policy and decision counters
+     */
+    DetectionResolutionStats getResolutionStats() const;
 
     /**
      * @brief Preprocess image and return input tensor data
@@ -108,9 +204,9 @@ public:
      * @param target_size Target size for resizing
      * @param resized_h Output resized height
      * @param resized_w Output resized width
-     * @return Preprocessed image data (CHW format)
+     * @return Preprocessed image data (HWC uint8), written straight into a pooled input buffer
      */
-    cv::Mat preprocessAsync(const cv::Mat& image, int target_size, int& resized_h, int& resized_w);
+    BufferLease preprocessAsync(const cv::Mat& image, int target_size, int& resized_h, int& resized_w);
 
     /**
      * @brief Submit async inference task（使用默认检测参数）
@@ -120,12 +216,13 @@ public:
      * @param resized_h Resized image height
      * @param resized_w Resized image width
      * @param taskId Task ID for tracking
-     * @param originalImage Original image for next stage
+     * @param frame Original image for next stage (shared, not copied)
      * @param preprocess_time Time taken for preprocessing
      * @return Job ID
+     * @note input is owned by the task until the callback, then returned to its pool
      */
-    int runAsync(const cv::Mat& input, int orig_h, int orig_w, int resized_h, int resized_w, 
-                 int64_t taskId, const cv::Mat& originalImage, double preprocess_time);
+    int runAsync(BufferLease input, int orig_h, int orig_w, int resized_h, int resized_w, 
+                 int64_t taskId, FramePtr frame, double preprocess_time);
     
     /**
      * @brief Submit async inference task（支持 per-task 检测参数）
@@ -135,16 +232,96 @@ public:
      * @param resized_h Resized image height
      * @param resized_w Resized image width
      * @param taskId Task ID for tracking
-     * @param originalImage Original image for next stage
+     * @param frame Original image for next stage (shared, not copied)
      * @param preprocess_time Time taken for preprocessing
      * @param thresh 二值化阈值
      * @param boxThresh 检测框置信度阈值
      * @param unclipRatio 检测扩张系数
+     * @param probMapKey 概率图缓存键（probMapKey() 的返回值，0 = 不缓存）
      * @return Job ID
      */
-    int runAsync(const cv::Mat& input, int orig_h, int orig_w, int resized_h, int resized_w, 
-                 int64_t taskId, const cv::Mat& originalImage, double preprocess_time,
-                 float thresh, float boxThresh, float unclipRatio);
+    int runAsync(BufferLease input, int orig_h, int orig_w, int resized_h, int resized_w, 
+                 int64_t taskId, FramePtr frame, double preprocess_time,
+                 float thresh, float boxThresh, float unclipRatio,
+                 uint64_t probMapKey = 0);
+
+    /**
+     * @brief Whether a page of this size takes the tiled path (useTiling and downscale above tileMinDownscale)
+     */
+    bool shouldTile(int height, int width);
+    
+    /**
+     * @brief Submit a page as overlapping tiles（支持 per-task 检测参数）
+     * 
+     * Tiles are ROIs of the frame resized straight into pooled input buffers, so no full-page
+     * copy is made; at most maxTilesInFlight tiles are queued (the call blocks until a slot
+     * frees). The callback fires once per page with the merged boxes in page coordinates.
+     * @return 0 on success, -1 when no tile could be submitted
+     */
+    int runTiledAsync(int64_t taskId, FramePtr frame, double preprocess_time,
+                      float thresh, float boxThresh, float unclipRatio);
+    
+    /**
+     * @brief Detect only the given regions of a page（支持 per-task 检测参数）
+     * 
+     * Same submission path as runTiledAsync with the regions as tiles: each region is detected
+     * at its own size (the 640 model for regions up to sizeThreshold), boxes from overlapping
+     * regions are merged, and the callback fires once with the boxes in page coordinates.
+     * @param regions Page rects (inside the page, non-empty)
+     * @param scales Per-region resize ratio applied before detection (textDetLimitSideLen);
+     *               empty means 1.0 for every region, otherwise one positive ratio per region
+     * @return 0 on success, -1 when no region could be submitted
+     */
+    int runRegionsAsync(int64_t taskId, FramePtr frame, const std::vector<cv::Rect>& regions,
+                        double preprocess_time, float thresh, float boxThresh, float unclipRatio,
+                        const std::vector<double>& scales = {});
+
+    /**
+     * @brief Canvas size for mosaic detection (the smallest loaded model input)
+     */
+    int mosaicCanvasSize() const;
+    
+    /**
+     * @brief Detect several small images in one inference（支持 per-task 检测参数）
+     * 
+     * The images are copied at their own size into a pooled canvas at the given placements
+     * (see mosaic::pack, the rest of the canvas is padding) and detected at scale 1.
+     * The callback fires once per image with its own taskId, frame and boxes in image coordinates.
+     * @param placements Canvas rects, one per item, sized like the item images
+     * @return 0 on success, -1 if nothing was submitted
+     */
+    int runMosaicAsync(const std::vector<MosaicItem>& items, const std::vector<cv::Rect>& placements,
+                       double preprocess_time, float thresh, float boxThresh, float unclipRatio);
+
+    /**
+     * @brief Probability map cache key of an image for the model chosen by target_size
+     * @return 0 when the cache is disabled
+     */
+    uint64_t probMapKey(const cv::Mat& image, int target_size) const;
+    
+    /**
+     * @brief Answer a task from the probability map cache (postprocess only, no inference)
+     * 
+     * On a hit the callback fires synchronously on the calling thread, exactly as
+     * runAsync would fire it from the inference callback.
+     * @return true on a hit; false when the map is not cached (submit with runAsync)
+     */
+    bool runCached(uint64_t key, int orig_h, int orig_w, int64_t taskId, FramePtr frame,
+                   double preprocess_time, float thresh, float boxThresh, float unclipRatio);
+    
+    /**
+     * @brief Probability map cache statistics
+     */
+    StripedLruCache<cv::Mat>::Stats getProbMapCacheStats() const;
+    
+    /**
+     * @brief Probability map cache access (maps are stored as u8, returned as CV_32FC1 in [0, 1])
+     * 
+     * storeProbMap is called by the inference paths; lookupProbMap returns false on a miss
+     * or when the cache is disabled.
+     */
+    bool lookupProbMap(uint64_t key, cv::Mat& pred);
+    void storeProbMap(uint64_t key, const cv::Mat& pred);
 
     /**
      * @brief Get last detection timing details
@@ -167,23 +344,60 @@ private:
     dxrt::InferenceEngine* selectModel(int height, int width);
     
     /**
-     * @brief Preprocess image for detection
+     * @brief Model for a preprocessed input size (640 or 960), falling back to the other model
      */
-    cv::Mat preprocess(const cv::Mat& image, int target_size, 
-                      int& resized_h, int& resized_w);
+    dxrt::InferenceEngine* modelForSize(int target_size);
+    
+    /**
+     * @brief Preprocess image for detection into dst (reuses dst if it already has the target shape)
+     */
+    void preprocess(const cv::Mat& image, int target_size,
+                    int& resized_h, int& resized_w, cv::Mat& dst);
     
     /**
      * @brief Run inference on preprocessed image
      */
     cv::Mat runInference(dxrt::InferenceEngine* engine, const cv::Mat& input);
+    
+    /**
+     * @brief Record one finished tile; the last tile of a page merges the boxes and fires the callback
+     */
+    void finishTile(DetectionContext& ctx, std::vector<DeepXOCR::TextBox> boxes);
+    
+    /**
+     * @brief Submit the tiles of a prepared job (blocks while maxTilesInFlight tiles are queued)
+     */
+    int submitTiles(const std::shared_ptr<TiledDetectionJob>& job, float thresh, float boxThresh, float unclipRatio);
+    
+    /**
+     * @brief Split mosaic canvas boxes back to the source images and fire one callback per image
+     */
+    void finishMosaic(DetectionContext& ctx, const std::vector<DeepXOCR::TextBox>& boxes, double postprocess_time);
 
 private:
     DetectorConfig config_;
     std::unique_ptr<dxrt::InferenceEngine> model640_;
     std::unique_ptr<dxrt::InferenceEngine> model960_;
     std::unique_ptr<DBPostProcessor> postprocessor_;
+    std::shared_ptr<BufferPool> inputPool640_;  // Input buffers for det_640
+    std::shared_ptr<BufferPool> inputPool960_;  // Input buffers for det_960
+    std::unique_ptr<StripedLruCache<cv::Mat>> probMapCache_;  // u8 pred maps (nullptr when disabled)
     bool initialized_ = false;
     
+    // Tiles in flight across all tiled pages (see maxTilesInFlight)
+    std::mutex tileMutex_;
+    std::condition_variable tileCv_;
+    int tilesInFlight_ = 0;
+    
+    // Resolution decisions (see DetectionResolutionStats)
+    std::atomic<uint64_t> resolution640_{0};
+    std::atomic<uint64_t> resolution960_{0};
+    std::atomic<uint64_t> resolutionEstimated_{0};
+    std::atomic<uint64_t> resolutionFallback_{0};
+    std::atomic<uint64_t> resolutionDowngraded_{0};
+    std::atomic<uint64_t> resolutionUpgraded_{0};
+    std::atomic<uint64_t> estimateTimeUs_{0};
+    
     DetectionCallback userCallback_;
 
     // Timing details of last detection
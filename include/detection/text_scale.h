@@ -0,0 +1,32 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+namespace ocr {
+
+/**
+ * @brief 图像中文字笔画宽度的估计结果
+ */
+struct TextScaleEstimate {
+    bool valid = false;        // 墨迹游程足够多，估计可信
+    float strokeWidth = 0.0f;  // 笔画宽度（原图像素，游程长度的 percentile 分位数）
+    int runs = 0;              // 参与统计的墨迹游程数
+};
+
+/**
+ * @brief 在缩略图上估计文字笔画宽度（CPU，约 1~3ms）
+ *
+ * 缩略图长边不超过 maxThumbSide（取最大检测模型的尺寸，在 960 模型上仍可见的笔画在缩略图上也可见），
+ * 灰度化后用 Otsu 二值化（墨迹取像素较少的一类，兼容浅色文字），统计水平和垂直方向墨迹游程长度。
+ * 笔画的横截面产生短游程，取较低的分位数作为笔画宽度，偏向细笔画（宁可选大模型，不损失召回）。
+ * 超过缩略图边长 1/8 的游程（表格线、色块）不计入。
+ *
+ * @param image 输入图像（BGR 或灰度）
+ * @param maxThumbSide 缩略图长边上限
+ * @param percentile 笔画宽度分位数 (0, 1]
+ * @param minRuns 游程数少于此值时 valid = false（空白页、照片）
+ */
+TextScaleEstimate estimateTextScale(const cv::Mat& image, int maxThumbSide = 960,
+                                    float percentile = 0.25f, int minRuns = 200);
+
+} // namespace ocr
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+#include "common/types.hpp"
+
+namespace ocr {
+namespace tiling {
+
+/**
+ * @brief 大图分块检测中的一个分块
+ */
+struct Tile {
+    cv::Rect rect;       // 分块在整页中的区域
+    cv::Rect exclusive;  // 只被本分块覆盖的区域（不与相邻分块重叠）
+};
+
+/**
+ * @brief 把整页切成相互重叠的分块（按行优先顺序输出）
+ *
+ * 分块边长为 tileSize，相邻分块至少重叠 overlap 像素，最后一列/行与页面边缘对齐；
+ * 页面某一边不超过分块边长时该方向只有一块（宽度为页面宽度）。
+ * 按原始分辨率切分的块数超过 maxTiles 时，按比例放大分块边长和重叠
+ * （检测时再缩放到模型输入），直到块数不超过 maxTiles。
+ *
+ * @param height 页面高度
+ * @param width 页面宽度
+ * @param tileSize 分块边长（页面像素）
+ * @param overlap 相邻分块的最小重叠（页面像素），应大于最高的文本行
+ * @param maxTiles 块数上限（<= 0 不限制）
+ */
+std::vector<Tile> planTiles(int height, int width, int tileSize, int overlap, int maxTiles);
+
+/**
+ * @brief 合并各分块的检测框（已映射到整页坐标）
+ *
+ * 完全落在分块独占区域内的框原样保留；位于重叠带内、来自不同分块的框在以下情况下合并为
+ * 覆盖两者的最小外接矩形（置信度取较大值）：
+ * - 重复检测：交集占较小框的面积 >= 0.5
+ * - 被分块边界截断的同一文本行：两框方向相同、相交，且在行高方向上的重叠 >= 0.5
+ * 同一分块内的框不会相互合并，分块内部的结果与单独检测该分块时一致。
+ *
+ * @param tileBoxes 每个分块的检测框，与 tiles 一一对应
+ * @param tiles planTiles() 的输出
+ */
+std::vector<DeepXOCR::TextBox> mergeTileBoxes(const std::vector<std::vector<DeepXOCR::TextBox>>& tileBoxes,
+                                              const std::vector<Tile>& tiles);
+
+} // namespace tiling
+} // namespace ocr
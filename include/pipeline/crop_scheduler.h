@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ocr {
+
+/**
+ * @brief Crop 调度器配置
+ */
+struct CropSchedulerConfig {
+    size_t maxInFlight = 64;    // 已提交未完成的 crop 上限（超过后在调度器中排队，才有重排的余地）
+    size_t maxRunLength = 16;   // 一次连续提交到同一 ratio 引擎的最大 job 数
+
+    void Show() const;
+};
+
+/**
+ * @brief 一个识别 job（单个 crop，或一组拼接的短 crop）
+ */
+struct CropJob {
+    int64_t taskId = 0;             // 所属任务（页面）
+    int ratio = 0;                  // 目标 ratio 模型
+    int tier = 0;                   // 模型档位（不同档位的同一 ratio 是不同引擎）
+    int length = 0;                 // crop 在模型高度下的宽度（同一任务内长的先提交）
+    size_t weight = 1;              // job 携带的 crop 数（每个 crop 各自调用一次 complete()）
+    std::function<void()> submit;   // 提交到识别器（在调度线程上调用）
+    // 调度器停止时 job 仍在排队：以失败结果结束 job 携带的 crop（释放其上下文，任务照常收尾）；
+    // 为空时改为直接调用 submit
+    std::function<void()> cancel;
+    // 任务尚未完成的 crop 总数（含尚未裁剪入队和在途的），用作任务优先级；
+    // 为空时退化为任务在调度器中排队的 crop 数
+    std::shared_ptr<const std::atomic<int>> remaining;
+};
+
+/**
+ * @brief 调度器统计
+ */
+struct CropSchedulerStats {
+    std::string policy;                 // 调度策略描述
+    size_t queued = 0;                  // 排队中的 crop 数
+    size_t inFlight = 0;                // 已提交未完成的 crop 数
+    size_t tasks = 0;                   // 有 crop 排队的任务数
+    std::map<int, size_t> queueDepth;   // 各引擎队列中的 job 数（key 见 CropScheduler::engineKey）
+    uint64_t submitted = 0;             // 累计提交的 job 数
+    uint64_t runs = 0;                  // 累计 run 数（连续提交到同一引擎的一批 job）
+    uint64_t engineSwitches = 0;        // 相邻两个 run 使用不同引擎的次数
+
+    double avgRunLength() const { return runs > 0 ? static_cast<double>(submitted) / runs : 0.0; }
+    void Show() const;
+};
+
+/**
+ * @brief 识别 crop 的集中调度器（位于裁剪与 RecognizeAsync 之间）
+ *
+ * 策略：
+ * 1. 剩余 crop 最少的任务优先（最短剩余作业优先，降低平均页面延迟）；剩余数取 CropJob::remaining，
+ *    即任务全部未完成的 crop，刚开始逐个入队的大页面不会因排队数少而插到快完成的页面之前；
+ * 2. 任务内按 crop 长度从长到短（降低 makespan）；
+ * 3. 每次从同一 ratio 队列连续提交一批 job（先取优先任务的，再按优先级取其他任务同 ratio 的），
+ *    减少在六个 ratio 引擎之间来回切换。
+ *
+ * 同时在途的 crop 数受 maxInFlight 限制，其余留在调度器中等待重排。
+ * 每个提交的 crop 完成后（无论成功与否）必须调用一次 complete()。
+ *
+ * start() 启动调度线程；不启动时可以手动调用 dispatchOnce()（测试使用）。
+ */
+class CropScheduler {
+public:
+    explicit CropScheduler(const CropSchedulerConfig& config = CropSchedulerConfig());
+    ~CropScheduler();
+
+    CropScheduler(const CropScheduler&) = delete;
+    CropScheduler& operator=(const CropScheduler&) = delete;
+
+    /**
+     * @brief 启动 / 停止调度线程
+     *
+     * 停止时仍在排队的 job 按任务顺序逐个调用 cancel（没有 cancel 的调用 submit），
+     * 不持有调度器的锁，因此回调中可以调用 complete()。未启动时也会清空队列（析构时同样如此）。
+     */
+    void start();
+    void stop();
+
+    /**
+     * @brief 加入一个 job
+     */
+    void enqueue(CropJob job);
+
+    /**
+     * @brief 完成 crops 个在途 crop，释放在途额度
+     */
+    void complete(size_t crops = 1);
+
+    /**
+     * @brief 选出并提交一个 run
+     * @return 提交的 job 数（没有排队 job 或在途额度已满时为 0）
+     */
+    size_t dispatchOnce();
+
+    CropSchedulerStats getStats() const;
+
+    /**
+     * @brief 引擎标识：tier * 1000 + ratio（tier 0 时即 ratio）
+     */
+    static int engineKey(int tier, int ratio) { return tier * 1000 + ratio; }
+
+private:
+    struct TaskQueue {
+        size_t queued = 0;                         // 排队中的 crop 数
+        std::shared_ptr<const std::atomic<int>> remaining;  // 最近入队 job 的 remaining
+        std::map<int, std::deque<CropJob>> byEngine; // 各引擎的 job，按 length 降序
+
+        // 优先级：剩余 crop 数（越小越先）
+        size_t priority() const {
+            return remaining ? static_cast<size_t>(std::max(remaining->load(std::memory_order_relaxed), 0)) : queued;
+        }
+    };
+
+    bool hasBudget(const CropJob& job, size_t inFlight) const;
+    void takeFrom(TaskQueue& task, int engine, std::deque<CropJob>& run, size_t& inFlight);
+    void dispatchLoop();
+
+    CropSchedulerConfig config_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<int64_t, TaskQueue> tasks_;
+    size_t queued_ = 0;
+    size_t inFlight_ = 0;
+    std::map<int, size_t> queueDepth_;
+    uint64_t submitted_ = 0;
+    uint64_t runs_ = 0;
+    uint64_t engineSwitches_ = 0;
+    int lastEngine_ = -1;
+
+    bool running_ = false;
+    std::thread thread_;
+};
+
+} // namespace ocr
@@ -4,10 +4,14 @@
 #include "classification/text_classifier.h"
 #include "recognition/text_recognizer.h"
 #include "pipeline/document_preprocessing.h"
+#include "pipeline/crop_scheduler.h"
+#include "preprocessing/text_crop.h"
+#include "preprocessing/blank_page.h"
 #include "common/types.hpp"
 #include "common/visualizer.h"
 #include "common/concurrent_queue.hpp"
 #include "common/thread_pool.hpp"
+#include "common/frame.hpp"
 #include <opencv2/opencv.hpp>
 #include <vector>
 #include <string>
@@ -16,6 +20,8 @@
 #include <atomic>
 #include <unordered_map>
 #include <mutex>
+#include <optional>
+#include <chrono>
 
 namespace ocr {
 
@@ -24,6 +30,7 @@ namespace ocr {
 using DeepXOCR::TextRecognizer;
 using DeepXOCR::RecognizerConfig;
 using DeepXOCR::TextBox;
+using DeepXOCR::PackedCrop;
 
 /**
  * @brief OCR Pipeline配置
@@ -39,10 +46,42 @@ struct OCRPipelineConfig {
     // Classification配置
     ClassifierConfig classifierConfig;
     bool useClassification = true;    // 是否使用文本方向分类
+    bool speculativeRecognition = false;  // 分类的同时识别未旋转的 crop，分类为 "0" 时直接采用（"180" 时重新识别）
     
     // Recognition配置
     RecognizerConfig recognizerConfig;
     
+    // Fast 档位：与上面的默认模型同时常驻的 mobile 检测 / 识别模型，
+    // 由 OCRTaskConfig::modelTier 按任务选择（两个档位需使用同一字典）
+    bool loadFastTier = false;
+    DetectorConfig fastDetectorConfig = DetectorConfig::Mobile();
+    RecognizerConfig fastRecognizerConfig = RecognizerConfig::Mobile();
+    
+    // Recognition cascade：先用 fastRecognizerConfig（mobile）识别所有 crop，
+    // 置信度低于 cascadeThreshold 的再交给 recognizerConfig（server）重新识别
+    bool useRecognitionCascade = false;
+    float cascadeThreshold = 0.9f;
+    
+    // Crop调度配置（按 ratio 引擎分组提交，剩余 crop 少的页面优先）
+    // 启用后识别 job 经过调度线程提交，同时在途的 crop 受 cropSchedulerConfig.maxInFlight 限制；
+    // 关闭时（默认）crop 裁剪后直接提交到识别器
+    CropSchedulerConfig cropSchedulerConfig;
+    bool useCropScheduler = false;    // 是否使用集中 crop 调度器
+    
+    // Mosaic 检测：把长边不超过 mosaicMaxSide 的小图（缩略图、证件、预裁剪的字段）按原尺寸
+    // 拼到一张检测画布（最小的检测模型尺寸）上做一次推理，再按画布区域把检测框分回各任务。
+    // 小图不再被放大到模型尺寸检测，文字过小的图片可能漏检。
+    bool useMosaic = false;
+    int mosaicMaxSide = 320;          // 参与拼图的图像长边上限
+    int mosaicMargin = 16;            // 图像之间的隔离带（像素）
+    int mosaicMaxImages = 8;          // 每张画布最多的图像数
+    int mosaicWaitMs = 2;             // 攒图时等待下一个任务的时间
+    
+    // 空白页快速路径：检测线程在文档预处理之前用缩略图判断空白页（分隔页、背面），
+    // 命中时直接输出空结果（success=true），跳过文档预处理、检测和识别
+    bool skipBlankPages = false;
+    BlankPageConfig blankPageConfig;
+    
     // Pipeline配置
     bool enableVisualization = true;  // 是否生成可视化结果
     bool sortResults = true;          // 是否对结果排序（从上到下，从左到右）
@@ -50,6 +89,23 @@ struct OCRPipelineConfig {
     void Show() const;
 };
 
+/**
+ * @brief 任务请求的模型档位
+ */
+enum class ModelTier : uint8_t {
+    Default = 0,   // Pipeline 默认行为（recognition cascade 开启时先 mobile 后 server）
+    Fast = 1,      // mobile 检测 + mobile 识别（未加载 fast 档位时回退到默认模型）
+    Accurate = 2,  // 默认（server）检测 + 识别，不经过 cascade
+};
+
+/**
+ * @brief 检测前尺寸限制的类型（PP-OCR det_limit_type）
+ */
+enum class DetLimitType : uint8_t {
+    Min = 0,  // 短边小于限制值时放大到限制值
+    Max = 1,  // 长边大于限制值时缩小到限制值
+};
+
 /**
  * @brief OCR任务级别配置（per-request参数）
  * 
@@ -64,6 +120,16 @@ struct OCRTaskConfig {
     // 文本行方向分类
     bool useTextlineOrientation = false;     // 文本行方向分类（0°/180°）
     
+    // 检测前尺寸限制（在检测线程中、检测前处理之前缩放，检测框仍映射回原图坐标；
+    // 只检测 rois 子图时按每个区域的尺寸分别计算）
+    int textDetLimitSideLen = 0;             // 边长限制（0 表示不限制）
+    DetLimitType textDetLimitType = DetLimitType::Min;
+    
+    // 感兴趣区域（表单等已知版面）：只检测这些区域的子图，区域外的文本框不识别。
+    // 坐标基于检测使用的图像（开启文档预处理时为预处理后的图像，服务端不允许两者同时使用），为空表示整页
+    std::vector<cv::Rect2f> rois;
+    bool roisNormalized = false;             // true：x/y/width/height 为页面宽高的比例 [0, 1]
+    
     // 检测参数
     float textDetThresh = 0.3f;              // 检测像素阈值
     float textDetBoxThresh = 0.6f;           // 检测框阈值
@@ -71,11 +137,43 @@ struct OCRTaskConfig {
     
     // 识别参数
     float textRecScoreThresh = 0.0f;         // 识别置信度阈值
+    std::string allowedCharset;              // 允许输出的字符（UTF-8），为空表示不限制（如 "0123456789.-"）
+    
+    // 模型档位
+    ModelTier modelTier = ModelTier::Default;
     
     // 获取默认配置
     static OCRTaskConfig Default() { return {}; }
+    
+    // Min 放大后长边的上限（最大检测模型的输入尺寸，再放大不会带来更多细节）
+    static constexpr int kMaxDetUpscaleSide = 960;
+    
+    /**
+     * @brief 检测前的缩放比例（PP-OCR DetResizeForTest 的 limit_side_len / limit_type）
+     * - Max：长边超过 textDetLimitSideLen 时缩小到该值
+     * - Min：短边小于 textDetLimitSideLen 时放大到该值（长边不超过 kMaxDetUpscaleSide）
+     * @return 1.0 表示不缩放
+     */
+    double detResizeRatio(int height, int width) const;
+    
+    /**
+     * @brief 把 rois 换算为页面像素矩形（裁剪到页面内，去掉裁剪后为空的区域）
+     */
+    std::vector<cv::Rect> roiRects(int height, int width) const;
+};
+
+/**
+ * @brief 产生识别结果的模型档位
+ */
+enum class RecognitionTier : uint8_t {
+    Mobile = 0,  // rec_mobile_ratio_*
+    Server = 1,  // rec_v5_ratio_*
 };
 
+inline const char* recognitionTierName(RecognitionTier tier) {
+    return tier == RecognitionTier::Mobile ? "mobile" : "server";
+}
+
 /**
  * @brief OCR识别结果（单个文本框）
  */
@@ -84,6 +182,7 @@ struct PipelineOCRResult {
     std::string text;               // 识别的文本内容
     float confidence;               // 置信度 [0, 1]
     int index;                      // 排序后的索引（从0开始）
+    RecognitionTier tier = RecognitionTier::Server;  // 产生最终文本的模型档位
     
     // 辅助方法：获取边界矩形
     cv::Rect getBoundingRect() const;
@@ -185,7 +284,7 @@ public:
 
     /**
      * @brief 提交异步任务（使用默认配置）
-     * @param image 输入图片
+     * @param image 输入图片（共享像素缓冲，不拷贝；提交后调用者不得再修改）
      * @param id 任务ID（用于匹配结果）
      * @return true表示提交成功（队列未满），false表示队列已满
      */
@@ -193,23 +292,71 @@ public:
     
     /**
      * @brief 提交异步任务（使用自定义配置）
-     * @param image 输入图片
+     * @param image 输入图片（共享像素缓冲，不拷贝；提交后调用者不得再修改）
      * @param id 任务ID（用于匹配结果）
      * @param config 任务级别配置（per-request参数）
      * @return true表示提交成功（队列未满），false表示队列已满
      */
     bool pushTask(const cv::Mat& image, int64_t id, const OCRTaskConfig& config);
 
+    /**
+     * @brief 提交异步任务（直接传入不可变帧）
+     * @param frame 输入帧
+     * @param id 任务ID（用于匹配结果）
+     * @param config 任务级别配置（per-request参数）
+     * @return true表示提交成功（队列未满），false表示队列已满
+     */
+    bool pushTask(FramePtr frame, int64_t id, const OCRTaskConfig& config);
+    
+    /**
+     * @brief 提交只识别的任务（文本框由调用者给出，如模板化的表单字段）
+     * 
+     * 直接进入识别队列：裁剪 →（可选）方向分类 → 识别，跳过文档预处理和检测。
+     * config 中的检测参数、文档预处理开关和 rois 不起作用；结果与 pushTask 一样由 getResult() 返回。
+     * @param image 输入图片（共享像素缓冲，不拷贝；提交后调用者不得再修改）
+     * @param boxes 文本框（图像像素坐标的四个顶点，任意顺序；超出图像的部分按边缘像素填充）
+     * @param id 任务ID（用于匹配结果）
+     * @param config 任务级别配置（per-request参数）
+     * @return true表示提交成功（队列未满），false表示队列已满
+     */
+    bool pushRecognitionTask(const cv::Mat& image, std::vector<TextBox> boxes, int64_t id,
+                             const OCRTaskConfig& config = OCRTaskConfig::Default());
+    bool pushRecognitionTask(FramePtr frame, std::vector<TextBox> boxes, int64_t id, const OCRTaskConfig& config);
+
+    /**
+     * @brief 检查 allowedCharset 能否用于识别（需先 initialize()）
+     *
+     * 字符集中没有一个字符在识别字典里时返回 false；这样的任务提交后会以 success=false 结束，
+     * 调用者可以提前拒绝。空字符集（不限制）总是可用。
+     */
+    bool isCharsetSupported(const std::string& charset) const;
+
     /**
      * @brief 获取异步结果
      * @param results 输出OCR结果
      * @param id 输出任务ID
-     * @param processedImage 输出处理后的图像（可选）
+     * @param processedImage 输出处理后的图像（可选，与 pipeline 共享像素缓冲，只读）
      * @param success 输出任务是否成功（可选，nullptr 表示不关心）
      * @return true表示获取成功，false表示队列为空
      */
     bool getResult(std::vector<PipelineOCRResult>& results, int64_t& id, cv::Mat* processedImage = nullptr, bool* success = nullptr);
     
+    /**
+     * @brief 获取 crop 调度器统计（策略、各 ratio 队列深度、在途数等）
+     * @return 未启用调度器时 policy 为 "disabled"
+     */
+    CropSchedulerStats getCropSchedulerStats() const;
+    
+    /**
+     * @brief 获取检测模型分辨率选择统计（策略、640/960 各自的图像数、估计器的决策，两个档位合计）
+     */
+    DetectionResolutionStats getDetectionResolutionStats() const;
+    
+    /**
+     * @brief 获取空白页快速路径跳过的页数
+     */
+    uint64_t getBlankPagesSkipped() const { return blankPagesSkipped_.load(); }
+    
 private:
     /**
      * @brief 对OCR结果排序（从上到下，从左到右）
@@ -226,41 +373,86 @@ private:
     static bool compareOCRResults(const PipelineOCRResult& a, const PipelineOCRResult& b);
 
     // 异步处理相关定义
+    // 任务只能移动不能拷贝：图像以 FramePtr 共享，队列之间不产生深拷贝
     struct DetectionTask {
-        cv::Mat image;
-        int64_t id;
+        FramePtr frame;
+        int64_t id = 0;
         OCRTaskConfig config;  // 任务级别配置
+
+        DetectionTask() = default;
+        DetectionTask(FramePtr f, int64_t taskId, const OCRTaskConfig& cfg)
+            : frame(std::move(f)), id(taskId), config(cfg) {}
+        DetectionTask(DetectionTask&&) = default;
+        DetectionTask& operator=(DetectionTask&&) = default;
+        DetectionTask(const DetectionTask&) = delete;
+        DetectionTask& operator=(const DetectionTask&) = delete;
     };
 
     struct RecognitionTask {
-        cv::Mat image; // 预处理后的图片
+        FramePtr frame; // 预处理后的图片
         std::vector<TextBox> boxes;
-        int64_t id;
+        int64_t id = 0;
         OCRTaskConfig config;  // 任务级别配置
+
+        RecognitionTask() = default;
+        RecognitionTask(FramePtr f, std::vector<TextBox> b, int64_t taskId, const OCRTaskConfig& cfg)
+            : frame(std::move(f)), boxes(std::move(b)), id(taskId), config(cfg) {}
+        RecognitionTask(RecognitionTask&&) = default;
+        RecognitionTask& operator=(RecognitionTask&&) = default;
+        RecognitionTask(const RecognitionTask&) = delete;
+        RecognitionTask& operator=(const RecognitionTask&) = delete;
     };
 
     struct OutputTask {
         std::vector<PipelineOCRResult> results;
-        cv::Mat processedImage;  // UVDoc 处理后的图像（用于可视化）
-        int64_t id;
+        FramePtr frame;        // UVDoc 处理后的图像（用于可视化）
+        int64_t id = 0;
         OCRTaskConfig config;  // 任务级别配置（用于结果过滤）
         bool success = true;   // 任务是否成功（false 表示检测/识别过程出错）
+
+        OutputTask() = default;
+        OutputTask(std::vector<PipelineOCRResult> r, FramePtr f, int64_t taskId,
+                   const OCRTaskConfig& cfg, bool ok)
+            : results(std::move(r)), frame(std::move(f)), id(taskId), config(cfg), success(ok) {}
+        OutputTask(OutputTask&&) = default;
+        OutputTask& operator=(OutputTask&&) = default;
+        OutputTask(const OutputTask&) = delete;
+        OutputTask& operator=(const OutputTask&) = delete;
+    };
+
+    // Per-crop state of speculative recognition (classification and upright recognition race)
+    struct SpeculativeCropState {
+        enum class Orientation : uint8_t { Pending, Upright, Rotated };
+        Orientation orientation = Orientation::Pending;  // Classification result
+        bool recognized = false;                          // Upright result arrived before classification
+        std::string text;
+        float confidence = 0.0f;
+        RecognitionTier tier = RecognitionTier::Server;
     };
 
     // Context for tracking async recognition of an entire image
     struct RecognitionTaskContext {
         int64_t taskId;
-        cv::Mat processedImage;                            // UVDoc 处理后的图像（用于可视化）
-        std::vector<cv::Mat> crops;                        // Cropped images (keep alive during async)
+        FramePtr frame;                                    // UVDoc 处理后的图像（用于可视化）
+        std::vector<TextCropGeometry> crops;               // Crop geometry (pixels are sampled from frame on submit)
         std::vector<std::vector<cv::Point2f>> boxPoints;  // Box coordinates for each crop
         std::vector<PipelineOCRResult> results;            // Results (one per crop)
         std::atomic<int> pendingCount{0};                  // Number of pending recognitions
         std::mutex resultMutex;                            // Protect results vector
         OCRTaskConfig config;                              // 任务级别配置
+        ocr::CharsetIndexPtr allowedClasses;               // config.allowedCharset 编译后的类别索引（nullptr 表示不限制）
+        std::atomic<int> unsubmittedCount{0};              // 尚未交给识别器的 crop 数（为 0 时提交拼接批次）
+        std::vector<PackedCrop> packedCrops;               // 等待拼接识别的短 crop
+        std::mutex packMutex;                              // Protect packedCrops
+        bool speculative = false;                          // 分类与未旋转识别并行
+        RecognitionTier firstTier = RecognitionTier::Server;  // 首次识别使用的档位（cascade 时为 mobile）
+        bool cascade = false;                              // 低置信度结果升级到 server 档位
+        std::vector<SpeculativeCropState> speculation;     // speculative 时每个 crop 一项（由 resultMutex 保护）
         
         RecognitionTaskContext(int64_t id, size_t cropCount, const OCRTaskConfig& cfg = OCRTaskConfig::Default())
             : taskId(id), crops(cropCount), boxPoints(cropCount), results(cropCount), config(cfg) {
             pendingCount.store(static_cast<int>(cropCount));
+            unsubmittedCount.store(static_cast<int>(cropCount));
         }
     };
 
@@ -268,17 +460,44 @@ private:
     struct RecognitionCropContext {
         std::shared_ptr<RecognitionTaskContext> taskCtx;
         size_t cropIndex;
+        bool speculative = false;  // Upright recognition submitted before classification finished
+        bool rotate180 = false;    // Orientation the crop was recognized in
+        RecognitionTier tier = RecognitionTier::Server;  // Model tier the crop was submitted to
     };
     
     // Context for a single crop's async classification (for pipelined cls->rec)
     struct ClassificationCropContext {
         std::shared_ptr<RecognitionTaskContext> taskCtx;
         size_t cropIndex;
-        // Note: crop data is accessed via taskCtx->crops[cropIndex], no need to store separately
+        // Note: crop geometry is accessed via taskCtx->crops[cropIndex], no need to store separately
+    };
+
+    // 已完成文档预处理、等待提交检测的任务
+    struct PreparedDetection {
+        DetectionTask task;
+        FramePtr frame;  // 文档预处理后的图像
+        std::chrono::high_resolution_clock::time_point start;  // 检测阶段开始时间（含文档预处理）
     };
 
     void detectionLoop();
     void recognitionLoop();
+    
+    // Register the task config and run document preprocessing (false: empty frame, task skipped)
+    bool prepareDetection(DetectionTask task, PreparedDetection& prepared);
+    // Small BGR image that may share a mosaic canvas
+    bool mosaicEligible(const PreparedDetection& prepared) const;
+    // Submit one task to its detector (tiled, cached or single inference)
+    void submitDetection(PreparedDetection& prepared);
+    // Submit tasks with identical detection parameters as one mosaic canvas
+    void submitMosaic(std::vector<PreparedDetection>& batch, TextDetector* detector);
+    // Report a task whose detection could not be submitted (success=false result)
+    void failDetection(const PreparedDetection& prepared);
+    // Report a task that needs no detection (blank page, no ROI inside the page),
+    // or with success=false one that cannot be recognized (allowedCharset outside the dictionary)
+    void pushEmptyResult(FramePtr frame, int64_t id, const OCRTaskConfig& config, bool success = true);
+    
+    // ROI 合计面积超过页面的这一比例时改为检测整页（一次整页推理比多个区域子图更快）
+    static constexpr double kRoiFullPageCoverage = 0.5;
     void onClassificationComplete(const std::string& label, float confidence, void* userArg);
     void onRecognitionComplete(const std::string& text, float confidence, void* userArg);
     
@@ -286,8 +505,32 @@ private:
      * @brief Submit a single crop for recognition (after classification or directly)
      * @param taskCtx Recognition task context
      * @param cropIndex Index of the crop to submit
+     * @param rotate180 Rotate the crop by 180 degrees (textline classification result)
      */
-    void submitCropForRecognition(std::shared_ptr<RecognitionTaskContext> taskCtx, size_t cropIndex);
+    void submitCropForRecognition(std::shared_ptr<RecognitionTaskContext> taskCtx, size_t cropIndex,
+                                  bool rotate180 = false, bool speculative = false);
+    // Schedule one crop on the given tier (never packed, not counted in unsubmittedCount);
+    // used for rotated re-runs after a speculation miss and for cascade escalation
+    void scheduleCrop(const std::shared_ptr<RecognitionTaskContext>& taskCtx, size_t cropIndex,
+                      bool rotate180, bool speculative, RecognitionTier tier);
+    // Accept a crop's recognition result, or escalate it to the server tier when the
+    // cascade is on and the mobile confidence is below cascadeThreshold
+    void deliverCrop(const std::shared_ptr<RecognitionTaskContext>& taskCtx, size_t cropIndex,
+                     std::string text, float confidence, RecognitionTier tier, bool rotate180);
+    // Record a crop's final result; finalizes the task after its last crop
+    void completeCrop(const std::shared_ptr<RecognitionTaskContext>& taskCtx, size_t cropIndex,
+                      std::string text, float confidence, RecognitionTier tier);
+    // Recognizer serving a tier (the main recognizer when no separate fast tier is loaded)
+    TextRecognizer* recognizerFor(RecognitionTier tier) const;
+    // Detector serving the task's model tier
+    TextDetector* detectorFor(ModelTier tier) const;
+    
+    // Submit the task's buffered short crops as packed recognition inputs
+    void flushPackedCrops(const std::shared_ptr<RecognitionTaskContext>& taskCtx);
+    // Mark one crop as handed to the recognizer (or dropped); flushes packed crops after the last one
+    void markCropSubmitted(const std::shared_ptr<RecognitionTaskContext>& taskCtx);
+    // Hand a recognition job to the crop scheduler (or submit it directly when disabled)
+    void scheduleRecognition(CropJob job);
     
     /**
      * @brief 完成识别任务的最终处理（排序、过滤、推送结果）
@@ -295,6 +538,11 @@ private:
      */
     void finalizeRecognitionTask(std::shared_ptr<RecognitionTaskContext> taskCtx);
 
+    /**
+     * @brief 输出任务的帧拷贝统计（调试用，报告该任务剩余的深拷贝）
+     */
+    static void logFrameCopies(const FramePtr& frame, int64_t taskId);
+
     std::unique_ptr<ConcurrentQueue<DetectionTask>> detQueue_;
     std::unique_ptr<ConcurrentQueue<RecognitionTask>> recQueue_;
     std::unique_ptr<ConcurrentQueue<OutputTask>> outQueue_;
@@ -310,6 +558,23 @@ private:
     // Similar to Python's ThreadPoolExecutor + _dispatch_stage pattern
     std::unique_ptr<ThreadPool> stageExecutor_;
     
+    // Central crop scheduler between cropping and recognition submission
+    // (declared before recognizer_ so it outlives recognition callbacks)
+    std::unique_ptr<CropScheduler> cropScheduler_;
+    
+    // Speculative recognition outcome counters (upright result kept / rotated re-run)
+    std::atomic<uint64_t> speculativeHits_{0};
+    std::atomic<uint64_t> speculativeMisses_{0};
+    
+    // Recognition cascade outcome counters (mobile result kept / escalated to server)
+    std::atomic<uint64_t> cascadeAccepted_{0};
+    std::atomic<uint64_t> cascadeEscalated_{0};
+    
+    // Mosaic detection counters (images detected on shared canvases / canvases submitted)
+    std::atomic<uint64_t> mosaicImages_{0};
+    std::atomic<uint64_t> mosaicCanvases_{0};
+    std::atomic<uint64_t> blankPagesSkipped_{0};
+    
     // Pending task configs map (for passing config from detection to recognition)
     std::unordered_map<int64_t, OCRTaskConfig> pendingTaskConfigs_;
     std::mutex pendingTaskConfigsMutex_;
@@ -320,6 +585,8 @@ private:
     std::unique_ptr<DocumentPreprocessingPipeline> docPreprocessing_;
     std::unique_ptr<TextClassifier> classifier_;
     std::unique_ptr<TextRecognizer> recognizer_;
+    std::unique_ptr<TextDetector> fastDetector_;      // Fast (mobile) tier detector (optional)
+    std::unique_ptr<TextRecognizer> fastRecognizer_;  // Fast (mobile) tier recognizer, also the cascade's first pass (optional)
     bool initialized_ = false;
     
     // Cache the last processed image for visualization
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+
+namespace ocr {
+
+/**
+ * @brief 空白页判定阈值（在缩略图上计算，默认值偏保守：宁可漏判空白页，不丢页码之类的少量文字）
+ */
+struct BlankPageConfig {
+    int thumbSide = 1024;           // 缩略图长边上限（INTER_AREA 缩小，小于一个缩略图像素的灰尘被平均掉）
+    float borderRatio = 0.03f;      // 忽略四周的边框（扫描阴影、装订孔），按缩略图边长的比例
+    float maxStdDev = 10.0f;        // 灰度标准差上限（纸张纹理、扫描噪声、轻微的光照不均）
+    int inkDelta = 48;              // 与背景（灰度均值）相差超过此值的像素计为墨迹
+    float maxInkRatio = 0.00002f;   // 墨迹像素占比上限（1024 缩略图上约 15 个像素）
+    int edgeDelta = 40;             // 相邻像素灰度差超过此值计为边缘
+    float maxEdgeRatio = 0.00005f;  // 边缘像素占比上限（水平 + 垂直方向）
+};
+
+/**
+ * @brief 空白页判定结果
+ */
+struct BlankPageCheck {
+    bool blank = false;     // 三项指标都不超过阈值
+    float stdDev = 0.0f;    // 灰度标准差
+    float inkRatio = 0.0f;  // 墨迹像素占比
+    float edgeRatio = 0.0f; // 边缘像素占比
+};
+
+/**
+ * @brief 判断页面是否为空白页（CPU，约 2~5ms，均为 OpenCV 向量化操作）
+ *
+ * 灰度缩略图去掉边框后依次检查：标准差（有文字的页面大多在这一步返回）、
+ * 与背景相差较大的墨迹像素占比、相邻像素的边缘占比。背景取均值，兼容深色底浅色字的页面。
+ *
+ * @param image 输入图像（BGR、BGRA 或灰度）
+ * @param config 判定阈值
+ */
+BlankPageCheck checkBlankPage(const cv::Mat& image, const BlankPageConfig& config = BlankPageConfig());
+
+} // namespace ocr
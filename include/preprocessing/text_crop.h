@@ -0,0 +1,66 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+namespace ocr {
+
+/**
+ * @brief 文本框裁剪几何（由四点框一次算出，供融合采样使用）
+ *
+ * 与 Geometry::cropTextRegion 的中间裁剪图一致：透视矫正后的尺寸为 width x height，
+ * 竖排文本（height > width * 2）再逆时针旋转 90 度。
+ */
+struct TextCropGeometry {
+    std::vector<cv::Point2f> ordered;  // 左上、右上、右下、左下
+    int width = 0;                     // 矫正后裁剪图宽度（旋转前）
+    int height = 0;                    // 矫正后裁剪图高度（旋转前）
+    bool vertical = false;             // 竖排文本，需要逆时针旋转 90 度
+    bool axisAligned = false;          // 框与坐标轴平行，可直接 ROI + resize
+    cv::Matx33d cropToImage;           // 裁剪图坐标 -> 原图坐标（透视矩阵）
+
+    // 旋转后（即送入 cls/rec 前）的裁剪图尺寸
+    int outWidth() const { return vertical ? height : width; }
+    int outHeight() const { return vertical ? width : height; }
+};
+
+/**
+ * @brief 计算文本框的裁剪几何
+ * @param box 四个顶点（任意顺序）
+ * @param geom 输出几何
+ * @return 框退化（顶点数不为 4 或尺寸为 0）时返回 false
+ */
+bool computeTextCropGeometry(const std::vector<cv::Point2f>& box, TextCropGeometry& geom);
+
+/**
+ * @brief 把文本框区域直接采样成 dst 大小（拉伸，不保持宽高比）
+ *
+ * 透视矫正、竖排旋转、可选的 180 度翻转和 resize 合成为一个单应矩阵，
+ * 只对 dst 的每个像素做一次双线性采样，不生成中间裁剪图。
+ * 用于分类模型输入（80x160）。
+ *
+ * @param image 原图
+ * @param geom 裁剪几何
+ * @param rotate180 是否再旋转 180 度（分类结果为 "180"）
+ * @param dst 输出，必须已分配为目标尺寸（可为池缓冲），类型与 image 相同
+ */
+void renderTextCrop(const cv::Mat& image, const TextCropGeometry& geom, bool rotate180, cv::Mat& dst);
+
+/**
+ * @brief 把文本框区域直接采样成识别模型输入（PPOCR pad + resize 语义）
+ *
+ * 等价于 cropTextRegion -> 右侧补 114 灰边到 target 宽高比 -> resize 到 targetWidth x targetHeight，
+ * 但只遍历一次输出像素：内容区一次透视采样，补边区直接填充。
+ * 轴对齐且无需旋转的框走 ROI + resize 快速路径。
+ *
+ * @param image 原图
+ * @param geom 裁剪几何
+ * @param rotate180 是否再旋转 180 度
+ * @param targetWidth 模型输入宽度（如 ratio_10 为 480）
+ * @param targetHeight 模型输入高度（48）
+ * @param dst 输出；已是目标尺寸时直接写入（如池缓冲），否则重新分配
+ */
+void renderRecognitionInput(const cv::Mat& image, const TextCropGeometry& geom, bool rotate180,
+                            int targetWidth, int targetHeight, cv::Mat& dst);
+
+} // namespace ocr
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ocr {
+namespace ctc_kernels {
+
+/**
+ * @brief 单个时间步的 argmax（AVX-512 / AVX2 / NEON / 标量实现，运行时选择）
+ *
+ * 与标量循环 `if (row[c] > max) ...` 结果一致：多个最大值时返回最小的索引。
+ * 输入为 softmax 概率，不处理 NaN。
+ *
+ * @param row 一个时间步的类别分数 [num_classes]
+ * @param n 类别数 (>= 1)
+ * @param maxValue 输出最大值
+ * @return 最大值所在索引
+ */
+int argmax(const float* row, int n, float& maxValue);
+
+/**
+ * @brief 只在给定类别子集上取 argmax（字符集约束解码）
+ *
+ * 子集通常只有十几个类别，直接按索引读取比扫描全部类别便宜得多。
+ *
+ * @param row 一个时间步的类别分数 [num_classes]
+ * @param classes 候选类别索引（升序，结果在并列时取最小索引）
+ * @param count 候选个数 (>= 1)
+ * @param maxValue 输出最大值
+ * @return 最大值所在的类别索引（row 中的索引）
+ */
+int argmaxIndexed(const float* row, const int* classes, int count, float& maxValue);
+
+/**
+ * @brief 标量参考实现（用于测试和基准对比）
+ */
+int argmaxScalar(const float* row, int n, float& maxValue);
+
+/**
+ * @brief 当前 CPU 上 argmax 使用的指令集名称（用于日志）
+ */
+const char* argmaxIsaName();
+
+} // namespace ctc_kernels
+} // namespace ocr
@@ -1,12 +1,22 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <dxrt/dxrt_api.h>
 
 namespace ocr {
 
+/**
+ * @brief 允许输出的类别索引（升序，包含 blank），由 CTCDecoder::compileCharset 生成
+ */
+using CharsetIndex = std::vector<int>;
+using CharsetIndexPtr = std::shared_ptr<const CharsetIndex>;
+
 /**
  * @brief CTC解码器 - 用于文本识别后处理
  * 
@@ -14,6 +24,9 @@ namespace ocr {
  * 1. CTC解码 (去重复 + 去blank)
  * 2. 字符索引转文本
  * 3. 置信度计算
+ * 
+ * 字典以连续的 UTF-8 字节表 + 偏移数组存放；每个时间步的 argmax 使用 SIMD 内核，
+ * 解码过程（decodeInto）不分配内存，可在推理回调线程上直接运行。
  */
 class CTCDecoder {
 public:
@@ -23,19 +36,95 @@ public:
      * @param use_space_char 是否使用空格字符
      */
     explicit CTCDecoder(const std::string& dict_path, bool use_space_char = true);
+    
+    /**
+     * @brief 直接用字符表构造（不含 blank，测试和基准使用）
+     * @param characters 字符列表（UTF-8），索引 i 对应类别 i+1
+     * @param use_space_char 是否在末尾追加空格字符
+     */
+    CTCDecoder(const std::vector<std::string>& characters, bool use_space_char);
     ~CTCDecoder() = default;
     
     /**
      * @brief 解码CTC输出
      * @param preds 模型输出 [time_steps, num_classes]
+     * @param allowed 允许输出的类别（nullptr 表示不限制）
      * @return pair<文本, 置信度>
      */
-    std::pair<std::string, float> decode(const dxrt::TensorPtr& output);
+    std::pair<std::string, float> decode(const dxrt::TensorPtr& output,
+                                         const CharsetIndex* allowed = nullptr);
+    
+    /**
+     * @brief 按输入列范围分段解码（多个 crop 拼接成一个宽输入时使用）
+     *
+     * 列范围 [x0, x1) 按 time_steps / input_width 映射到时间步区间，各段独立做贪心解码。
+     *
+     * @param output 模型输出 [1, time_steps, num_classes]
+     * @param input_width 模型输入宽度（像素）
+     * @param columns 每段在输入中的列范围 [x0, x1)
+     * @param allowed 允许输出的类别（nullptr 表示不限制）
+     * @return 每段的 pair<文本, 置信度>，顺序与 columns 相同
+     */
+    std::vector<std::pair<std::string, float>> decodeColumns(
+        const dxrt::TensorPtr& output, int input_width,
+        const std::vector<std::pair<int, int>>& columns,
+        const CharsetIndex* allowed = nullptr);
+    
+    /**
+     * @brief 按输入列范围分段解码（logits 版本，不经过张量）
+     *
+     * x0 向下、x1 向上取整到时间步；超出 [0, input_width) 的部分被截掉，空范围输出空串和 0 置信度。
+     *
+     * @param logits 模型输出 [time_steps, num_classes]，num_classes 必须等于字典大小
+     * @param time_steps 时间步数
+     */
+    std::vector<std::pair<std::string, float>> decodeColumns(
+        const float* logits, int time_steps, int input_width,
+        const std::vector<std::pair<int, int>>& columns,
+        const CharsetIndex* allowed = nullptr) const;
+    
+    /**
+     * @brief 解码到调用者提供的缓冲（贪心 CTC，不分配内存）
+     * @param logits 模型输出 [time_steps, num_classes]，num_classes 必须等于字典大小
+     * @param time_steps 时间步数
+     * @param text 输出 UTF-8 缓冲（不以 '\0' 结尾）
+     * @param capacity 缓冲容量（字节）；放不下的字符被丢弃，不计入置信度
+     * @param length 输出文本长度（字节）
+     * @param allowed 允许输出的类别（nullptr 表示不限制）；argmax 只在这些类别上进行
+     * @return 平均置信度（没有字符时为 0）
+     */
+    float decodeInto(const float* logits, int time_steps,
+                     char* text, size_t capacity, size_t& length,
+                     const CharsetIndex* allowed = nullptr) const;
+    
+    /**
+     * @brief 把字符集（如 "0123456789.,"）编译为类别索引列表
+     * @param charset UTF-8 字符集，字典中不存在的字符被忽略
+     * @param compiled 输出升序类别索引（含 blank）；charset 为空时为 nullptr（不限制）
+     * @return false 表示 charset 非空但没有一个字符在字典中（此时 compiled 为 nullptr）
+     * @note 结果按字符串缓存，同一字符集在多个任务间共享
+     */
+    bool compileCharset(const std::string& charset, CharsetIndexPtr& compiled) const;
+    
+    /**
+     * @brief 容纳 time_steps 个时间步解码结果所需的最大字节数
+     */
+    size_t maxTextBytes(int time_steps) const {
+        return static_cast<size_t>(time_steps) * max_char_bytes_;
+    }
     
     /**
      * @brief 获取字典大小
      */
-    size_t getDictSize() const { return character_dict_.size(); }
+    size_t getDictSize() const { return dict_offsets_.empty() ? 0 : dict_offsets_.size() - 1; }
+    
+    /**
+     * @brief 第 index 个类别对应的字符（UTF-8）
+     */
+    std::string_view getChar(int index) const {
+        return std::string_view(dict_chars_.data() + dict_offsets_[index],
+                                dict_offsets_[index + 1] - dict_offsets_[index]);
+    }
     
     /**
      * @brief 加载字典文件
@@ -45,18 +134,30 @@ public:
 
 private:
     /**
-     * @brief CTC解码核心算法
-     * @param indices 预测的字符索引序列
-     * @param probs 对应的概率值
-     * @return pair<文本, 置信度>
+     * @brief 检查输出形状并返回数据指针（形状不符时返回 nullptr）
+     */
+    const float* checkOutput(const dxrt::TensorPtr& output, int& time_steps) const;
+    
+    /**
+     * @brief 解码 [t_begin, t_end) 并构造结果字符串
      */
-    std::pair<std::string, float> decodeSequence(
-        const std::vector<int>& indices,
-        const std::vector<float>& probs);
+    std::pair<std::string, float> decodeSpan(const float* logits, int t_begin, int t_end,
+                                             const CharsetIndex* allowed) const;
+    
+    /**
+     * @brief 构建连续字典表（index 0 为 blank）
+     */
+    void buildTable(const std::vector<std::string>& characters, bool use_space_char);
+    
+    std::string dict_chars_;              // 全部字符连续存放 (UTF-8)
+    std::vector<uint32_t> dict_offsets_;  // 第 i 个字符为 [offsets[i], offsets[i+1])
+    size_t max_char_bytes_ = 0;           // 单个字符的最大字节数
+    std::unordered_map<std::string_view, int> char_index_;  // 字符 -> 类别索引（指向 dict_chars_）
     
-    std::vector<std::string> character_dict_;  // 字符字典
-    bool use_space_char_;                      // 是否使用空格
-    int blank_index_;                          // blank字符的索引（通常是0）
+    mutable std::mutex charset_mutex_;    // 保护 charset_cache_
+    mutable std::unordered_map<std::string, CharsetIndexPtr> charset_cache_;
+    bool use_space_char_;                 // 是否使用空格
+    int blank_index_;                     // blank字符的索引（通常是0）
 };
 
 } // namespace ocr
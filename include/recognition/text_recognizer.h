@@ -8,6 +8,9 @@
 
 #include "common/logger.hpp"
 #include "common/types.hpp"
+#include "common/buffer_pool.hpp"
+#include "common/lru_cache.hpp"
+#include "preprocessing/text_crop.h"
 #include "recognition/rec_postprocess.h"  // 包含完整定义
 
 namespace DeepXOCR {
@@ -39,14 +42,70 @@ struct RecognizerConfig {
     // Input height (fixed at 48)
     int inputHeight = 48;
     
+    // Multi-crop packing: short crops (ratio <= packMaxRatio) are laid side by side,
+    // separated by blank columns, in one wide ratio_25/ratio_35 input; the CTC output
+    // is split back per crop by column range. Cuts NPU jobs on label/form-heavy pages.
+    // Each crop is rendered with the same PPOCR pad path as an unpacked crop (its content
+    // width may differ by one column from the unpacked input, since the pad is rounded there).
+    bool enablePacking = false;
+    int packMaxRatio = 5;            // Crops routed to ratio_3/ratio_5 are packable
+    int packTargetRatio = 25;        // Packed inputs only go to ratio models >= this (ratio_25/ratio_35)
+    int packSeparatorWidth = 24;     // Blank gap between packed crops (px, ~3 CTC time steps)
+    
+    // Crop-level result cache: the final 48xW input is hashed (XXH64, plus ratio and charset)
+    // and repeated crops (page headers/footers, form labels) are answered without an NPU job.
+    // Packed inputs are not cached. 0 = disabled (the server enables 4096 entries).
+    size_t resultCacheSize = 0;
+    
+    // Mobile model set (rec_mobile_ratio_*), e.g. the fast tier of a recognition cascade
+    static RecognizerConfig Mobile() {
+        RecognizerConfig config;
+        const std::string root = std::string(PROJECT_ROOT_DIR) + "/engine/model_files/mobile";
+        for (auto& [ratio, path] : config.modelPaths) {
+            path = root + "/rec_mobile_ratio_" + std::to_string(ratio) + ".dxnn";
+        }
+        config.useMobileModel = true;
+        return config;
+    }
+    
     void Show() const {
         LOG_INFO("RecognizerConfig:");
         LOG_INFO("  confThreshold={:.2f}", confThreshold);
         LOG_INFO("  dictPath={}", dictPath);
         LOG_INFO("  Models: {} ratios", modelPaths.size());
+        LOG_INFO("  packing={} (maxRatio={}, targetRatio>={}, separator={}px)",
+                 enablePacking, packMaxRatio, packTargetRatio, packSeparatorWidth);
+        LOG_INFO("  resultCacheSize={}", resultCacheSize);
     }
 };
 
+/**
+ * A short text crop to be recognized as part of a packed input
+ */
+struct PackedCrop {
+    const ocr::TextCropGeometry* geom;  // Only needs to stay valid during RecognizePackedAsync
+    bool rotate180;
+    void* userArg;                      // Passed back through the recognition callback
+};
+
+/**
+ * Column range [x0, x1) of one crop inside a packed input
+ */
+struct PackedSegment {
+    int x0;
+    int x1;
+    void* userArg;
+};
+
+/**
+ * One packed input planned by TextRecognizer::PlanPacking: crops [begin, begin + columns.size())
+ * and their column ranges [x0, x1) inside the input
+ */
+struct PackedGroup {
+    size_t begin;
+    std::vector<std::pair<int, int>> columns;
+};
+
 /**
  * Text Recognizer Class
  * Recognizes text content from cropped text images
@@ -68,7 +127,49 @@ public:
         const std::vector<cv::Mat>& textImages);
     
     // Asynchronous recognition
-    int RecognizeAsync(const cv::Mat& textImage, void* userArg = nullptr);
+    // allowed: optional charset constraint from CompileCharset (nullptr = full dictionary)
+    int RecognizeAsync(const cv::Mat& textImage, void* userArg = nullptr,
+                       ocr::CharsetIndexPtr allowed = nullptr);
+    
+    // Asynchronous recognition of a text box sampled straight from the full image
+    // (perspective crop + vertical rotation + optional 180 flip + pad/resize in one pass,
+    // written into a pooled 48xW input buffer; no intermediate crop)
+    int RecognizeRegionAsync(const cv::Mat& image, const ocr::TextCropGeometry& geom,
+                             bool rotate180, void* userArg = nullptr,
+                             ocr::CharsetIndexPtr allowed = nullptr);
+    
+    // Ratio model a crop is routed to (decided by the crop after vertical rotation)
+    int RatioOf(const ocr::TextCropGeometry& geom) const {
+        return CalculateRatio(geom.outWidth(), geom.outHeight());
+    }
+    
+    // Widest loaded ratio model (packed inputs mostly land here)
+    int MaxRatio() const { return models_.empty() ? 0 : models_.rbegin()->first; }
+    
+    // Width of a crop rendered at inputHeight with its aspect ratio kept
+    int ScaledWidth(const ocr::TextCropGeometry& geom) const;
+    
+    // Whether a crop is short enough to be packed with others (packing enabled and
+    // a wider model is available to pack into)
+    bool IsPackable(const ocr::TextCropGeometry& geom) const;
+    
+    // Pack short crops side by side into as few wide inputs as possible and submit them.
+    // The callback fires once per crop with that crop's userArg, exactly as with
+    // RecognizeRegionAsync. Returns the number of inference jobs submitted.
+    int RecognizePackedAsync(const cv::Mat& image, const std::vector<PackedCrop>& crops,
+                             ocr::CharsetIndexPtr allowed = nullptr);
+    
+    // Greedy left-to-right packing of crops (widths at inputHeight, in order) into inputs of
+    // capacity columns. Each crop starts on a multiple of alignment with at least separator blank
+    // columns before it; a crop that does not fit starts a new group. A group holding a single
+    // crop is submitted as a regular unpacked input.
+    static std::vector<PackedGroup> PlanPacking(const std::vector<int>& widths, int capacity,
+                                                int separator, int alignment);
+    
+    // Compile an allowed character set (e.g. "0123456789-") into dictionary class indices.
+    // compiled is nullptr for an empty charset; results are cached by the decoder.
+    // Returns false when the charset is non-empty but none of its characters is in the dictionary.
+    bool CompileCharset(const std::string& charset, ocr::CharsetIndexPtr& compiled) const;
     
     // Wait for async result
     std::pair<std::string, float> Wait(int jobId);
@@ -80,6 +181,14 @@ public:
     // Print model usage statistics
     void PrintModelUsageStats() const;
     
+    // Crop-level result cache (raw decoder output, before the confidence threshold)
+    struct CachedRecognition {
+        std::string text;
+        float confidence = 0.0f;
+    };
+    using CacheStats = ocr::StripedLruCache<CachedRecognition>::Stats;
+    CacheStats GetCacheStats() const;
+    
     // Get last batch recognition timing details
     void getLastTimings(double& preprocess, double& inference, double& postprocess) const {
         preprocess = last_preprocess_time_;
@@ -101,6 +210,9 @@ private:
     // ratio_3, ratio_5, ratio_10, ratio_15, ratio_25, ratio_35
     std::map<int, std::unique_ptr<dxrt::InferenceEngine>> models_;
     
+    // Pooled 48xW input buffers, one pool per ratio model (async path)
+    std::map<int, std::shared_ptr<ocr::BufferPool>> inputPools_;
+    
     // User callback for async mode
     std::function<void(const std::string&, float, void*)> userCallback_;
     
@@ -110,6 +222,9 @@ private:
     // CTC Decoder
     std::unique_ptr<ocr::CTCDecoder> decoder_;
     
+    // Crop-level result cache (nullptr when disabled)
+    std::unique_ptr<ocr::StripedLruCache<CachedRecognition>> resultCache_;
+    
     // Model usage statistics
     mutable std::map<int, int> model_usage_;
     
@@ -120,13 +235,39 @@ private:
     
     // Select appropriate model based on image aspect ratio
     dxrt::InferenceEngine* SelectModel(const cv::Mat& image);
-    int CalculateRatio(int width, int height);
+    dxrt::InferenceEngine* SelectModel(int width, int height);
+    int CalculateRatio(int width, int height) const;
     
     // Preprocessing
+    int InputWidth(int ratio) const;
     cv::Mat Preprocess(const cv::Mat& image, int ratio);
+    // Preprocess into dst (reused when it already has the 48xW shape, e.g. a pooled buffer)
+    void PreprocessInto(const cv::Mat& image, int ratio, cv::Mat& dst);
+    ocr::BufferLease AcquireInput(int ratio, int type);
+    
+    // Submit a preprocessed input; the context owns the buffer until the callback
+    void SubmitAsync(dxrt::InferenceEngine* engine, ocr::BufferLease input, void* userArg,
+                     ocr::CharsetIndexPtr allowed = nullptr,
+                     std::vector<PackedSegment> segments = {});
+    
+    // Cache key of a rendered input (pixels + ratio + charset constraint)
+    uint64_t CacheKey(const cv::Mat& input, int ratio, const ocr::CharsetIndex* allowed) const;
+    // Answer from the result cache; false on a miss (or when the cache is disabled)
+    bool ServeFromCache(uint64_t key, void* userArg);
+    // Submit a single-crop input, or answer it from the result cache
+    void SubmitOrServe(dxrt::InferenceEngine* engine, int ratio, ocr::BufferLease input, void* userArg,
+                       ocr::CharsetIndexPtr allowed);
+    
+    // Smallest model ratio >= packTargetRatio (and above packMaxRatio) whose input is at least
+    // minWidth wide (-1 if none)
+    int PackRatio(int minWidth) const;
+    // Render one planned group of crops into a packed input and submit it
+    void SubmitPacked(const cv::Mat& image, const PackedCrop* crops, const PackedGroup& group,
+                      const ocr::CharsetIndexPtr& allowed);
     
-    // Postprocessing (CTC decoding)
-    std::pair<std::string, float> Postprocess(dxrt::TensorPtrs& outputs);
+    // Postprocessing (CTC decoding, optionally restricted to an allowed charset)
+    std::pair<std::string, float> Postprocess(dxrt::TensorPtrs& outputs,
+                                              const ocr::CharsetIndex* allowed = nullptr);
 };
 
 } // namespace DeepXOCR
@@ -60,6 +60,9 @@ json JsonResponseBuilder::ConvertOCRResultToJson(
     // 置信度
     item["score"] = std::round(result.confidence * 1000.0) / 1000.0;  // 保留3位小数
     
+    // 产生该结果的识别模型档位（mobile / server）
+    item["recTier"] = ocr::recognitionTierName(result.tier);
+    
     // 文本框坐标点（四个顶点）
     json points = json::array();
     for (const auto& pt : result.box) {
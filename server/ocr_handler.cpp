@@ -1,6 +1,7 @@
 #include "ocr_handler.h"
 #include "common/logger.hpp"
 #include "common/visualizer.h"
+#include <cmath>
 #include <regex>
 
 namespace ocr_server {
@@ -26,6 +27,11 @@ OCRRequest OCRRequest::FromJson(const json& j) {
     if (j.contains("textDetBoxThresh")) req.textDetBoxThresh = j["textDetBoxThresh"].get<double>();
     if (j.contains("textDetUnclipRatio")) req.textDetUnclipRatio = j["textDetUnclipRatio"].get<double>();
     if (j.contains("textRecScoreThresh")) req.textRecScoreThresh = j["textRecScoreThresh"].get<double>();
+    if (j.contains("allowedCharset")) req.allowedCharset = j["allowedCharset"].get<std::string>();
+    if (j.contains("modelTier")) req.modelTier = j["modelTier"].get<std::string>();
+    if (j.contains("rois")) req.rois = j["rois"].get<std::vector<std::array<double, 4>>>();
+    if (j.contains("roiNormalized")) req.roiNormalized = j["roiNormalized"].get<bool>();
+    if (j.contains("boxes")) req.boxes = j["boxes"].get<std::vector<std::array<std::array<double, 2>, 4>>>();
     if (j.contains("visualize")) req.visualize = j["visualize"].get<bool>();
     
     // PDF 专用参数
@@ -90,13 +96,12 @@ bool OCRRequest::Validate(std::string& error_msg) const {
         }
     }
     
-    // textDetLimitSideLen 和 textDetLimitType: 接收但不实际使用，只做基本验证
-    // 不会因为这两个参数的值而拒绝请求
-    if (textDetLimitSideLen < 1) {
-        LOG_WARN("textDetLimitSideLen={} is too small, will use default model selection", textDetLimitSideLen);
+    // textDetLimitSideLen 和 textDetLimitType: 无效值不拒绝请求，按不限制处理（见 ToTaskConfig）
+    if (textDetLimitSideLen < 0) {
+        LOG_WARN("textDetLimitSideLen={} is negative, side limit disabled", textDetLimitSideLen);
     }
     if (textDetLimitType != "min" && textDetLimitType != "max") {
-        LOG_WARN("textDetLimitType='{}' is invalid (should be 'min' or 'max'), ignored", textDetLimitType);
+        LOG_WARN("textDetLimitType='{}' is invalid (should be 'min' or 'max'), side limit disabled", textDetLimitType);
     }
     
     // 检查实际使用的参数范围
@@ -120,22 +125,130 @@ bool OCRRequest::Validate(std::string& error_msg) const {
         return false;
     }
     
+    if (allowedCharset.size() > MAX_CHARSET_LENGTH) {
+        error_msg = fmt::format("allowedCharset too long (max {} bytes)", MAX_CHARSET_LENGTH);
+        return false;
+    }
+    
+    if (!modelTier.empty() && modelTier != "fast" && modelTier != "accurate") {
+        error_msg = "modelTier must be 'fast' or 'accurate'";
+        return false;
+    }
+    
+    if (rois.size() > MAX_ROIS) {
+        error_msg = fmt::format("Too many rois (max {})", MAX_ROIS);
+        return false;
+    }
+    // rois 针对原图，文档方向矫正 / 扭曲矫正会移动页面内容
+    if (!rois.empty() && (useDocOrientationClassify || useDocUnwarping)) {
+        error_msg = "rois cannot be combined with useDocOrientationClassify or useDocUnwarping";
+        return false;
+    }
+    for (const auto& roi : rois) {
+        // [x, y, width, height]：宽高为正，归一化坐标不超出页面
+        if (roi[0] < 0.0 || roi[1] < 0.0 || roi[2] <= 0.0 || roi[3] <= 0.0) {
+            error_msg = "rois must be [x, y, width, height] with x, y >= 0 and width, height > 0";
+            return false;
+        }
+        if (roiNormalized && (roi[0] + roi[2] > 1.0 || roi[1] + roi[3] > 1.0)) {
+            error_msg = "normalized rois must lie within [0, 1]";
+            return false;
+        }
+    }
+    
+    // boxes：只识别模式，坐标针对原图，不能与改变图像或检测区域的参数同时使用
+    if (boxes.size() > MAX_BOXES) {
+        error_msg = fmt::format("Too many boxes (max {})", MAX_BOXES);
+        return false;
+    }
+    if (!boxes.empty() && (useDocOrientationClassify || useDocUnwarping || !rois.empty())) {
+        error_msg = "boxes cannot be combined with useDocOrientationClassify, useDocUnwarping or rois";
+        return false;
+    }
+    for (const auto& box : boxes) {
+        for (const auto& point : box) {
+            if (!std::isfinite(point[0]) || !std::isfinite(point[1])) {
+                error_msg = "boxes must contain finite coordinates";
+                return false;
+            }
+            // 转为 float / int 前限制范围，过大的值会变成 inf 或溢出
+            if (std::abs(point[0]) > MAX_BOX_COORD || std::abs(point[1]) > MAX_BOX_COORD) {
+                error_msg = fmt::format("boxes coordinates must be within [-{0}, {0}]", MAX_BOX_COORD);
+                return false;
+            }
+        }
+    }
+    
     return true;
 }
 
+bool OCRRequest::ValidateBoxes(int width, int height, std::string& error_msg) const {
+    for (const auto& box : boxes) {
+        for (const auto& point : box) {
+            if (point[0] < -width || point[0] > 2.0 * width ||
+                point[1] < -height || point[1] > 2.0 * height) {
+                error_msg = fmt::format("boxes must lie near the {}x{} image (at most one image size outside it)",
+                                        width, height);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+ocr::OCRTaskConfig OCRRequest::ToTaskConfig() const {
+    ocr::OCRTaskConfig taskConfig;
+    taskConfig.useDocOrientationClassify = useDocOrientationClassify;
+    taskConfig.useDocUnwarping = useDocUnwarping;
+    taskConfig.useTextlineOrientation = useTextlineOrientation;
+    if (textDetLimitSideLen >= 1 && (textDetLimitType == "min" || textDetLimitType == "max")) {
+        taskConfig.textDetLimitSideLen = textDetLimitSideLen;
+        taskConfig.textDetLimitType = textDetLimitType == "max" ? ocr::DetLimitType::Max : ocr::DetLimitType::Min;
+    }
+    taskConfig.textDetThresh = static_cast<float>(textDetThresh);
+    taskConfig.textDetBoxThresh = static_cast<float>(textDetBoxThresh);
+    taskConfig.textDetUnclipRatio = static_cast<float>(textDetUnclipRatio);
+    taskConfig.textRecScoreThresh = static_cast<float>(textRecScoreThresh);
+    taskConfig.allowedCharset = allowedCharset;
+    for (const auto& roi : rois) {
+        taskConfig.rois.emplace_back(static_cast<float>(roi[0]), static_cast<float>(roi[1]),
+                                     static_cast<float>(roi[2]), static_cast<float>(roi[3]));
+    }
+    taskConfig.roisNormalized = roiNormalized;
+    if (modelTier == "fast") {
+        taskConfig.modelTier = ocr::ModelTier::Fast;
+    } else if (modelTier == "accurate") {
+        taskConfig.modelTier = ocr::ModelTier::Accurate;
+    }
+    return taskConfig;
+}
+
+std::vector<ocr::TextBox> OCRRequest::ToTextBoxes() const {
+    std::vector<ocr::TextBox> textBoxes(boxes.size());
+    for (size_t i = 0; i < boxes.size(); i++) {
+        for (int k = 0; k < 4; k++) {
+            textBoxes[i].points[k] = cv::Point2f(static_cast<float>(boxes[i][k][0]), static_cast<float>(boxes[i][k][1]));
+        }
+        textBoxes[i].confidence = 1.0f;
+    }
+    return textBoxes;
+}
+
 // ==================== OCRHandler ====================
 
 OCRHandler::OCRHandler(
     const ocr::OCRPipelineConfig& pipeline_config,
     const std::string& vis_output_dir,
-    const std::string& vis_url_prefix)
+    const std::string& vis_url_prefix,
+    size_t result_cache_bytes)
     : base_config_(pipeline_config)
     , vis_output_dir_(vis_output_dir)
-    , vis_url_prefix_(vis_url_prefix) {
+    , vis_url_prefix_(vis_url_prefix)
+    , result_cache_(result_cache_bytes) {
     
     // 创建基础Pipeline实例（会被每次请求的配置覆盖）
     base_pipeline_ = std::make_shared<ocr::OCRPipeline>(base_config_);
-    LOG_INFO("OCRHandler initialized");
+    LOG_INFO("OCRHandler initialized (result cache budget: {} MB)", result_cache_bytes / (1024 * 1024));
 }
 
 void OCRHandler::StartResultCollector() {
@@ -204,6 +317,66 @@ bool OCRHandler::WaitForResult(int64_t task_id, std::vector<ocr::PipelineOCRResu
     }
 }
 
+bool OCRHandler::SubmitTask(const cv::Mat& image, const ocr::OCRTaskConfig& config,
+                            const std::vector<ocr::TextBox>& boxes, CachedTask& task) {
+    task.ticket = result_cache_.Acquire(OCRResultCache::MakeKey(image, config, boxes));
+    task.image = image;
+    if (task.ticket.role != OCRResultCache::Role::Leader) {
+        LOG_DEBUG("[CACHE] {} for key={:016x}",
+                  task.ticket.role == OCRResultCache::Role::Hit ? "Hit" : "Coalesced", task.ticket.key);
+        return true;
+    }
+    
+    task.taskId = GenerateTaskId();
+    LOG_DEBUG("Pushing task_id={}", task.taskId);
+    bool pushed = boxes.empty() ? base_pipeline_->pushTask(image, task.taskId, config)
+                                : base_pipeline_->pushRecognitionTask(image, boxes, task.taskId, config);
+    if (!pushed) {
+        result_cache_.Publish(task.ticket.key, nullptr);  // 释放等待中的 follower
+        return false;
+    }
+    return true;
+}
+
+bool OCRHandler::CollectTask(CachedTask& task, std::vector<ocr::PipelineOCRResult>& results,
+                             cv::Mat& processedImage, bool& success, int timeout_ms) {
+    switch (task.ticket.role) {
+    case OCRResultCache::Role::Hit:
+        results = task.ticket.entry->results;
+        processedImage = task.ticket.entry->processedImage.empty() ? task.image : task.ticket.entry->processedImage;
+        success = true;
+        return true;
+        
+    case OCRResultCache::Role::Follower: {
+        if (task.ticket.pending.wait_for(std::chrono::milliseconds(timeout_ms)) != std::future_status::ready) {
+            LOG_WARN("[CACHE] Timeout waiting for coalesced request key={:016x}", task.ticket.key);
+            success = false;
+            return false;
+        }
+        OCRResultCache::EntryPtr entry = task.ticket.pending.get();
+        success = entry != nullptr;  // leader 失败时一起失败
+        if (entry) {
+            results = entry->results;
+            processedImage = entry->processedImage.empty() ? task.image : entry->processedImage;
+        }
+        return true;
+    }
+        
+    case OCRResultCache::Role::Leader:
+    default: {
+        bool done = WaitForResult(task.taskId, results, processedImage, success, timeout_ms);
+        OCRResultCache::EntryPtr entry;
+        if (done && success) {
+            // 只在文档预处理改变了图像时保存处理后图像，否则命中时使用请求自己解码的图像
+            cv::Mat stored = (processedImage.data == task.image.data) ? cv::Mat() : processedImage;
+            entry = std::make_shared<const OCRResultCache::Entry>(OCRResultCache::Entry{results, stored});
+        }
+        result_cache_.Publish(task.ticket.key, std::move(entry));
+        return done;
+    }
+    }
+}
+
 int64_t OCRHandler::GenerateTaskId() {
     static std::atomic<int64_t> task_counter{0};
     return ++task_counter;
@@ -269,7 +442,6 @@ ocr::OCRPipelineConfig OCRHandler::CreatePipelineConfig(const OCRRequest& reques
     config.useClassification = request.useTextlineOrientation;
     
     // 检测参数
-    config.detectorConfig.sizeThreshold = request.textDetLimitSideLen;
     config.detectorConfig.thresh = static_cast<float>(request.textDetThresh);
     config.detectorConfig.boxThresh = static_cast<float>(request.textDetBoxThresh);
     config.detectorConfig.unclipRatio = static_cast<float>(request.textDetUnclipRatio);
@@ -331,7 +503,15 @@ int OCRHandler::HandleRequest(const OCRRequest& request, json& response_json) {
             LOG_INFO("Base pipeline initialized and started");
             StartResultCollector();
         });
-        
+
+        // allowedCharset 需要识别字典才能检查，放在 pipeline 初始化之后
+        if (!base_pipeline_->isCharsetSupported(request.allowedCharset)) {
+            LOG_WARN("Invalid request: allowedCharset has no character in the recognition dictionary");
+            response_json = JsonResponseBuilder::BuildErrorResponse(
+                ErrorCode::INVALID_PARAMETER, "allowedCharset has no character in the recognition dictionary");
+            return 400;
+        }
+
         // 3. 根据 fileType 分流处理
         if (request.fileType == 0) {
             // PDF 处理路径
@@ -373,40 +553,42 @@ int OCRHandler::HandleImageRequest(const OCRRequest& request, json& response_jso
     
     LOG_INFO("Input image loaded: {}x{}", image.cols, image.rows);
     
+    if (!request.ValidateBoxes(image.cols, image.rows, error_msg)) {
+        LOG_ERROR("Invalid boxes: {}", error_msg);
+        response_json = JsonResponseBuilder::BuildErrorResponse(
+            ErrorCode::INVALID_PARAMETER, error_msg);
+        return 400;
+    }
+    
     // 2. 构建 OCR 任务配置
-    ocr::OCRTaskConfig taskConfig;
-    taskConfig.useDocOrientationClassify = request.useDocOrientationClassify;
-    taskConfig.useDocUnwarping = request.useDocUnwarping;
-    taskConfig.useTextlineOrientation = request.useTextlineOrientation;
-    taskConfig.textDetThresh = static_cast<float>(request.textDetThresh);
-    taskConfig.textDetBoxThresh = static_cast<float>(request.textDetBoxThresh);
-    taskConfig.textDetUnclipRatio = static_cast<float>(request.textDetUnclipRatio);
-    taskConfig.textRecScoreThresh = static_cast<float>(request.textRecScoreThresh);
-    
-    LOG_INFO("OCRTaskConfig: docOri={}, docUnwarp={}, textlineOri={}, detThresh={:.2f}, boxThresh={:.2f}, unclipRatio={:.2f}, recThresh={:.2f}",
-             taskConfig.useDocOrientationClassify, taskConfig.useDocUnwarping,
-             taskConfig.useTextlineOrientation, taskConfig.textDetThresh,
-             taskConfig.textDetBoxThresh, taskConfig.textDetUnclipRatio, taskConfig.textRecScoreThresh);
+    ocr::OCRTaskConfig taskConfig = request.ToTaskConfig();
     
-    // 3. 提交任务到 pipeline
-    int64_t task_id = GenerateTaskId();
-    LOG_DEBUG("Pushing task_id={}", task_id);
-        
-    if (!base_pipeline_->pushTask(image, task_id, taskConfig)) {
+    LOG_INFO("OCRTaskConfig: docOri={}, docUnwarp={}, textlineOri={}, detLimit={}/{}, detThresh={:.2f}, boxThresh={:.2f}, unclipRatio={:.2f}, recThresh={:.2f}, charset={}, tier={}, rois={}, boxes={}",
+             taskConfig.useDocOrientationClassify, taskConfig.useDocUnwarping,
+             taskConfig.useTextlineOrientation, taskConfig.textDetLimitSideLen,
+             taskConfig.textDetLimitType == ocr::DetLimitType::Max ? "max" : "min", taskConfig.textDetThresh,
+             taskConfig.textDetBoxThresh, taskConfig.textDetUnclipRatio, taskConfig.textRecScoreThresh,
+             taskConfig.allowedCharset.empty() ? "<all>" : taskConfig.allowedCharset,
+             request.modelTier.empty() ? "default" : request.modelTier, taskConfig.rois.size(), request.boxes.size());
+    
+    // 3. 提交任务到 pipeline（结果缓存命中或同键请求进行中时不提交）
+    CachedTask task;
+    if (!SubmitTask(image, taskConfig, request.ToTextBoxes(), task)) {
         LOG_ERROR("Failed to push task to pipeline");
         response_json = JsonResponseBuilder::BuildErrorResponse(
             ErrorCode::INTERNAL_ERROR, "Pipeline queue is full");
         return 503;
     }
+    int64_t task_id = task.taskId;
     
     // 4. 等待结果
     std::vector<ocr::PipelineOCRResult> results;
     cv::Mat processed_image;
     bool task_success = true;
     
-    LOG_INFO("Waiting for OCR results for task_id={}...", task_id);
+    LOG_INFO("Waiting for OCR results for task_id={} (cacheHit={})...", task_id, task.cacheHit());
     
-    if (!WaitForResult(task_id, results, processed_image, task_success, 10000)) {
+    if (!CollectTask(task, results, processed_image, task_success, 10000)) {
         LOG_ERROR("Failed to get OCR results for task_id={} (timeout)", task_id);
         response_json = JsonResponseBuilder::BuildErrorResponse(
             ErrorCode::INTERNAL_ERROR, "Failed to get OCR results or timeout");
@@ -433,6 +615,7 @@ int OCRHandler::HandleImageRequest(const OCRRequest& request, json& response_jso
     
     // 6. 构建成功响应
     response_json = JsonResponseBuilder::BuildSuccessResponse(results, vis_url);
+    response_json["result"]["cacheHit"] = task.cacheHit();
     return 200;
 }
 
@@ -469,18 +652,23 @@ int OCRHandler::HandlePDFRequest(const OCRRequest& request, json& response_json)
              renderResult.renderedPages, renderResult.totalPages);
     
     // 4. 构建 OCR 任务配置
-    ocr::OCRTaskConfig taskConfig;
-    taskConfig.useDocOrientationClassify = request.useDocOrientationClassify;
-    taskConfig.useDocUnwarping = request.useDocUnwarping;
-    taskConfig.useTextlineOrientation = request.useTextlineOrientation;
-    taskConfig.textDetThresh = static_cast<float>(request.textDetThresh);
-    taskConfig.textDetBoxThresh = static_cast<float>(request.textDetBoxThresh);
-    taskConfig.textDetUnclipRatio = static_cast<float>(request.textDetUnclipRatio);
-    taskConfig.textRecScoreThresh = static_cast<float>(request.textRecScoreThresh);
+    ocr::OCRTaskConfig taskConfig = request.ToTaskConfig();
+    
+    // 每页使用相同的已知文本框（只识别模式）
+    std::vector<ocr::TextBox> boxes = request.ToTextBoxes();
+    for (const auto& page : renderResult.pages) {
+        std::string error_msg;
+        if (page.success && !request.ValidateBoxes(page.image.cols, page.image.rows, error_msg)) {
+            LOG_ERROR("Invalid boxes for page {}: {}", page.pageIndex, error_msg);
+            response_json = JsonResponseBuilder::BuildErrorResponse(
+                ErrorCode::INVALID_PARAMETER, error_msg);
+            return 400;
+        }
+    }
     
     // 5. 并行提交所有页面到 OCR pipeline
     struct PageTask {
-        int64_t taskId;
+        CachedTask cached;
         int pageIndex;
     };
     std::vector<PageTask> submittedTasks;
@@ -491,28 +679,30 @@ int OCRHandler::HandlePDFRequest(const OCRRequest& request, json& response_json)
             continue;
         }
         
-        int64_t taskId = GenerateTaskId();
-        
-        if (base_pipeline_->pushTask(page.image, taskId, taskConfig)) {
-            submittedTasks.push_back({taskId, page.pageIndex});
-            LOG_DEBUG("Submitted page {} as task_id={}", page.pageIndex, taskId);
+        PageTask pageTask{CachedTask(), page.pageIndex};
+        if (SubmitTask(page.image, taskConfig, boxes, pageTask.cached)) {
+            LOG_DEBUG("Submitted page {} as task_id={} (cacheHit={})",
+                      page.pageIndex, pageTask.cached.taskId, pageTask.cached.cacheHit());
+            submittedTasks.push_back(std::move(pageTask));
         } else {
             LOG_ERROR("Failed to submit page {} to pipeline (queue full)", page.pageIndex);
         }
     }
     
-    // 6. 等待所有结果
+    // 6. 等待所有结果（按提交顺序，同一文档内重复的页面等待先提交的那一页）
     std::map<int, json> pageResults;      // pageIndex -> ocrResults
     std::map<int, std::string> pageVisUrls; // pageIndex -> vis_url
+    std::map<int, bool> pageCacheHits;    // pageIndex -> cacheHit
     
-    for (const auto& task : submittedTasks) {
+    for (auto& task : submittedTasks) {
         std::vector<ocr::PipelineOCRResult> ocrResults;
         cv::Mat processedImage;
         bool task_success = true;
+        pageCacheHits[task.pageIndex] = task.cached.cacheHit();
         
-        if (WaitForResult(task.taskId, ocrResults, processedImage, task_success, 30000)) {
+        if (CollectTask(task.cached, ocrResults, processedImage, task_success, 30000)) {
             if (!task_success) {
-                LOG_ERROR("Page {} OCR failed (engine error, task_id={})", task.pageIndex, task.taskId);
+                LOG_ERROR("Page {} OCR failed (engine error, task_id={})", task.pageIndex, task.cached.taskId);
                 pageResults[task.pageIndex] = json::array();  // 引擎失败，返回空结果
                 continue;
             }
@@ -534,7 +724,7 @@ int OCRHandler::HandlePDFRequest(const OCRRequest& request, json& response_json)
                 }
             }
         } else {
-            LOG_ERROR("Timeout waiting for page {} (task_id={})", task.pageIndex, task.taskId);
+            LOG_ERROR("Timeout waiting for page {} (task_id={})", task.pageIndex, task.cached.taskId);
             pageResults[task.pageIndex] = json::array();  // 超时，返回空结果
         }
     }
@@ -545,6 +735,9 @@ int OCRHandler::HandlePDFRequest(const OCRRequest& request, json& response_json)
         json pageJson;
         pageJson["pageIndex"] = i;
         pageJson["ocrResults"] = pageResults.count(i) ? pageResults[i] : json::array();
+        if (pageCacheHits.count(i)) {
+            pageJson["cacheHit"] = pageCacheHits[i];
+        }
         
         if (pageVisUrls.count(i)) {
             pageJson["ocrImage"] = pageVisUrls[i];
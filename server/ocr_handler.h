@@ -4,8 +4,10 @@
 #include "file_handler.h"
 #include "json_response.h"
 #include "pdf_handler.h"
+#include "result_cache.h"
 #include <nlohmann/json.hpp>
 #include <opencv2/opencv.hpp>
+#include <array>
 #include <memory>
 #include <string>
 #include <map>
@@ -27,17 +29,26 @@ struct OCRRequest {
     bool useDocOrientationClassify = false; // 文档方向矫正
     bool useDocUnwarping = false;           // 图片扭曲矫正
     bool useTextlineOrientation = false;    // 文本行方向矫正
-    int textDetLimitSideLen = 64;           // 图像边长限制（接收但不实际使用）
-    std::string textDetLimitType = "min";   // 边长限制类型: "min" 或 "max"（接收但不实际使用）
+    int textDetLimitSideLen = 0;            // 检测前的图像边长限制（默认 0：不限制）
+    std::string textDetLimitType = "min";   // 边长限制类型: "min"（短边放大到限制值）或 "max"（长边缩小到限制值）
     double textDetThresh = 0.3;             // 检测像素阈值
     double textDetBoxThresh = 0.6;          // 检测框阈值
     double textDetUnclipRatio = 1.5;        // 检测扩张系数
     double textRecScoreThresh = 0.0;        // 识别置信度阈值
+    std::string allowedCharset;             // 允许识别输出的字符（UTF-8），为空表示不限制
+    std::string modelTier;                  // 模型档位: "fast" / "accurate"，为空使用服务默认
+    std::vector<std::array<double, 4>> rois; // 感兴趣区域 [x, y, width, height]，为空表示整页
+    bool roiNormalized = false;             // true: rois 为页面宽高的比例 [0, 1]，false: 像素
+    std::vector<std::array<std::array<double, 2>, 4>> boxes;  // 已知文本框（四个顶点，像素），非空时只识别不检测
     bool visualize = false;                 // 是否开启可视化
     
     // 请求大小限制
     static constexpr size_t MAX_BASE64_SIZE = 50 * 1024 * 1024;     // 50MB Base64
     static constexpr size_t MAX_URL_LENGTH = 2048;                  // URL 长度限制
+    static constexpr size_t MAX_CHARSET_LENGTH = 4096;              // allowedCharset 字节数限制
+    static constexpr size_t MAX_ROIS = 64;                          // rois 数量限制
+    static constexpr size_t MAX_BOXES = 1024;                       // boxes 数量限制
+    static constexpr double MAX_BOX_COORD = 1e6;                    // boxes 坐标绝对值上限（像素）
     
     // PDF 参数配置
     int pdfDpi = 150;                       // PDF 渲染 DPI (默认 150)
@@ -52,6 +63,24 @@ struct OCRRequest {
      * @brief 验证请求参数
      */
     bool Validate(std::string& error_msg) const;
+    
+    /**
+     * @brief 按图像尺寸验证 boxes：顶点可超出图像，但不超过一个图像宽 / 高
+     *
+     * 即 x ∈ [-width, 2 * width]，y ∈ [-height, 2 * height]，避免远离图像的框
+     * 生成巨大的裁剪尺寸。boxes 为空时直接通过。
+     */
+    bool ValidateBoxes(int width, int height, std::string& error_msg) const;
+    
+    /**
+     * @brief 转换为 pipeline 任务级别配置
+     */
+    ocr::OCRTaskConfig ToTaskConfig() const;
+    
+    /**
+     * @brief 转换为 pipeline 文本框（只识别模式，boxes 为空时返回空）
+     */
+    std::vector<ocr::TextBox> ToTextBoxes() const;
 };
 
 /**
@@ -64,13 +93,34 @@ public:
      * @param pipeline_config OCR Pipeline配置
      * @param vis_output_dir 可视化图片输出目录
      * @param vis_url_prefix 可视化图片URL前缀
+     * @param result_cache_bytes 整图结果缓存的内存预算（0 = 关闭）
      */
     OCRHandler(
         const ocr::OCRPipelineConfig& pipeline_config,
         const std::string& vis_output_dir = "output/vis",
-        const std::string& vis_url_prefix = "/static/vis"
+        const std::string& vis_url_prefix = "/static/vis",
+        size_t result_cache_bytes = DEFAULT_RESULT_CACHE_BYTES
     );
     
+    static constexpr size_t DEFAULT_RESULT_CACHE_BYTES = 256 * 1024 * 1024;  // 256MB
+    
+    /**
+     * @brief 整图结果缓存统计
+     */
+    OCRResultCache::Stats GetResultCacheStats() const { return result_cache_.GetStats(); }
+    
+    /**
+     * @brief 检测模型分辨率选择统计
+     */
+    ocr::DetectionResolutionStats GetDetectionResolutionStats() const {
+        return base_pipeline_->getDetectionResolutionStats();
+    }
+    
+    /**
+     * @brief 空白页快速路径跳过的页数
+     */
+    uint64_t GetBlankPagesSkipped() const { return base_pipeline_->getBlankPagesSkipped(); }
+    
     /**
      * @brief 处理OCR请求
      * @param request OCR请求参数
@@ -113,6 +163,35 @@ private:
     bool WaitForResult(int64_t task_id, std::vector<ocr::PipelineOCRResult>& results, 
                        cv::Mat& processedImage, bool& success, int timeout_ms = 10000);
     
+    // ==================== 整图结果缓存 ====================
+    
+    OCRResultCache result_cache_;                       // 内容寻址结果缓存 + 同键请求合并
+    
+    /**
+     * @brief 经过结果缓存的一个 OCR 任务
+     */
+    struct CachedTask {
+        OCRResultCache::Ticket ticket;
+        int64_t taskId = -1;   // Leader 提交到 pipeline 的任务 ID
+        cv::Mat image;         // 本请求解码的输入图像（共享像素，缓存未保存处理后图像时用于可视化）
+        bool cacheHit() const { return ticket.role != OCRResultCache::Role::Leader; }
+    };
+    
+    /**
+     * @brief 查询结果缓存，未命中时提交到 pipeline
+     * @param boxes 已知文本框（非空时提交只识别的任务）
+     * @return false 表示提交失败（pipeline 队列已满）
+     */
+    bool SubmitTask(const cv::Mat& image, const ocr::OCRTaskConfig& config,
+                    const std::vector<ocr::TextBox>& boxes, CachedTask& task);
+    
+    /**
+     * @brief 获取任务结果（命中 / 等待同键请求 / 等待 pipeline），Leader 的结果写入缓存
+     * @return false 表示超时
+     */
+    bool CollectTask(CachedTask& task, std::vector<ocr::PipelineOCRResult>& results,
+                     cv::Mat& processedImage, bool& success, int timeout_ms);
+    
     // ==================== PDF 处理相关 ====================
     
     PDFHandler pdf_handler_;                            // PDF 处理器
@@ -0,0 +1,141 @@
+#include "result_cache.h"
+#include "common/hash.hpp"
+#include "common/logger.hpp"
+#include <fmt/format.h>
+
+namespace ocr_server {
+
+OCRResultCache::OCRResultCache(size_t budgetBytes)
+    : budgetBytes_(budgetBytes) {
+}
+
+uint64_t OCRResultCache::MakeKey(const cv::Mat& image, const ocr::OCRTaskConfig& config,
+                                 const std::vector<ocr::TextBox>& boxes) {
+    // 只包含影响结果的字段（浮点数按最短可逆格式输出，不同取值一定得到不同的串）
+    std::string params = fmt::format("{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}",
+                                     config.useDocOrientationClassify, config.useDocUnwarping,
+                                     config.useTextlineOrientation, config.textDetLimitSideLen,
+                                     static_cast<int>(config.textDetLimitType), config.textDetThresh,
+                                     config.textDetBoxThresh, config.textDetUnclipRatio,
+                                     config.textRecScoreThresh, static_cast<int>(config.modelTier),
+                                     config.allowedCharset);
+    if (!config.rois.empty()) {
+        params += fmt::format("|{}", config.roisNormalized);
+        for (const auto& roi : config.rois) {
+            params += fmt::format("|{},{},{},{}", roi.x, roi.y, roi.width, roi.height);
+        }
+    }
+    if (!boxes.empty()) {
+        params += "|boxes";
+        for (const auto& box : boxes) {
+            for (const auto& point : box.points) {
+                params += fmt::format("|{},{}", point.x, point.y);
+            }
+        }
+    }
+    return ocr::hashMat(image, ocr::xxh64(params.data(), params.size()));
+}
+
+size_t OCRResultCache::EntryBytes(const Entry& entry) {
+    size_t bytes = sizeof(Entry) + entry.processedImage.total() * entry.processedImage.elemSize();
+    for (const auto& result : entry.results) {
+        bytes += sizeof(result) + result.text.capacity() + result.box.capacity() * sizeof(cv::Point2f);
+    }
+    return bytes;
+}
+
+OCRResultCache::Ticket OCRResultCache::Acquire(uint64_t key) {
+    Ticket ticket;
+    ticket.key = key;
+    if (!enabled()) {
+        ticket.role = Role::Leader;
+        return ticket;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second.first);
+        ticket.role = Role::Hit;
+        ticket.entry = it->second.first->second;
+        hits_++;
+        return ticket;
+    }
+
+    auto flight = inflight_.find(key);
+    if (flight != inflight_.end()) {
+        ticket.role = Role::Follower;
+        ticket.pending = flight->second->future;
+        coalesced_++;
+        return ticket;
+    }
+
+    auto newFlight = std::make_shared<Flight>();
+    newFlight->future = newFlight->promise.get_future().share();
+    inflight_.emplace(key, std::move(newFlight));
+    ticket.role = Role::Leader;
+    misses_++;
+    return ticket;
+}
+
+void OCRResultCache::Publish(uint64_t key, EntryPtr entry) {
+    if (!enabled()) {
+        return;
+    }
+
+    std::shared_ptr<Flight> flight;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = inflight_.find(key);
+        if (it != inflight_.end()) {
+            flight = std::move(it->second);
+            inflight_.erase(it);
+        }
+        if (entry) {
+            size_t bytes = EntryBytes(*entry);
+            if (bytes <= budgetBytes_) {
+                InsertLocked(key, entry, bytes);
+            } else {
+                LOG_DEBUG("OCR result ({} bytes) exceeds cache budget, not cached", bytes);
+            }
+        }
+    }
+    // 在锁外唤醒 follower
+    if (flight) {
+        flight->promise.set_value(std::move(entry));
+    }
+}
+
+void OCRResultCache::InsertLocked(uint64_t key, EntryPtr entry, size_t bytes) {
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        bytes_ -= it->second.second;
+        lru_.erase(it->second.first);
+        index_.erase(it);
+    }
+    while (!lru_.empty() && bytes_ + bytes > budgetBytes_) {
+        auto victim = index_.find(lru_.back().first);
+        bytes_ -= victim->second.second;
+        index_.erase(victim);
+        lru_.pop_back();
+        evictions_++;
+    }
+    lru_.emplace_front(key, std::move(entry));
+    index_[key] = {lru_.begin(), bytes};
+    bytes_ += bytes;
+}
+
+OCRResultCache::Stats OCRResultCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.hits = hits_;
+    stats.coalesced = coalesced_;
+    stats.misses = misses_;
+    stats.evictions = evictions_;
+    stats.entries = lru_.size();
+    stats.bytes = bytes_;
+    stats.budgetBytes = budgetBytes_;
+    return stats;
+}
+
+} // namespace ocr_server
@@ -0,0 +1,117 @@
+#pragma once
+
+/**
+ * @file result_cache.h
+ * @brief 整图 OCR 结果缓存（内容寻址 + 同键请求合并）
+ *
+ * 功能：
+ * - 键：图像像素哈希（XXH64）+ 影响结果的 OCRTaskConfig 字段
+ * - 按内存预算做 LRU 淘汰（结果文本、坐标和文档预处理后的图像都计入；未做预处理时不保存图像）
+ * - singleflight：同一个键同时只有一个请求（leader）提交到 pipeline，
+ *   其余请求（follower）等待 leader 的结果
+ */
+
+#include "pipeline/ocr_pipeline.h"
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ocr_server {
+
+class OCRResultCache {
+public:
+    /**
+     * @brief 缓存的一次整图 OCR 结果（只读共享）
+     */
+    struct Entry {
+        std::vector<ocr::PipelineOCRResult> results;
+        cv::Mat processedImage;  // 可视化使用（仅当文档预处理改变了图像时保存，否则为空，使用请求的输入图像）
+    };
+    using EntryPtr = std::shared_ptr<const Entry>;
+
+    enum class Role {
+        Hit,       // 缓存命中，entry 可直接使用
+        Leader,    // 未命中，调用者负责执行并 Publish()
+        Follower,  // 同键请求正在执行，等待 pending
+    };
+
+    struct Ticket {
+        uint64_t key = 0;
+        Role role = Role::Leader;
+        EntryPtr entry;                        // Hit
+        std::shared_future<EntryPtr> pending;  // Follower（leader 失败时为 nullptr）
+    };
+
+    struct Stats {
+        uint64_t hits = 0;        // 直接命中
+        uint64_t coalesced = 0;   // 合并到进行中的同键请求
+        uint64_t misses = 0;      // 实际提交到 pipeline
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t budgetBytes = 0;
+    };
+
+    /**
+     * @param budgetBytes 内存预算（0 = 关闭缓存和请求合并，每次都是 Leader）
+     */
+    explicit OCRResultCache(size_t budgetBytes);
+
+    OCRResultCache(const OCRResultCache&) = delete;
+    OCRResultCache& operator=(const OCRResultCache&) = delete;
+
+    bool enabled() const { return budgetBytes_ > 0; }
+
+    /**
+     * @brief 计算缓存键（相同像素、相同结果相关参数、相同的已知文本框得到相同的键）
+     * @param boxes 只识别模式的文本框（为空表示检测 + 识别）
+     */
+    static uint64_t MakeKey(const cv::Mat& image, const ocr::OCRTaskConfig& config,
+                            const std::vector<ocr::TextBox>& boxes = {});
+
+    /**
+     * @brief 估算一个结果占用的内存
+     */
+    static size_t EntryBytes(const Entry& entry);
+
+    /**
+     * @brief 查询缓存；未命中且没有同键请求在执行时，调用者成为 Leader
+     */
+    Ticket Acquire(uint64_t key);
+
+    /**
+     * @brief Leader 完成：唤醒 follower，成功的结果写入缓存
+     * @param entry 结果（nullptr 表示失败，不缓存，follower 收到 nullptr）
+     */
+    void Publish(uint64_t key, EntryPtr entry);
+
+    Stats GetStats() const;
+
+private:
+    struct Flight {
+        std::promise<EntryPtr> promise;
+        std::shared_future<EntryPtr> future;
+    };
+
+    void InsertLocked(uint64_t key, EntryPtr entry, size_t bytes);
+
+    const size_t budgetBytes_;
+
+    mutable std::mutex mutex_;
+    std::list<std::pair<uint64_t, EntryPtr>> lru_;  // 头部为最近使用
+    std::unordered_map<uint64_t, std::pair<std::list<std::pair<uint64_t, EntryPtr>>::iterator, size_t>> index_;
+    std::unordered_map<uint64_t, std::shared_ptr<Flight>> inflight_;
+    size_t bytes_ = 0;
+
+    uint64_t hits_ = 0;
+    uint64_t coalesced_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+};
+
+} // namespace ocr_server
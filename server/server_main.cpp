@@ -23,6 +23,8 @@ namespace {
     constexpr int MAX_PORT = 65535;
     constexpr int MIN_THREADS = 1;
     constexpr int MAX_THREADS = 256;
+    constexpr int DEFAULT_CACHE_MB = 256;
+    constexpr int MAX_CACHE_MB = 65536;
     
     // 认证相关
     constexpr size_t TOKEN_PREFIX_LENGTH = 6;       // strlen("token ")
@@ -102,6 +104,10 @@ ocr::OCRPipelineConfig LoadPipelineConfig(bool useMobileModel) {
     config.enableVisualization = true;
     config.sortResults = true;
     
+    // 识别结果缓存：重复的文本行（页眉页脚、表单标签）直接返回缓存结果，不占用 NPU
+    config.recognizerConfig.resultCacheSize = 4096;
+    config.fastRecognizerConfig.resultCacheSize = 4096;
+    
     if (useMobileModel) {
         LOG_INFO("Using MOBILE models");
     } else {
@@ -157,6 +163,13 @@ int main(int argc, char* argv[]) {
     std::string vis_dir = DEFAULT_VIS_DIR;
     std::string model_type = DEFAULT_MODEL_TYPE;
     std::string log_dir = DEFAULT_LOG_DIR;
+    int cache_mb = DEFAULT_CACHE_MB;
+    bool mosaic = false;
+    bool fast_tier = false;
+    bool prob_map_cache = false;
+    bool tiling = false;
+    bool adaptive_resolution = false;
+    bool skip_blank_pages = false;
     
     // 定义长选项
     static struct option long_options[] = {
@@ -165,6 +178,13 @@ int main(int argc, char* argv[]) {
         {"vis-dir",  required_argument, 0, 'v'},
         {"model",    required_argument, 0, 'm'},
         {"log-dir",  required_argument, 0, 'l'},
+        {"cache-mb", required_argument, 0, 'c'},
+        {"mosaic",   no_argument,       0, 'M'},
+        {"fast-tier", no_argument,      0, 'F'},
+        {"prob-map-cache", no_argument,      0, 'P'},
+        {"tiling", no_argument,      0, 'T'},
+        {"adaptive-resolution", no_argument,      0, 'A'},
+        {"skip-blank-pages", no_argument,      0, 'B'},
         {"help",     no_argument,       0, 'h'},
         {0, 0, 0, 0}
     };
@@ -172,7 +192,7 @@ int main(int argc, char* argv[]) {
     // 解析命令行参数
     int opt;
     int option_index = 0;
-    while ((opt = getopt_long(argc, argv, "p:t:v:m:l:h", long_options, &option_index)) != -1) {
+    while ((opt = getopt_long(argc, argv, "p:t:v:m:l:c:MFPTABh", long_options, &option_index)) != -1) {
         switch (opt) {
             case 'p':
                 if (!parseIntArg(optarg, port, "port", MIN_PORT, MAX_PORT)) {
@@ -197,6 +217,29 @@ int main(int argc, char* argv[]) {
             case 'l':
                 log_dir = optarg;
                 break;
+            case 'c':
+                if (!parseIntArg(optarg, cache_mb, "cache-mb", 0, MAX_CACHE_MB)) {
+                    return 1;
+                }
+                break;
+            case 'M':
+                mosaic = true;
+                break;
+            case 'F':
+                fast_tier = true;
+                break;
+            case 'P':
+                prob_map_cache = true;
+                break;
+            case 'T':
+                tiling = true;
+                break;
+            case 'A':
+                adaptive_resolution = true;
+                break;
+            case 'B':
+                skip_blank_pages = true;
+                break;
             case 'h':
                 std::cout << "Usage: " << argv[0] << " [options]\n"
                           << "Options:\n"
@@ -205,6 +248,13 @@ int main(int argc, char* argv[]) {
                           << "  -v, --vis-dir <path>     Visualization output directory (default: " << DEFAULT_VIS_DIR << ")\n"
                           << "  -m, --model <type>       Model type: 'server' or 'mobile' (default: " << DEFAULT_MODEL_TYPE << ")\n"
                           << "  -l, --log-dir <path>     Log directory (default: " << DEFAULT_LOG_DIR << ")\n"
+                          << "  -c, --cache-mb <MB>      OCR result cache budget, 0 disables (default: " << DEFAULT_CACHE_MB << ")\n"
+                          << "  -M, --mosaic             Detect small images together on one canvas\n"
+                          << "  -F, --fast-tier          Also load the mobile models for modelTier=\"fast\" requests\n"
+                          << "  -P, --prob-map-cache     Cache detection probability maps for threshold-only retries\n"
+                          << "  -T, --tiling             Detect very large or long pages in overlapping tiles\n"
+                          << "  -A, --adaptive-resolution Pick det_640 or det_960 from the estimated text size\n"
+                          << "  -B, --skip-blank-pages   Return empty results for blank pages without detection\n"
                           << "  -h, --help               Show this help message\n";
                 return 0;
             default:
@@ -235,23 +285,61 @@ int main(int argc, char* argv[]) {
     LOG_INFO("Loading OCR Pipeline configuration...");
     bool useMobileModel = (model_type == "mobile");
     auto pipeline_config = LoadPipelineConfig(useMobileModel);
+    pipeline_config.useMosaic = mosaic;
+    // server 模型为默认时同时加载 mobile 模型，供 modelTier="fast" 的请求使用
+    pipeline_config.loadFastTier = fast_tier && !useMobileModel;
+    // 缓存最近的检测概率图：同一图像只调整检测阈值重试时跳过推理（每张 960 图约 0.9MB）
+    if (prob_map_cache) {
+        pipeline_config.detectorConfig.probMapCacheSize = 16;
+        pipeline_config.fastDetectorConfig.probMapCacheSize = 16;
+    }
+    // 长边超过模型输入 4 倍的页面（长票据、大幅图纸）分块检测，避免小字被整页缩放抹掉
+    pipeline_config.detectorConfig.useTiling = tiling;
+    pipeline_config.fastDetectorConfig.useTiling = tiling;
+    // 按文字大小选择检测模型：大字图片用 det_640，小字图片用 det_960
+    pipeline_config.detectorConfig.adaptiveResolution = adaptive_resolution;
+    pipeline_config.fastDetectorConfig.adaptiveResolution = adaptive_resolution;
+    // 扫描 PDF 中的空白分隔页、背面：直接返回空结果，不占用 NPU
+    pipeline_config.skipBlankPages = skip_blank_pages;
     pipeline_config.Show();
     
     // 创建OCR Handler
     LOG_INFO("Initializing OCR Handler...");
     auto ocr_handler = std::make_shared<OCRHandler>(
-        pipeline_config, vis_dir, "/static/vis");
+        pipeline_config, vis_dir, "/static/vis", static_cast<size_t>(cache_mb) * 1024 * 1024);
     
     // 创建Crow应用（带认证中间件）
     crow::App<AuthMiddleware> app;
     
     // 健康检查接口
     CROW_ROUTE(app, "/health")
-    ([]() {
+    ([ocr_handler]() {
         json response;
         response["status"] = "healthy";
         response["service"] = "DeepX OCR Server";
         response["version"] = "1.0.0";
+        
+        auto cache = ocr_handler->GetResultCacheStats();
+        response["resultCache"] = {
+            {"hits", cache.hits},
+            {"coalesced", cache.coalesced},
+            {"misses", cache.misses},
+            {"entries", cache.entries},
+            {"bytes", cache.bytes},
+            {"budgetBytes", cache.budgetBytes}
+        };
+        
+        auto resolution = ocr_handler->GetDetectionResolutionStats();
+        response["detectionResolution"] = {
+            {"policy", resolution.policy},
+            {"model640", resolution.model640},
+            {"model960", resolution.model960},
+            {"estimated", resolution.estimated},
+            {"downgraded", resolution.downgraded},
+            {"upgraded", resolution.upgraded},
+            {"fallback", resolution.fallback}
+        };
+        response["blankPagesSkipped"] = ocr_handler->GetBlankPagesSkipped();
         crow::response res(200, response.dump());
         res.set_header("Content-Type", "application/json");
         return res;
@@ -281,6 +281,26 @@ TEST(JsonResponseBuilder, ConvertOCRResultToJson_ScorePrecision) {
     EXPECT_NEAR(score, 0.123, 0.001);
 }
 
+/**
+ * @brief 测试识别模型档位字段
+ */
+TEST(JsonResponseBuilder, ConvertOCRResultToJson_RecTier) {
+    ocr::PipelineOCRResult result;
+    result.text = "Test";
+    result.confidence = 0.9f;
+    result.box = {
+        cv::Point2f(0, 0), cv::Point2f(10, 0),
+        cv::Point2f(10, 10), cv::Point2f(0, 10)
+    };
+    
+    json item = JsonResponseBuilder::ConvertOCRResultToJson(result, "");
+    EXPECT_EQ(item["recTier"].get<std::string>(), "server");
+    
+    result.tier = ocr::RecognitionTier::Mobile;
+    item = JsonResponseBuilder::ConvertOCRResultToJson(result, "");
+    EXPECT_EQ(item["recTier"].get<std::string>(), "mobile");
+}
+
 /**
  * @brief 测试坐标点格式
  */
@@ -8,6 +8,7 @@
 
 #include <gtest/gtest.h>
 #include <nlohmann/json.hpp>
+#include <cmath>
 #include "ocr_handler.h"
 
 using json = nlohmann::json;
@@ -30,8 +31,9 @@ TEST(OCRRequestFromJson, DefaultValues) {
     EXPECT_FALSE(req.useDocOrientationClassify);
     EXPECT_FALSE(req.useDocUnwarping);
     EXPECT_FALSE(req.useTextlineOrientation);
-    EXPECT_EQ(req.textDetLimitSideLen, 64);
+    EXPECT_EQ(req.textDetLimitSideLen, 0);  // 默认不限制（小图仍可参与 mosaic 检测）
     EXPECT_EQ(req.textDetLimitType, "min");
+    EXPECT_EQ(req.ToTaskConfig().textDetLimitSideLen, 0);
     EXPECT_DOUBLE_EQ(req.textDetThresh, 0.3);
     EXPECT_DOUBLE_EQ(req.textDetBoxThresh, 0.6);
     EXPECT_DOUBLE_EQ(req.textDetUnclipRatio, 1.5);
@@ -93,7 +95,7 @@ TEST(OCRRequestFromJson, PartialParameters) {
     EXPECT_EQ(req.fileType, 1);
     EXPECT_FALSE(req.useDocUnwarping);
     EXPECT_FALSE(req.useTextlineOrientation);
-    EXPECT_EQ(req.textDetLimitSideLen, 64);
+    EXPECT_EQ(req.textDetLimitSideLen, 0);
     EXPECT_DOUBLE_EQ(req.textDetBoxThresh, 0.6);
 }
 
@@ -160,6 +162,18 @@ TEST(OCRRequestFromJson, TextDetLimitParams) {
     OCRRequest req = OCRRequest::FromJson(j);
     EXPECT_EQ(req.textDetLimitSideLen, 640);
     EXPECT_EQ(req.textDetLimitType, "min");
+    EXPECT_EQ(req.ToTaskConfig().textDetLimitSideLen, 640);
+    EXPECT_EQ(req.ToTaskConfig().textDetLimitType, ocr::DetLimitType::Min);
+    
+    req.textDetLimitType = "max";
+    EXPECT_EQ(req.ToTaskConfig().textDetLimitType, ocr::DetLimitType::Max);
+    
+    // 无效值：不限制
+    req.textDetLimitType = "invalid";
+    EXPECT_EQ(req.ToTaskConfig().textDetLimitSideLen, 0);
+    req.textDetLimitType = "max";
+    req.textDetLimitSideLen = 0;
+    EXPECT_EQ(req.ToTaskConfig().textDetLimitSideLen, 0);
 }
 
 TEST(OCRRequestFromJson, TextDetThreshParam) {
@@ -198,6 +212,75 @@ TEST(OCRRequestFromJson, TextRecScoreThreshParam) {
     EXPECT_DOUBLE_EQ(req.textRecScoreThresh, 0.5);
 }
 
+TEST(OCRRequestFromJson, AllowedCharsetParam) {
+    json j;
+    j["file"] = "test";
+    j["allowedCharset"] = "0123456789元";
+    
+    OCRRequest req = OCRRequest::FromJson(j);
+    EXPECT_EQ(req.allowedCharset, "0123456789元");
+    EXPECT_EQ(req.ToTaskConfig().allowedCharset, "0123456789元");
+    
+    // 默认不限制
+    EXPECT_TRUE(OCRRequest::FromJson(json{{"file", "test"}}).allowedCharset.empty());
+}
+
+TEST(OCRRequestFromJson, ModelTierParam) {
+    json j;
+    j["file"] = "test";
+    j["modelTier"] = "fast";
+    
+    OCRRequest req = OCRRequest::FromJson(j);
+    EXPECT_EQ(req.modelTier, "fast");
+    EXPECT_EQ(req.ToTaskConfig().modelTier, ocr::ModelTier::Fast);
+    
+    req.modelTier = "accurate";
+    EXPECT_EQ(req.ToTaskConfig().modelTier, ocr::ModelTier::Accurate);
+    
+    // 默认使用服务默认档位
+    EXPECT_EQ(OCRRequest::FromJson(json{{"file", "test"}}).ToTaskConfig().modelTier, ocr::ModelTier::Default);
+}
+
+TEST(OCRRequestFromJson, RoisParam) {
+    json j;
+    j["file"] = "test";
+    j["rois"] = json::array({json::array({0.1, 0.2, 0.3, 0.1}), json::array({0.5, 0.5, 0.25, 0.25})});
+    j["roiNormalized"] = true;
+    
+    OCRRequest req = OCRRequest::FromJson(j);
+    ASSERT_EQ(req.rois.size(), 2u);
+    EXPECT_DOUBLE_EQ(req.rois[1][2], 0.25);
+    EXPECT_TRUE(req.roiNormalized);
+    
+    auto taskConfig = req.ToTaskConfig();
+    ASSERT_EQ(taskConfig.rois.size(), 2u);
+    EXPECT_FLOAT_EQ(taskConfig.rois[0].y, 0.2f);
+    EXPECT_TRUE(taskConfig.roisNormalized);
+    
+    // 默认整页
+    EXPECT_TRUE(OCRRequest::FromJson(json{{"file", "test"}}).ToTaskConfig().rois.empty());
+}
+
+TEST(OCRRequestFromJson, BoxesParam) {
+    json j;
+    j["file"] = "test";
+    j["boxes"] = json::array({
+        json::array({json::array({10, 20}), json::array({110, 20}), json::array({110, 50}), json::array({10, 50})})
+    });
+    
+    OCRRequest req = OCRRequest::FromJson(j);
+    ASSERT_EQ(req.boxes.size(), 1u);
+    EXPECT_DOUBLE_EQ(req.boxes[0][2][0], 110.0);
+    
+    auto boxes = req.ToTextBoxes();
+    ASSERT_EQ(boxes.size(), 1u);
+    EXPECT_FLOAT_EQ(boxes[0].points[0].x, 10.0f);
+    EXPECT_FLOAT_EQ(boxes[0].points[3].y, 50.0f);
+    
+    // 默认检测 + 识别
+    EXPECT_TRUE(OCRRequest::FromJson(json{{"file", "test"}}).ToTextBoxes().empty());
+}
+
 /**
  * @brief 测试 PDF 参数解析
  */
@@ -453,6 +536,151 @@ TEST(OCRRequestValidate, TextRecScoreThreshRange) {
     EXPECT_EQ(error_msg, "textRecScoreThresh must be in range [0.0, 1.0]");
 }
 
+/**
+ * @brief 测试 allowedCharset 长度限制
+ */
+TEST(OCRRequestValidate, AllowedCharsetLength) {
+    OCRRequest req;
+    req.file = "test_data";
+    
+    std::string error_msg;
+    
+    req.allowedCharset = std::string(OCRRequest::MAX_CHARSET_LENGTH, 'a');
+    EXPECT_TRUE(req.Validate(error_msg));
+    
+    req.allowedCharset.push_back('a');
+    EXPECT_FALSE(req.Validate(error_msg));
+    EXPECT_EQ(error_msg, "allowedCharset too long (max 4096 bytes)");
+}
+
+/**
+ * @brief 测试 modelTier 取值
+ */
+TEST(OCRRequestValidate, ModelTier) {
+    OCRRequest req;
+    req.file = "test_data";
+    
+    std::string error_msg;
+    
+    for (const char* tier : {"", "fast", "accurate"}) {
+        req.modelTier = tier;
+        EXPECT_TRUE(req.Validate(error_msg)) << tier;
+    }
+    
+    req.modelTier = "mobile";
+    EXPECT_FALSE(req.Validate(error_msg));
+    EXPECT_EQ(error_msg, "modelTier must be 'fast' or 'accurate'");
+}
+
+/**
+ * @brief 测试 rois 取值
+ */
+TEST(OCRRequestValidate, Rois) {
+    OCRRequest req;
+    req.file = "test_data";
+    
+    std::string error_msg;
+    
+    req.rois = {{100, 200, 640, 80}};
+    EXPECT_TRUE(req.Validate(error_msg));
+    
+    // 像素坐标不知道页面大小，超出部分在 pipeline 中裁剪
+    req.rois = {{3000, 4000, 640, 80}};
+    EXPECT_TRUE(req.Validate(error_msg));
+    
+    req.rois = {{100, 200, 0, 80}};
+    EXPECT_FALSE(req.Validate(error_msg));
+    
+    // ROI 针对原图，不能与移动页面内容的文档预处理同时使用
+    req.rois = {{100, 200, 640, 80}};
+    req.useDocOrientationClassify = true;
+    EXPECT_FALSE(req.Validate(error_msg));
+    EXPECT_EQ(error_msg, "rois cannot be combined with useDocOrientationClassify or useDocUnwarping");
+    req.useDocOrientationClassify = false;
+    req.useDocUnwarping = true;
+    EXPECT_FALSE(req.Validate(error_msg));
+    req.useDocUnwarping = false;
+    
+    req.roiNormalized = true;
+    req.rois = {{0.5, 0.5, 0.5, 0.5}};
+    EXPECT_TRUE(req.Validate(error_msg));
+    
+    req.rois = {{0.5, 0.5, 0.6, 0.1}};
+    EXPECT_FALSE(req.Validate(error_msg));
+    EXPECT_EQ(error_msg, "normalized rois must lie within [0, 1]");
+    
+    req.rois.assign(OCRRequest::MAX_ROIS + 1, {0.0, 0.0, 0.1, 0.1});
+    EXPECT_FALSE(req.Validate(error_msg));
+    EXPECT_EQ(error_msg, "Too many rois (max 64)");
+}
+
+/**
+ * @brief 测试 boxes（只识别模式）
+ */
+TEST(OCRRequestValidate, Boxes) {
+    OCRRequest req;
+    req.file = "test_data";
+    
+    std::string error_msg;
+    
+    req.boxes = {{{{10, 20}, {110, 20}, {110, 50}, {10, 50}}}};
+    EXPECT_TRUE(req.Validate(error_msg));
+    
+    // 文本框针对原图，不能与文档预处理、rois 同时使用
+    req.useDocUnwarping = true;
+    EXPECT_FALSE(req.Validate(error_msg));
+    req.useDocUnwarping = false;
+    req.rois = {{0, 0, 100, 100}};
+    EXPECT_FALSE(req.Validate(error_msg));
+    req.rois.clear();
+    
+    req.boxes[0][1][0] = std::nan("");
+    EXPECT_FALSE(req.Validate(error_msg));
+    EXPECT_EQ(error_msg, "boxes must contain finite coordinates");
+    
+    // 有限但超出 float 范围的坐标
+    req.boxes[0][1][0] = 1e300;
+    EXPECT_FALSE(req.Validate(error_msg));
+    EXPECT_EQ(error_msg, "boxes coordinates must be within [-1000000, 1000000]");
+    req.boxes[0][1][0] = -OCRRequest::MAX_BOX_COORD - 1;
+    EXPECT_FALSE(req.Validate(error_msg));
+    req.boxes[0][1][0] = 110;
+    
+    req.boxes.assign(OCRRequest::MAX_BOXES + 1, {{{0, 0}, {10, 0}, {10, 10}, {0, 10}}});
+    EXPECT_FALSE(req.Validate(error_msg));
+    EXPECT_EQ(error_msg, "Too many boxes (max 1024)");
+}
+
+/**
+ * @brief 测试 boxes 按图像尺寸的范围检查
+ */
+TEST(OCRRequestValidate, BoxesWithinImage) {
+    OCRRequest req;
+    std::string error_msg;
+    
+    EXPECT_TRUE(req.ValidateBoxes(200, 100, error_msg));
+    
+    req.boxes = {{{{10, 20}, {110, 20}, {110, 50}, {10, 50}}}};
+    EXPECT_TRUE(req.ValidateBoxes(200, 100, error_msg));
+    
+    // 允许超出图像，但不超过一个图像宽 / 高
+    req.boxes[0][0] = {-200, -100};
+    req.boxes[0][2] = {400, 200};
+    EXPECT_TRUE(req.ValidateBoxes(200, 100, error_msg));
+    
+    req.boxes[0][2] = {401, 50};
+    EXPECT_FALSE(req.ValidateBoxes(200, 100, error_msg));
+    EXPECT_EQ(error_msg, "boxes must lie near the 200x100 image (at most one image size outside it)");
+    
+    req.boxes[0][2] = {110, 50};
+    req.boxes[0][0] = {10, -101};
+    EXPECT_FALSE(req.ValidateBoxes(200, 100, error_msg));
+    
+    // 通过 Validate 的大坐标仍会被图像尺寸拒绝
+    req.boxes[0][0] = {10, OCRRequest::MAX_BOX_COORD};
+    EXPECT_FALSE(req.ValidateBoxes(200, 100, error_msg));
+}
+
 /**
  * @brief 测试有效请求的验证
  */
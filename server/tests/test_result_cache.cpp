@@ -0,0 +1,207 @@
+/**
+ * @file test_result_cache.cpp
+ * @brief 整图 OCR 结果缓存测试
+ *
+ * 测试缓存键、命中、同键请求合并（singleflight）和内存预算淘汰
+ */
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <thread>
+#include "result_cache.h"
+
+using namespace ocr_server;
+
+namespace {
+
+cv::Mat MakeImage(int seed) {
+    cv::Mat image(32, 64, CV_8UC3, cv::Scalar(seed, seed * 2, seed * 3));
+    return image;
+}
+
+OCRResultCache::EntryPtr MakeEntry(const std::string& text, const cv::Mat& image = cv::Mat()) {
+    OCRResultCache::Entry entry;
+    ocr::PipelineOCRResult result;
+    result.text = text;
+    result.confidence = 0.9f;
+    result.box = {cv::Point2f(0, 0), cv::Point2f(10, 0), cv::Point2f(10, 10), cv::Point2f(0, 10)};
+    entry.results.push_back(result);
+    entry.processedImage = image;
+    return std::make_shared<const OCRResultCache::Entry>(std::move(entry));
+}
+
+} // namespace
+
+// ==================== 缓存键 ====================
+
+/**
+ * @brief 相同像素和参数得到相同的键，像素或结果相关参数不同则键不同
+ */
+TEST(OCRResultCache, KeyCoversPixelsAndConfig) {
+    ocr::OCRTaskConfig config;
+    cv::Mat image = MakeImage(1);
+
+    uint64_t key = OCRResultCache::MakeKey(image, config);
+    EXPECT_EQ(key, OCRResultCache::MakeKey(image.clone(), config));
+    EXPECT_NE(key, OCRResultCache::MakeKey(MakeImage(2), config));
+
+    ocr::OCRTaskConfig other = config;
+    other.textDetThresh = 0.31f;
+    EXPECT_NE(key, OCRResultCache::MakeKey(image, other));
+
+    other = config;
+    other.allowedCharset = "0123456789";
+    EXPECT_NE(key, OCRResultCache::MakeKey(image, other));
+
+    other = config;
+    other.modelTier = ocr::ModelTier::Fast;
+    EXPECT_NE(key, OCRResultCache::MakeKey(image, other));
+
+    other = config;
+    other.useTextlineOrientation = true;
+    EXPECT_NE(key, OCRResultCache::MakeKey(image, other));
+
+    other = config;
+    other.textDetLimitSideLen = 736;
+    EXPECT_NE(key, OCRResultCache::MakeKey(image, other));
+
+    ocr::OCRTaskConfig maxLimit = other;
+    maxLimit.textDetLimitType = ocr::DetLimitType::Max;
+    EXPECT_NE(OCRResultCache::MakeKey(image, other), OCRResultCache::MakeKey(image, maxLimit));
+
+    other = config;
+    other.rois = {cv::Rect2f(0.0f, 0.0f, 0.5f, 0.5f)};
+    EXPECT_NE(key, OCRResultCache::MakeKey(image, other));
+
+    ocr::OCRTaskConfig pixels = other;
+    other.roisNormalized = true;
+    EXPECT_NE(OCRResultCache::MakeKey(image, other), OCRResultCache::MakeKey(image, pixels));
+
+    // 只识别模式：文本框参与键
+    ocr::TextBox box;
+    box.points[0] = cv::Point2f(1, 2);
+    box.points[1] = cv::Point2f(30, 2);
+    box.points[2] = cv::Point2f(30, 12);
+    box.points[3] = cv::Point2f(1, 12);
+    uint64_t boxKey = OCRResultCache::MakeKey(image, config, {box});
+    EXPECT_NE(key, boxKey);
+    EXPECT_EQ(boxKey, OCRResultCache::MakeKey(image, config, {box}));
+    box.points[2].x = 31;
+    EXPECT_NE(boxKey, OCRResultCache::MakeKey(image, config, {box}));
+}
+
+// ==================== 命中与合并 ====================
+
+/**
+ * @brief 第一个请求为 Leader，发布后的请求命中
+ */
+TEST(OCRResultCache, LeaderThenHit) {
+    OCRResultCache cache(1024 * 1024);
+
+    auto first = cache.Acquire(42);
+    EXPECT_EQ(first.role, OCRResultCache::Role::Leader);
+    cache.Publish(42, MakeEntry("hello"));
+
+    auto second = cache.Acquire(42);
+    ASSERT_EQ(second.role, OCRResultCache::Role::Hit);
+    ASSERT_EQ(second.entry->results.size(), 1u);
+    EXPECT_EQ(second.entry->results[0].text, "hello");
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.entries, 1u);
+}
+
+/**
+ * @brief Leader 执行期间的同键请求等待 Leader 的结果
+ */
+TEST(OCRResultCache, ConcurrentRequestsCoalesce) {
+    OCRResultCache cache(1024 * 1024);
+
+    auto leader = cache.Acquire(7);
+    ASSERT_EQ(leader.role, OCRResultCache::Role::Leader);
+
+    auto follower = cache.Acquire(7);
+    ASSERT_EQ(follower.role, OCRResultCache::Role::Follower);
+    EXPECT_EQ(follower.pending.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+
+    std::thread publisher([&cache]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        cache.Publish(7, MakeEntry("shared"));
+    });
+    auto entry = follower.pending.get();
+    publisher.join();
+
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->results[0].text, "shared");
+    EXPECT_EQ(cache.GetStats().coalesced, 1u);
+    EXPECT_EQ(cache.GetStats().misses, 1u);
+}
+
+/**
+ * @brief Leader 失败：follower 收到 nullptr，结果不缓存，下一个请求重新成为 Leader
+ */
+TEST(OCRResultCache, FailedLeaderIsNotCached) {
+    OCRResultCache cache(1024 * 1024);
+
+    cache.Acquire(9);
+    auto follower = cache.Acquire(9);
+    cache.Publish(9, nullptr);
+
+    EXPECT_EQ(follower.pending.get(), nullptr);
+    EXPECT_EQ(cache.Acquire(9).role, OCRResultCache::Role::Leader);
+    EXPECT_EQ(cache.GetStats().entries, 0u);
+}
+
+// ==================== 内存预算 ====================
+
+/**
+ * @brief 超出预算时淘汰最久未使用的结果，单个超预算的结果不缓存
+ */
+TEST(OCRResultCache, EvictsWithinBudget) {
+    cv::Mat page(100, 100, CV_8UC3, cv::Scalar::all(0));  // 30000 字节
+    size_t entryBytes = OCRResultCache::EntryBytes(*MakeEntry("x", page));
+    OCRResultCache cache(entryBytes * 2 + entryBytes / 2);
+
+    for (uint64_t key = 1; key <= 2; key++) {
+        cache.Acquire(key);
+        cache.Publish(key, MakeEntry("x", page));
+    }
+    EXPECT_EQ(cache.Acquire(1).role, OCRResultCache::Role::Hit);  // 1 变为最近使用
+
+    cache.Acquire(3);
+    cache.Publish(3, MakeEntry("x", page));  // 淘汰 2
+
+    EXPECT_EQ(cache.Acquire(1).role, OCRResultCache::Role::Hit);
+    EXPECT_EQ(cache.Acquire(3).role, OCRResultCache::Role::Hit);
+    EXPECT_EQ(cache.Acquire(2).role, OCRResultCache::Role::Leader);
+    cache.Publish(2, nullptr);
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.entries, 2u);
+    EXPECT_EQ(stats.evictions, 1u);
+    EXPECT_LE(stats.bytes, stats.budgetBytes);
+
+    // 比整个预算还大的结果
+    cv::Mat huge(400, 400, CV_8UC3, cv::Scalar::all(0));
+    cache.Acquire(4);
+    cache.Publish(4, MakeEntry("x", huge));
+    EXPECT_EQ(cache.Acquire(4).role, OCRResultCache::Role::Leader);
+    EXPECT_EQ(cache.GetStats().entries, 2u);
+}
+
+/**
+ * @brief 预算为 0 时关闭：每个请求都是 Leader，不合并也不缓存
+ */
+TEST(OCRResultCache, DisabledWithZeroBudget) {
+    OCRResultCache cache(0);
+    EXPECT_FALSE(cache.enabled());
+
+    EXPECT_EQ(cache.Acquire(1).role, OCRResultCache::Role::Leader);
+    EXPECT_EQ(cache.Acquire(1).role, OCRResultCache::Role::Leader);
+    cache.Publish(1, MakeEntry("x"));
+    EXPECT_EQ(cache.Acquire(1).role, OCRResultCache::Role::Leader);
+    EXPECT_EQ(cache.GetStats().entries, 0u);
+}
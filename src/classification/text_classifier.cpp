@@ -6,6 +6,9 @@
 
 namespace ocr {
 
+// Idle input buffers kept for the classification model
+static constexpr size_t kInputPoolIdle = 32;
+
 TextClassifier::TextClassifier(const ClassifierConfig& config)
     : config_(config) {
 }
@@ -20,6 +23,7 @@ bool TextClassifier::Initialize() {
     
     try {
         engine_ = std::make_unique<dxrt::InferenceEngine>(config_.modelPath);
+        inputPool_ = BufferPool::create(config_.inputHeight, config_.inputWidth, CV_8UC3, kInputPoolIdle);
         LOG_INFO("Classification model loaded successfully");
     } catch (const std::exception& e) {
         LOG_ERROR("Failed to load classification model: {}", e.what());
@@ -95,26 +99,33 @@ std::vector<std::pair<std::string, float>> TextClassifier::ClassifyBatch(
 }
 
 cv::Mat TextClassifier::Preprocess(const cv::Mat& image) {
+    cv::Mat result;
+    if (!PreprocessInto(image, result)) {
+        return cv::Mat();
+    }
+    return result;
+}
+
+bool TextClassifier::PreprocessInto(const cv::Mat& image, cv::Mat& result) {
     if (image.empty()) {
         LOG_ERROR("Input image is empty");
-        return cv::Mat();
+        return false;
     }
     
     // Step 1: Resize to fixed size [80, 160]
     // Note: height=80, width=160
-    cv::Mat resized;
-    cv::resize(image, resized, cv::Size(config_.inputWidth, config_.inputHeight));
-    
     // Step 2: Convert to float and normalize
     // DXRT expects uint8 HWC format, so we DON'T need manual normalization
     // The normalization is baked into the model
     
     // Ensure the image is in the correct format (BGR, uint8, HWC)
-    cv::Mat result;
-    if (resized.type() != CV_8UC3) {
-        resized.convertTo(result, CV_8UC3);
+    if (image.type() == CV_8UC3) {
+        // 直接写入 result（已是 80x160 时不重新分配）
+        cv::resize(image, result, cv::Size(config_.inputWidth, config_.inputHeight));
     } else {
-        result = resized;
+        cv::Mat resized;
+        cv::resize(image, resized, cv::Size(config_.inputWidth, config_.inputHeight));
+        resized.convertTo(result, CV_8UC3);
     }
     
     // Ensure contiguous memory
@@ -122,7 +133,7 @@ cv::Mat TextClassifier::Preprocess(const cv::Mat& image) {
         result = result.clone();
     }
     
-    return result;
+    return true;
 }
 
 std::pair<std::string, float> TextClassifier::Postprocess(dxrt::TensorPtrs& outputs) {
@@ -210,9 +221,12 @@ int TextClassifier::ClassifyAsync(const cv::Mat& textImage, void* userArg) {
         return -1;
     }
     
-    // Preprocess
-    cv::Mat preprocessed = Preprocess(textImage);
-    if (preprocessed.empty()) {
+    // Preprocess straight into a pooled input buffer
+    BufferLease input;
+    if (inputPool_ && textImage.type() == inputPool_->type()) {
+        input = inputPool_->acquire();
+    }
+    if (!PreprocessInto(textImage, input.mat())) {
         LOG_ERROR("Preprocessing failed");
         if (userCallback_) {
             userCallback_("0", 0.0f, userArg);
@@ -220,20 +234,57 @@ int TextClassifier::ClassifyAsync(const cv::Mat& textImage, void* userArg) {
         return -1;
     }
     
-    // Ensure continuous memory
-    if (!preprocessed.isContinuous()) {
-        preprocessed = preprocessed.clone();
+    SubmitAsync(std::move(input), userArg);
+    return 0;
+}
+
+int TextClassifier::ClassifyRegionAsync(const cv::Mat& image, const TextCropGeometry& geom, void* userArg) {
+    if (!initialized_) {
+        LOG_ERROR("TextClassifier not initialized");
+        if (userCallback_) {
+            userCallback_("0", 0.0f, userArg);
+        }
+        return -1;
     }
     
-    // Create context - store preprocessed image to keep it alive during async inference
-    ClassificationContext* ctx = new ClassificationContext{preprocessed.clone(), userArg};
+    if (image.empty() || geom.width < 1 || geom.height < 1) {
+        LOG_ERROR("Input image or text region is empty");
+        if (userCallback_) {
+            userCallback_("0", 0.0f, userArg);
+        }
+        return -1;
+    }
     
-    // Submit async inference
-    engine_->RunAsync(ctx->preprocessed.data, ctx);
+    // Sample the box straight into the model input (BGR uint8 HWC, 80x160)
+    BufferLease input;
+    if (inputPool_ && image.type() == inputPool_->type()) {
+        input = inputPool_->acquire();
+    }
+    if (input.empty()) {
+        cv::Mat sampled(config_.inputHeight, config_.inputWidth, image.type());
+        renderTextCrop(image, geom, false, sampled);
+        if (!PreprocessInto(sampled, input.mat())) {
+            if (userCallback_) {
+                userCallback_("0", 0.0f, userArg);
+            }
+            return -1;
+        }
+    } else {
+        renderTextCrop(image, geom, false, input.mat());
+    }
     
+    SubmitAsync(std::move(input), userArg);
     return 0;
 }
 
+void TextClassifier::SubmitAsync(BufferLease input, void* userArg) {
+    // Create context - owns the input buffer until the callback (no copy)
+    ClassificationContext* ctx = new ClassificationContext{std::move(input), userArg};
+    
+    // Submit async inference
+    engine_->RunAsync(ctx->input.data(), ctx);
+}
+
 int TextClassifier::internalCallback(dxrt::TensorPtrs& outputs, void* userArg) {
     ClassificationContext* ctx = static_cast<ClassificationContext*>(userArg);
     if (!ctx) {
@@ -242,7 +293,7 @@ int TextClassifier::internalCallback(dxrt::TensorPtrs& outputs, void* userArg) {
         return 0;
     }
     
-    // Ensure context is deleted
+    // Ensure context is deleted (returns the input buffer to its pool)
     std::unique_ptr<ClassificationContext> ctxGuard(ctx);
     
     if (outputs.empty()) {
@@ -0,0 +1,127 @@
+#include "detection/db_components.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace ocr {
+namespace db_components {
+
+namespace {
+
+struct Run {
+    int y;
+    int x0;
+    int x1;       // inclusive
+    int label;
+    double sum;
+};
+
+int findRoot(std::vector<int>& parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+// 保留较小的 label 作为根，使最终顺序等于首次出现的扫描顺序
+int unite(std::vector<int>& parent, int a, int b) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a == b) return a;
+    if (b < a) std::swap(a, b);
+    parent[b] = a;
+    return a;
+}
+
+template <typename T>
+double rowSum(const T* row, int x0, int x1) {
+    double sum = 0.0;
+    for (int x = x0; x <= x1; x++) {
+        sum += row[x];
+    }
+    return sum;
+}
+
+} // namespace
+
+std::vector<ComponentStats> label(const cv::Mat& bitmap, const cv::Mat& scoreMap) {
+    CV_Assert(bitmap.type() == CV_8UC1);
+    CV_Assert(scoreMap.type() == CV_32FC1 || scoreMap.type() == CV_8UC1);
+    CV_Assert(bitmap.rows == scoreMap.rows && bitmap.cols == scoreMap.cols);
+
+    const bool u8Score = scoreMap.depth() == CV_8U;
+    std::vector<Run> runs;
+    std::vector<int> parent;
+
+    size_t prevBegin = 0;
+    size_t prevEnd = 0;
+    for (int y = 0; y < bitmap.rows; y++) {
+        const uint8_t* b = bitmap.ptr<uint8_t>(y);
+        const size_t curBegin = runs.size();
+        size_t j = prevBegin;
+
+        int x = 0;
+        while (x < bitmap.cols) {
+            if (!b[x]) {
+                x++;
+                continue;
+            }
+            int x0 = x;
+            while (x < bitmap.cols && b[x]) x++;
+            int x1 = x - 1;
+
+            double sum = u8Score ? rowSum(scoreMap.ptr<uint8_t>(y), x0, x1)
+                                 : rowSum(scoreMap.ptr<float>(y), x0, x1);
+
+            // 上一行中与 [x0-1, x1+1] 重叠的 run 属于同一连通域（8 邻域）
+            while (j < prevEnd && runs[j].x1 < x0 - 1) j++;
+            int lbl = -1;
+            for (size_t k = j; k < prevEnd && runs[k].x0 <= x1 + 1; k++) {
+                lbl = lbl < 0 ? findRoot(parent, runs[k].label) : unite(parent, lbl, runs[k].label);
+            }
+            if (lbl < 0) {
+                lbl = static_cast<int>(parent.size());
+                parent.push_back(lbl);
+            }
+            runs.push_back({y, x0, x1, lbl, sum});
+        }
+
+        prevBegin = curBegin;
+        prevEnd = runs.size();
+    }
+
+    // 根 label 按首次出现顺序编号
+    std::vector<int> index(parent.size(), -1);
+    std::vector<ComponentStats> components;
+    for (size_t i = 0; i < parent.size(); i++) {
+        if (findRoot(parent, static_cast<int>(i)) == static_cast<int>(i)) {
+            index[i] = static_cast<int>(components.size());
+            components.emplace_back();
+        }
+    }
+
+    std::vector<cv::Point> tl(components.size(), cv::Point(bitmap.cols, bitmap.rows));
+    std::vector<cv::Point> br(components.size(), cv::Point(-1, -1));
+    for (const auto& run : runs) {
+        int c = index[findRoot(parent, run.label)];
+        ComponentStats& comp = components[c];
+        comp.probSum += run.sum;
+        comp.pixelCount += run.x1 - run.x0 + 1;
+        comp.points.emplace_back(run.x0, run.y);
+        if (run.x1 != run.x0) {
+            comp.points.emplace_back(run.x1, run.y);
+        }
+        tl[c].x = std::min(tl[c].x, run.x0);
+        tl[c].y = std::min(tl[c].y, run.y);
+        br[c].x = std::max(br[c].x, run.x1);
+        br[c].y = std::max(br[c].y, run.y);
+    }
+    for (size_t c = 0; c < components.size(); c++) {
+        components[c].bbox = cv::Rect(tl[c], cv::Point(br[c].x + 1, br[c].y + 1));
+    }
+
+    return components;
+}
+
+} // namespace db_components
+} // namespace ocr
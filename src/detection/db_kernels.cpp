@@ -0,0 +1,188 @@
+#include "detection/db_kernels.h"
+#include "common/simd.hpp"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DB_KERNELS_HAVE_AVX2 1
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DB_KERNELS_HAVE_NEON 1
+#endif
+
+namespace ocr {
+namespace db_kernels {
+
+namespace {
+
+using RowKernel = void (*)(const float*, int, float, uint8_t*, uint8_t*);
+
+inline uint8_t quantizeProb(float p) {
+    // NaN 和负数都落到 0，与向量版本的 max/min 语义一致
+    float c = p > 0.0f ? (p < 1.0f ? p : 1.0f) : 0.0f;
+    return static_cast<uint8_t>(std::lrint(c * 255.0f));
+}
+
+void binarizeRowScalar(const float* prob, int n, float thresh,
+                       uint8_t* bitmap, uint8_t* quantized) {
+    for (int i = 0; i < n; i++) {
+        bitmap[i] = prob[i] > thresh ? 255 : 0;
+    }
+    if (quantized) {
+        for (int i = 0; i < n; i++) {
+            quantized[i] = quantizeProb(prob[i]);
+        }
+    }
+}
+
+#ifdef DB_KERNELS_HAVE_AVX2
+// 32 pixels per iteration: 4x8 float compares packed down to 32 bytes.
+// packs_* work per 128-bit lane, so the result is fixed up with a dword permute.
+__attribute__((target("avx2")))
+void binarizeRowAvx2(const float* prob, int n, float thresh,
+                     uint8_t* bitmap, uint8_t* quantized) {
+    const __m256 vthresh = _mm256_set1_ps(thresh);
+    const __m256 vzero = _mm256_setzero_ps();
+    const __m256 vone = _mm256_set1_ps(1.0f);
+    const __m256 vscale = _mm256_set1_ps(255.0f);
+    const __m256i fixup = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256 p0 = _mm256_loadu_ps(prob + i);
+        __m256 p1 = _mm256_loadu_ps(prob + i + 8);
+        __m256 p2 = _mm256_loadu_ps(prob + i + 16);
+        __m256 p3 = _mm256_loadu_ps(prob + i + 24);
+
+        __m256i m0 = _mm256_castps_si256(_mm256_cmp_ps(p0, vthresh, _CMP_GT_OQ));
+        __m256i m1 = _mm256_castps_si256(_mm256_cmp_ps(p1, vthresh, _CMP_GT_OQ));
+        __m256i m2 = _mm256_castps_si256(_mm256_cmp_ps(p2, vthresh, _CMP_GT_OQ));
+        __m256i m3 = _mm256_castps_si256(_mm256_cmp_ps(p3, vthresh, _CMP_GT_OQ));
+        __m256i mask = _mm256_packs_epi16(_mm256_packs_epi32(m0, m1),
+                                          _mm256_packs_epi32(m2, m3));
+        mask = _mm256_permutevar8x32_epi32(mask, fixup);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(bitmap + i), mask);
+
+        if (quantized) {
+            // max_ps(p, 0) returns 0 for NaN inputs
+            __m256i q0 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(p0, vzero), vone), vscale));
+            __m256i q1 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(p1, vzero), vone), vscale));
+            __m256i q2 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(p2, vzero), vone), vscale));
+            __m256i q3 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(p3, vzero), vone), vscale));
+            __m256i q = _mm256_packus_epi16(_mm256_packus_epi32(q0, q1),
+                                            _mm256_packus_epi32(q2, q3));
+            q = _mm256_permutevar8x32_epi32(q, fixup);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(quantized + i), q);
+        }
+    }
+
+    if (i < n) {
+        binarizeRowScalar(prob + i, n - i, thresh, bitmap + i,
+                          quantized ? quantized + i : nullptr);
+    }
+}
+#endif
+
+#ifdef DB_KERNELS_HAVE_NEON
+// 16 pixels per iteration: 4x4 float compares narrowed down to 16 bytes.
+void binarizeRowNeon(const float* prob, int n, float thresh,
+                     uint8_t* bitmap, uint8_t* quantized) {
+    const float32x4_t vthresh = vdupq_n_f32(thresh);
+    const float32x4_t vzero = vdupq_n_f32(0.0f);
+    const float32x4_t vone = vdupq_n_f32(1.0f);
+    const float32x4_t vscale = vdupq_n_f32(255.0f);
+
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        float32x4_t p0 = vld1q_f32(prob + i);
+        float32x4_t p1 = vld1q_f32(prob + i + 4);
+        float32x4_t p2 = vld1q_f32(prob + i + 8);
+        float32x4_t p3 = vld1q_f32(prob + i + 12);
+
+        uint16x8_t m01 = vcombine_u16(vmovn_u32(vcgtq_f32(p0, vthresh)),
+                                      vmovn_u32(vcgtq_f32(p1, vthresh)));
+        uint16x8_t m23 = vcombine_u16(vmovn_u32(vcgtq_f32(p2, vthresh)),
+                                      vmovn_u32(vcgtq_f32(p3, vthresh)));
+        vst1q_u8(bitmap + i, vcombine_u8(vmovn_u16(m01), vmovn_u16(m23)));
+
+        if (quantized) {
+            // vmaxnmq returns the numeric operand for NaN inputs
+            uint32x4_t q0 = vcvtnq_u32_f32(vmulq_f32(vminq_f32(vmaxnmq_f32(p0, vzero), vone), vscale));
+            uint32x4_t q1 = vcvtnq_u32_f32(vmulq_f32(vminq_f32(vmaxnmq_f32(p1, vzero), vone), vscale));
+            uint32x4_t q2 = vcvtnq_u32_f32(vmulq_f32(vminq_f32(vmaxnmq_f32(p2, vzero), vone), vscale));
+            uint32x4_t q3 = vcvtnq_u32_f32(vmulq_f32(vminq_f32(vmaxnmq_f32(p3, vzero), vone), vscale));
+            uint16x8_t q01 = vcombine_u16(vmovn_u32(q0), vmovn_u32(q1));
+            uint16x8_t q23 = vcombine_u16(vmovn_u32(q2), vmovn_u32(q3));
+            vst1q_u8(quantized + i, vcombine_u8(vmovn_u16(q01), vmovn_u16(q23)));
+        }
+    }
+
+    if (i < n) {
+        binarizeRowScalar(prob + i, n - i, thresh, bitmap + i,
+                          quantized ? quantized + i : nullptr);
+    }
+}
+#endif
+
+struct Dispatch {
+    RowKernel kernel = binarizeRowScalar;
+    simd::Isa isa = simd::Isa::Scalar;
+
+    Dispatch() {
+#ifdef DB_KERNELS_HAVE_AVX2
+        if (simd::hasAvx2()) {
+            kernel = binarizeRowAvx2;
+            isa = simd::Isa::AVX2;
+        }
+#endif
+#ifdef DB_KERNELS_HAVE_NEON
+        kernel = binarizeRowNeon;
+        isa = simd::Isa::NEON;
+#endif
+    }
+};
+
+const Dispatch& dispatch() {
+    static const Dispatch instance;
+    return instance;
+}
+
+} // namespace
+
+void binarizeRow(const float* prob, int n, float thresh,
+                 uint8_t* bitmap, uint8_t* quantized) {
+    dispatch().kernel(prob, n, thresh, bitmap, quantized);
+}
+
+void binarize(const cv::Mat& pred, float thresh,
+              cv::Mat& bitmap, cv::Mat* quantized) {
+    CV_Assert(pred.type() == CV_32FC1);
+
+    bitmap.create(pred.rows, pred.cols, CV_8UC1);
+    if (quantized) {
+        quantized->create(pred.rows, pred.cols, CV_8UC1);
+    }
+
+    const RowKernel kernel = dispatch().kernel;
+    bool continuous = pred.isContinuous() && bitmap.isContinuous() &&
+                      (!quantized || quantized->isContinuous());
+    if (continuous) {
+        kernel(pred.ptr<float>(), pred.rows * pred.cols, thresh,
+               bitmap.ptr<uint8_t>(), quantized ? quantized->ptr<uint8_t>() : nullptr);
+        return;
+    }
+
+    for (int y = 0; y < pred.rows; y++) {
+        kernel(pred.ptr<float>(y), pred.cols, thresh,
+               bitmap.ptr<uint8_t>(y), quantized ? quantized->ptr<uint8_t>(y) : nullptr);
+    }
+}
+
+const char* binarizeIsaName() {
+    return simd::isaName(dispatch().isa);
+}
+
+} // namespace db_kernels
+} // namespace ocr
@@ -1,8 +1,13 @@
 #include "detection/db_postprocess.h"
+#include "detection/db_kernels.h"
+#include "detection/db_components.h"
 #include "common/geometry.h"
 #include "common/logger.hpp"
 #include <opencv2/opencv.hpp>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
 #include <clipper2/clipper.h>
 
 namespace ocr {
@@ -10,11 +15,22 @@ namespace ocr {
 DBPostProcessor::DBPostProcessor(float thresh,
                                  float box_thresh,
                                  int max_candidates,
-                                 float unclip_ratio)
+                                 float unclip_ratio,
+                                 bool quantized_score,
+                                 bool component_score,
+                                 int num_workers,
+                                 bool rect_unclip)
     : thresh_(thresh),
       box_thresh_(box_thresh),
       max_candidates_(max_candidates),
-      unclip_ratio_(unclip_ratio) {
+      unclip_ratio_(unclip_ratio),
+      quantized_score_(quantized_score),
+      component_score_(component_score),
+      rect_unclip_(rect_unclip) {
+    if (num_workers > 1) {
+        // 调用线程也参与处理，额外创建 num_workers - 1 个线程
+        workers_ = std::make_unique<ThreadPool>(num_workers - 1);
+    }
 }
 
 std::vector<DeepXOCR::TextBox> DBPostProcessor::process(const cv::Mat& pred, 
@@ -31,19 +47,50 @@ std::vector<DeepXOCR::TextBox> DBPostProcessor::process(const cv::Mat& pred,
                                                          float thresh,
                                                          float box_thresh,
                                                          float unclip_ratio) {
-    std::vector<DeepXOCR::TextBox> text_boxes;
-
     // If resized dimensions not provided, assume no padding
     if (resized_h <= 0) resized_h = src_h;
     if (resized_w <= 0) resized_w = src_w;
 
     // 二值化（使用传入的 thresh 参数）
+    // 单次遍历完成 threshold + convertTo，可选同时输出量化概率图用于框打分
     cv::Mat bitmap;
-    cv::threshold(pred, bitmap, thresh, 255, cv::THRESH_BINARY);
-    bitmap.convertTo(bitmap, CV_8UC1);
-
-    LOG_DEBUG("Binary threshold: {:.2f}, bitmap size: {}x{}, non-zero: {}", 
-              thresh, bitmap.cols, bitmap.rows, cv::countNonZero(bitmap));
+    cv::Mat quantized;
+    db_kernels::binarize(pred, thresh, bitmap, quantized_score_ ? &quantized : nullptr);
+    const cv::Mat& score_map = quantized_score_ ? quantized : pred;
+
+    LOG_DEBUG("Binary threshold: {:.2f}, bitmap size: {}x{}, non-zero: {}, isa: {}", 
+              thresh, bitmap.cols, bitmap.rows, cv::countNonZero(bitmap),
+              db_kernels::binarizeIsaName());
+
+    // Coordinate mapping from model output space to original image space
+    // PPOCR preprocessing: Pad first to square, then resize
+    // - Original image: src_h × src_w (e.g., 1800×1349)
+    // - Padded to square: resized_h × resized_w (e.g., 1800×1800, added 451px on right)
+    // - Resized to model input: pred.rows × pred.cols (e.g., 960×960)
+    //
+    // Mapping: model_output (960×960) → padded_space (1800×1800)
+    // scale = padded_size / model_output_size
+    // Coordinates in padded space ARE in original image space!
+    float scale_x = static_cast<float>(resized_w) / pred.cols;
+    float scale_y = static_cast<float>(resized_h) / pred.rows;
+
+    if (component_score_) {
+        // 连通域模式：单次扫描得到每个区域的概率和/像素数/端点，分数直接由统计量计算
+        auto components = db_components::label(bitmap, score_map);
+        LOG_DEBUG("Found {} components", components.size());
+
+        const double score_scale = score_map.depth() == CV_8U ? 1.0 / 255.0 : 1.0;
+        int num_components = std::min(static_cast<int>(components.size()), max_candidates_);
+
+        return collectBoxes(num_components, [&](int i, DeepXOCR::TextBox& text_box) {
+            float score = static_cast<float>(components[i].meanProb() * score_scale);
+            if (score < box_thresh) {
+                return false;
+            }
+            return buildTextBox(components[i].points, score, unclip_ratio,
+                                scale_x, scale_y, src_h, src_w, text_box);
+        });
+    }
 
     // 查找轮廓
     auto contours = findContours(bitmap);
@@ -51,82 +98,141 @@ std::vector<DeepXOCR::TextBox> DBPostProcessor::process(const cv::Mat& pred,
 
     // 处理每个轮廓
     int num_contours = std::min(static_cast<int>(contours.size()), max_candidates_);
-    
-    for (int i = 0; i < num_contours; i++) {
+
+    return collectBoxes(num_contours, [&](int i, DeepXOCR::TextBox& text_box) {
         const auto& contour = contours[i];
 
         // 计算置信度分数（使用传入的 box_thresh 参数）
-        float score = boxScoreFast(pred, contour);
+        float score = boxScoreFast(score_map, contour);
         if (score < box_thresh) {
-            continue;
+            return false;
         }
+        return buildTextBox(contour, score, unclip_ratio,
+                            scale_x, scale_y, src_h, src_w, text_box);
+    });
+}
 
-        // 获取最小外接矩形
-        float min_side;
-        auto box = getMinBoxes(contour, min_side);
-        
-        if (min_side < 3) {  // 过滤太小的框
-            continue;
+std::vector<DeepXOCR::TextBox> DBPostProcessor::collectBoxes(
+        int num_candidates,
+        const std::function<bool(int, DeepXOCR::TextBox&)>& build) {
+    std::vector<DeepXOCR::TextBox> text_boxes;
+
+    if (!workers_ || num_candidates < kParallelMinCandidates) {
+        for (int i = 0; i < num_candidates; i++) {
+            DeepXOCR::TextBox text_box;
+            if (build(i, text_box)) {
+                text_boxes.push_back(text_box);
+            }
         }
+        return text_boxes;
+    }
 
+    // 并行模式：候选按连续区间切块，每个候选写入自己的槽位，最后按下标顺序合并，
+    // 输出与串行路径完全一致。调用线程自己处理第 0 块。
+    std::vector<DeepXOCR::TextBox> slots(num_candidates);
+    std::vector<uint8_t> valid(num_candidates, 0);
+
+    int max_chunks = (num_candidates + kParallelMinChunk - 1) / kParallelMinChunk;
+    int num_chunks = std::min(static_cast<int>(workers_->size()) + 1, max_chunks);
+    auto run_chunk = [&](int chunk) {
+        int begin = static_cast<int>(static_cast<int64_t>(num_candidates) * chunk / num_chunks);
+        int end = static_cast<int>(static_cast<int64_t>(num_candidates) * (chunk + 1) / num_chunks);
+        for (int i = begin; i < end; i++) {
+            valid[i] = build(i, slots[i]) ? 1 : 0;
+        }
+    };
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(num_chunks - 1);
+    for (int chunk = 1; chunk < num_chunks; chunk++) {
+        futures.push_back(workers_->enqueue(run_chunk, chunk));
+    }
+
+    // 所有块结束前不能离开（run_chunk 引用了栈上的数据）
+    std::exception_ptr error;
+    try {
+        run_chunk(0);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (auto& future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) error = std::current_exception();
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    for (int i = 0; i < num_candidates; i++) {
+        if (valid[i]) {
+            text_boxes.push_back(slots[i]);
+        }
+    }
+    return text_boxes;
+}
+
+bool DBPostProcessor::buildTextBox(const std::vector<cv::Point>& contour,
+                                   float score, float unclip_ratio,
+                                   float scale_x, float scale_y,
+                                   int src_h, int src_w,
+                                   DeepXOCR::TextBox& text_box) {
+    // 获取最小外接矩形
+    float min_side;
+    auto box = getMinBoxes(contour, min_side);
+    
+    if (min_side < 3) {  // 过滤太小的框
+        return false;
+    }
+
+    std::vector<cv::Point2f> final_box;
+    if (rect_unclip_ && unclipRect(box, unclip_ratio, final_box)) {
+        // 快速路径：矩形的圆角外扩，其最小外接矩形就是各边外移 distance 的矩形
+        final_box = Geometry::orderPointsClockwise(final_box);
+    } else {
         // 扩展检测框（使用传入的 unclip_ratio 参数）
         auto unclipped_box = unclip(box, unclip_ratio);
 
         // Clipper2 may return a polygon with many points (e.g., 56 points for rounded corners)
         // Convert to minimum bounding rectangle (4 points)
-        std::vector<cv::Point2f> final_box;
         if (unclipped_box.size() > 4) {
             // Convert Point2f to Point for minAreaRect
             std::vector<cv::Point> unclipped_contour;
             for (const auto& pt : unclipped_box) {
                 unclipped_contour.push_back(cv::Point(static_cast<int>(pt.x), static_cast<int>(pt.y)));
             }
-            
+
             // Get minimum bounding rectangle
             cv::RotatedRect rect = cv::minAreaRect(unclipped_contour);
             cv::Point2f vertices[4];
             rect.points(vertices);
-            
+
             for (int k = 0; k < 4; k++) {
                 final_box.push_back(vertices[k]);
             }
-            
+
             // Sort clockwise
             final_box = Geometry::orderPointsClockwise(final_box);
         } else {
             final_box = unclipped_box;
         }
+    }
 
-        // Coordinate mapping from model output space to original image space
-        // PPOCR preprocessing: Pad first to square, then resize
-        // - Original image: src_h × src_w (e.g., 1800×1349)
-        // - Padded to square: resized_h × resized_w (e.g., 1800×1800, added 451px on right)
-        // - Resized to model input: pred.rows × pred.cols (e.g., 960×960)
-        //
-        // Mapping: model_output (960×960) → padded_space (1800×1800)
-        // scale = padded_size / model_output_size
-        // Coordinates in padded space ARE in original image space!
+    size_t num_points = std::min(static_cast<size_t>(4), final_box.size());
+    for (size_t j = 0; j < num_points; j++) {
+        // Map from model output to padded space (which is original image space + padding)
+        float x = final_box[j].x * scale_x;
+        float y = final_box[j].y * scale_y;
         
-        float scale_x = static_cast<float>(resized_w) / pred.cols;
-        float scale_y = static_cast<float>(resized_h) / pred.rows;
-
-        DeepXOCR::TextBox text_box;
-        size_t num_points = std::min(static_cast<size_t>(4), final_box.size());
-        for (size_t j = 0; j < num_points; j++) {
-            // Map from model output to padded space (which is original image space + padding)
-            float x = final_box[j].x * scale_x;
-            float y = final_box[j].y * scale_y;
-            
-            // Clip to original image bounds
-            text_box.points[j].x = std::clamp(x, 0.0f, static_cast<float>(src_w));
-            text_box.points[j].y = std::clamp(y, 0.0f, static_cast<float>(src_h));
-        }
-        text_box.confidence = score;
-
-        text_boxes.push_back(text_box);
+        // Clip to original image bounds
+        text_box.points[j].x = std::clamp(x, 0.0f, static_cast<float>(src_w));
+        text_box.points[j].y = std::clamp(y, 0.0f, static_cast<float>(src_h));
     }
+    text_box.confidence = score;
 
-    return text_boxes;
+    return true;
 }
 
 std::vector<std::vector<cv::Point>> DBPostProcessor::findContours(const cv::Mat& bitmap) {
@@ -191,7 +297,44 @@ float DBPostProcessor::boxScoreFast(const cv::Mat& bitmap,
 
     // 计算平均分数
     cv::Mat roi = bitmap(cv::Range(ymin, ymax), cv::Range(xmin, xmax));
-    return cv::mean(roi, mask)[0];
+    double score = cv::mean(roi, mask)[0];
+    if (bitmap.depth() == CV_8U) {
+        score /= 255.0;  // 量化概率图
+    }
+    return static_cast<float>(score);
+}
+
+bool DBPostProcessor::unclipRect(const std::vector<cv::Point2f>& box, float unclip_ratio,
+                                 std::vector<cv::Point2f>& expanded) {
+    if (box.size() != 4) {
+        return false;
+    }
+
+    float area = polygonArea(box);
+    float length = polygonLength(box);
+    if (length == 0) {
+        return false;
+    }
+    float distance = area * unclip_ratio / length;
+
+    // box 为有序矩形顶点 p0..p3，u/v 为相邻两条边的单位方向
+    cv::Point2f edge_u = box[1] - box[0];
+    cv::Point2f edge_v = box[3] - box[0];
+    float len_u = std::sqrt(edge_u.dot(edge_u));
+    float len_v = std::sqrt(edge_v.dot(edge_v));
+    if (len_u < 1e-3f || len_v < 1e-3f) {
+        return false;
+    }
+    cv::Point2f du = edge_u * (distance / len_u);
+    cv::Point2f dv = edge_v * (distance / len_v);
+
+    expanded = {
+        box[0] - du - dv,
+        box[1] + du - dv,
+        box[2] + du + dv,
+        box[3] - du + dv
+    };
+    return true;
 }
 
 std::vector<cv::Point2f> DBPostProcessor::unclip(const std::vector<cv::Point2f>& box) {
@@ -227,8 +370,9 @@ std::vector<cv::Point2f> DBPostProcessor::unclip(const std::vector<cv::Point2f>&
     );
     
     // Debug logging
-    static int debug_count = 0;
-    if (debug_count < 3) {
+    // 并行后处理时多个线程同时进入，计数器需为原子变量
+    static std::atomic<int> debug_count{0};
+    if (debug_count.load(std::memory_order_relaxed) < 3) {
         LOG_DEBUG("Unclip: area={:.2f}, length={:.2f}, ratio={:.2f}, distance={:.2f}, solution paths={}", 
                  area, length, unclip_ratio, distance, solution.size());
         if (!solution.empty()) {
@@ -251,7 +395,9 @@ std::vector<cv::Point2f> DBPostProcessor::unclip(const std::vector<cv::Point2f>&
     }
     
     return unclipped_box;
-}float DBPostProcessor::polygonArea(const std::vector<cv::Point2f>& box) {
+}
+
+float DBPostProcessor::polygonArea(const std::vector<cv::Point2f>& box) {
     if (box.size() < 3) {
         return 0.0f;
     }
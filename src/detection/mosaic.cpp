@@ -0,0 +1,61 @@
+#include "detection/mosaic.h"
+#include <algorithm>
+
+namespace ocr {
+namespace mosaic {
+
+std::vector<cv::Rect> pack(const std::vector<cv::Size>& sizes, int canvasSize, int margin) {
+    std::vector<cv::Rect> placements;
+    placements.reserve(sizes.size());
+
+    int x = 0, y = 0, rowHeight = 0;
+    for (const auto& size : sizes) {
+        if (size.width <= 0 || size.height <= 0 || size.width > canvasSize || size.height > canvasSize) {
+            break;
+        }
+        if (x > 0 && x + size.width > canvasSize) {
+            // 换行
+            y += rowHeight + margin;
+            x = 0;
+            rowHeight = 0;
+        }
+        if (y + size.height > canvasSize) {
+            break;
+        }
+        placements.emplace_back(x, y, size.width, size.height);
+        x += size.width + margin;
+        rowHeight = std::max(rowHeight, size.height);
+    }
+    return placements;
+}
+
+std::vector<std::vector<DeepXOCR::TextBox>> splitBoxes(const std::vector<DeepXOCR::TextBox>& boxes,
+                                                       const std::vector<cv::Rect>& placements) {
+    std::vector<std::vector<DeepXOCR::TextBox>> split(placements.size());
+    for (const auto& box : boxes) {
+        cv::Point2f center(0, 0);
+        for (const auto& point : box.points) {
+            center.x += point.x * 0.25f;
+            center.y += point.y * 0.25f;
+        }
+
+        for (size_t i = 0; i < placements.size(); i++) {
+            const cv::Rect& rect = placements[i];
+            if (center.x < rect.x || center.x >= rect.x + rect.width ||
+                center.y < rect.y || center.y >= rect.y + rect.height) {
+                continue;
+            }
+            DeepXOCR::TextBox local = box;
+            for (auto& point : local.points) {
+                point.x = std::clamp(point.x - rect.x, 0.0f, static_cast<float>(rect.width));
+                point.y = std::clamp(point.y - rect.y, 0.0f, static_cast<float>(rect.height));
+            }
+            split[i].push_back(local);
+            break;
+        }
+    }
+    return split;
+}
+
+} // namespace mosaic
+} // namespace ocr
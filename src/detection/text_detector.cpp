@@ -1,9 +1,14 @@
 #include "detection/text_detector.h"
 #include "common/logger.hpp"
 #include "detection/db_postprocess.h"
+#include "detection/tiling.h"
+#include "detection/mosaic.h"
+#include "detection/text_scale.h"
 #include "preprocessing/image_ops.h"
 #include "common/visualizer.h"
+#include "common/hash.hpp"
 #include <algorithm>
+#include <atomic>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -14,16 +19,85 @@ static void createDirectory(const std::string& path) {
     mkdir(path.c_str(), 0755);
 }
 
+// Idle input buffers kept per detection model (one per in-flight detection task is enough)
+static constexpr size_t kInputPoolIdle = 8;
+
+/**
+ * @brief Shared state of one tiled page; the last tile to finish merges and reports
+ */
+struct TiledDetectionJob {
+    int64_t taskId = 0;
+    FramePtr frame;
+    double preprocess_time = 0.0;
+    std::vector<tiling::Tile> tiles;
+    std::vector<double> scales;  // Per tile resize ratio before detection (empty: 1.0)
+    std::vector<std::vector<DeepXOCR::TextBox>> boxes;  // Per tile, page coordinates (one writer each)
+    std::atomic<size_t> remaining{0};
+    std::chrono::high_resolution_clock::time_point start;
+};
+
+/**
+ * @brief Source images of one mosaic canvas and where they were placed
+ */
+struct MosaicDetectionJob {
+    std::vector<MosaicItem> items;
+    std::vector<cv::Rect> placements;
+};
+
 void DetectorConfig::Show() const {
     LOG_INFO("DetectorConfig:");
     LOG_INFO("  thresh={:.2f}, boxThresh={:.2f}, unclipRatio={:.2f}",
              thresh, boxThresh, unclipRatio);
+    LOG_INFO("  maxCandidates={}, quantizedBoxScore={}, componentBoxScore={}, postprocessWorkers={}",
+             maxCandidates, quantizedBoxScore, componentBoxScore, postprocessWorkers);
+    LOG_INFO("  rectUnclip={}", rectUnclip);
+    LOG_INFO("  sizeThreshold={}, adaptiveResolution={}, minStrokePx={:.1f}, strokePercentile={:.2f}",
+             sizeThreshold, adaptiveResolution, minStrokePx, strokePercentile);
+    LOG_INFO("  probMapCacheSize={}", probMapCacheSize);
+    LOG_INFO("  useTiling={}, tileSize={}, tileOverlap={}, tileMinDownscale={:.1f}, maxTiles={}, maxTilesInFlight={}",
+             useTiling, tileSize, tileOverlap, tileMinDownscale, maxTiles, maxTilesInFlight);
     LOG_INFO("  model640={}", model640Path);
     LOG_INFO("  model960={}", model960Path);
 }
 
+void DetectionResolutionStats::add(const DetectionResolutionStats& other) {
+    if (policy.empty()) {
+        policy = other.policy;
+    } else if (!other.policy.empty() && other.policy != policy) {
+        policy = "mixed";
+    }
+    model640 += other.model640;
+    model960 += other.model960;
+    estimated += other.estimated;
+    fallback += other.fallback;
+    downgraded += other.downgraded;
+    upgraded += other.upgraded;
+    estimateTimeMs += other.estimateTimeMs;
+}
+
+void DetectionResolutionStats::Show() const {
+    LOG_INFO("Detection resolution: policy={}", policy);
+    LOG_INFO("  det_640={} ({:.1f}%), det_960={}", model640, share640() * 100.0, model960);
+    LOG_INFO("  estimated={} (downgraded to 640={}, upgraded to 960={}), fallback={}, estimate time={:.1f}ms",
+             estimated, downgraded, upgraded, fallback, estimateTimeMs);
+}
+
 TextDetector::TextDetector(const DetectorConfig& config)
     : config_(config) {
+    // Postprocessor and prob map cache need no models (usable before init(), e.g. in tests)
+    postprocessor_ = std::make_unique<DBPostProcessor>(
+        config_.thresh,
+        config_.boxThresh,
+        config_.maxCandidates,
+        config_.unclipRatio,
+        config_.quantizedBoxScore,
+        config_.componentBoxScore,
+        config_.postprocessWorkers,
+        config_.rectUnclip
+    );
+    if (config_.probMapCacheSize > 0) {
+        probMapCache_ = std::make_unique<StripedLruCache<cv::Mat>>(config_.probMapCacheSize, 4);
+    }
 }
 
 TextDetector::~TextDetector() {
@@ -35,14 +109,6 @@ bool TextDetector::init() {
         return true;
     }
 
-    // Create postprocessor
-    postprocessor_ = std::make_unique<DBPostProcessor>(
-        config_.thresh,
-        config_.boxThresh,
-        config_.maxCandidates,
-        config_.unclipRatio
-    );
-
     // Load models
     try {
         LOG_INFO("Loading detection models...");
@@ -55,6 +121,7 @@ bool TextDetector::init() {
         if (!config_.model640Path.empty()) {
             model640_ = std::make_unique<dxrt::InferenceEngine>(config_.model640Path);
             model640_->RegisterCallback(cb);
+            inputPool640_ = BufferPool::create(640, 640, CV_8UC3, kInputPoolIdle);
             LOG_INFO("Loaded det_640 model: {}", config_.model640Path);
         }
         
@@ -62,6 +129,7 @@ bool TextDetector::init() {
         if (!config_.model960Path.empty()) {
             model960_ = std::make_unique<dxrt::InferenceEngine>(config_.model960Path);
             model960_->RegisterCallback(cb);
+            inputPool960_ = BufferPool::create(960, 960, CV_8UC3, kInputPoolIdle);
             LOG_INFO("Loaded det_960 model: {}", config_.model960Path);
         }
 
@@ -94,25 +162,35 @@ std::vector<DeepXOCR::TextBox> TextDetector::detect(const cv::Mat& image) {
     int orig_h = image.rows;
     int orig_w = image.cols;
 
-    // Select model based on image size
-    auto* engine = selectModel(orig_h, orig_w);
+    // Determine target size and the matching model
+    int target_size = chooseTargetSize(image);
+    auto* engine = modelForSize(target_size);
     if (!engine) {
         LOG_ERROR("No suitable model for image size {}x{}", orig_h, orig_w);
         return {};
     }
 
-    // Determine target size
-    int target_size = getTargetSize(orig_h, orig_w);
-
     // === Stage 1: Preprocessing ===
     auto t1 = std::chrono::high_resolution_clock::now();
-    int resized_h, resized_w;
-    cv::Mat preprocessed = preprocess(image, target_size, resized_h, resized_w);
+    int resized_h = std::max(orig_h, orig_w);  // Padded square (see preprocess)
+    int resized_w = resized_h;
+    uint64_t key = probMapKey(image, target_size);
+    cv::Mat pred;
+    bool cached = key != 0 && lookupProbMap(key, pred);
+    cv::Mat preprocessed;
+    if (!cached) {
+        preprocess(image, target_size, resized_h, resized_w, preprocessed);
+    }
     auto t2 = std::chrono::high_resolution_clock::now();
     double preprocess_time = std::chrono::duration<double, std::milli>(t2 - t1).count();
 
-    // === Stage 2: Model Inference ===
-    cv::Mat pred = runInference(engine, preprocessed);
+    // === Stage 2: Model Inference (skipped when the probability map is cached) ===
+    if (!cached) {
+        pred = runInference(engine, preprocessed);
+        if (key != 0 && !pred.empty()) {
+            storeProbMap(key, pred);
+        }
+    }
     auto t3 = std::chrono::high_resolution_clock::now();
     double inference_time = std::chrono::duration<double, std::milli>(t3 - t2).count();
     
@@ -172,101 +250,171 @@ dxrt::InferenceEngine* TextDetector::selectModel(int height, int width) {
     return nullptr;
 }
 
-cv::Mat TextDetector::preprocess(const cv::Mat& image, int target_size,
-                                 int& resized_h, int& resized_w) {
+dxrt::InferenceEngine* TextDetector::modelForSize(int target_size) {
+    if (target_size == 640 && model640_) {
+        return model640_.get();
+    }
+    if (target_size == 960 && model960_) {
+        return model960_.get();
+    }
+    return model960_ ? model960_.get() : model640_.get();
+}
+
+int TextDetector::chooseTargetSize(const cv::Mat& image) {
+    int bySize = getTargetSize(image.rows, image.cols);
+    int chosen = bySize;
+
+    // Only a choice when both models are loaded
+    if (config_.adaptiveResolution && model640_ && model960_) {
+        auto t_start = std::chrono::high_resolution_clock::now();
+        TextScaleEstimate estimate = estimateTextScale(image, 960, config_.strokePercentile);
+        auto t_end = std::chrono::high_resolution_clock::now();
+        estimateTimeUs_ += static_cast<uint64_t>(
+            std::chrono::duration<double, std::micro>(t_end - t_start).count());
+
+        if (estimate.valid) {
+            // Stroke width after the padded-square resize to 640
+            float strokeAt640 = estimate.strokeWidth * 640.0f / std::max(image.rows, image.cols);
+            chosen = (strokeAt640 >= config_.minStrokePx) ? 640 : 960;
+            resolutionEstimated_++;
+            if (chosen < bySize) {
+                resolutionDowngraded_++;
+            } else if (chosen > bySize) {
+                resolutionUpgraded_++;
+            }
+            LOG_DEBUG("Text scale: stroke={:.1f}px ({} runs), {:.1f}px at 640 -> det_{} (size rule: det_{})",
+                      estimate.strokeWidth, estimate.runs, strokeAt640, chosen, bySize);
+        } else {
+            resolutionFallback_++;
+        }
+    }
+
+    (chosen == 640 ? resolution640_ : resolution960_)++;
+    return chosen;
+}
+
+DetectionResolutionStats TextDetector::getResolutionStats() const {
+    DetectionResolutionStats stats;
+    stats.policy = config_.adaptiveResolution ? "text-scale" : "max-side";
+    stats.model640 = resolution640_.load();
+    stats.model960 = resolution960_.load();
+    stats.estimated = resolutionEstimated_.load();
+    stats.fallback = resolutionFallback_.load();
+    stats.downgraded = resolutionDowngraded_.load();
+    stats.upgraded = resolutionUpgraded_.load();
+    stats.estimateTimeMs = estimateTimeUs_.load() / 1000.0;
+    return stats;
+}
+
+void TextDetector::preprocess(const cv::Mat& image, int target_size,
+                              int& resized_h, int& resized_w, cv::Mat& final_image) {
     // PPOCR preprocessing: Pad first to square ratio, then resize
     // This is critical for correct coordinate mapping!
+    //
+    // Fused implementation: the padded square is never materialized. The real
+    // image area is resized straight into the top-left of the target buffer
+    // with the same scale (target_size / padded_size) a resize of the padded
+    // square would use, and only the padding strips are filled. Pixels are
+    // identical to pad-then-resize except the one seam row/column where
+    // bilinear sampling used to blend image and padding.
     
     int orig_h = image.rows;
     int orig_w = image.cols;
     
-    // Step 1: Calculate target ratio (square for detection)
-    float target_ratio = 1.0f;  // target_size x target_size is square
-    float orig_ratio = static_cast<float>(orig_w) / orig_h;
+    // Step 1: Padded square size (pad on right or bottom, matching Python's left=0/top=0)
+    int padded_size = std::max(orig_h, orig_w);
+    double scale = static_cast<double>(target_size) / padded_size;
     
-    cv::Mat padded;
-    int pad_h = 0, pad_w = 0;
+    // Same rounding cv::resize applies when given fx/fy instead of dsize
+    int content_w = std::min(target_size, std::max(1, cvRound(orig_w * scale)));
+    int content_h = std::min(target_size, std::max(1, cvRound(orig_h * scale)));
     
     // IMPORTANT: 使用灰色(114,114,114)填充，与Python保持一致
     // 黑色(0,0,0)会导致边缘识别失败
     const cv::Scalar PAD_COLOR(114, 114, 114);
     
-    if (orig_ratio < target_ratio) {
-        // Image is taller than square ratio -> pad width
-        int new_width = static_cast<int>(orig_h * target_ratio);
-        pad_w = new_width - orig_w;
-        // Pad on right (matching Python's left=0, right=pad_width)
-        cv::copyMakeBorder(image, padded, 0, 0, 0, pad_w,
-                          cv::BORDER_CONSTANT, PAD_COLOR);
-    } else if (orig_ratio > target_ratio) {
-        // Image is wider than square ratio -> pad height
-        int new_height = static_cast<int>(orig_w / target_ratio);
-        pad_h = new_height - orig_h;
-        // Pad on bottom (matching Python's top=0, bottom=pad_height)
-        cv::copyMakeBorder(image, padded, 0, pad_h, 0, 0,
-                          cv::BORDER_CONSTANT, PAD_COLOR);
-    } else {
-        // Already square
-        padded = image.clone();
+    // No-op when final_image is already a target-sized buffer (e.g. from the input pool)
+    final_image.create(target_size, target_size, image.type());
+    if (content_w < target_size) {
+        final_image(cv::Rect(content_w, 0, target_size - content_w, target_size)).setTo(PAD_COLOR);
+    }
+    if (content_h < target_size) {
+        final_image(cv::Rect(0, content_h, content_w, target_size - content_h)).setTo(PAD_COLOR);
     }
     
-    // Step 2: Resize the padded image to target_size x target_size
-    cv::Mat final_image;
-    cv::resize(padded, final_image, cv::Size(target_size, target_size));
+    // Step 2: Resize the real image area into the target buffer
+    cv::Mat content = final_image(cv::Rect(0, 0, content_w, content_h));
+    if (content_w == cvRound(orig_w * scale) && content_h == cvRound(orig_h * scale)) {
+        // fx/fy form keeps the exact padded-square sampling grid
+        cv::resize(image, content, cv::Size(), scale, scale);
+    } else {
+        cv::resize(image, content, content.size());
+    }
     
     // Store padded dimensions (before resize) for coordinate mapping
-    resized_h = padded.rows;
-    resized_w = padded.cols;
+    resized_h = padded_size;
+    resized_w = padded_size;
     
     LOG_DEBUG("PPOCR Preprocess: original {}x{} -> padded {}x{} (pad_h={}, pad_w={}) -> resized {}x{}",
-              orig_w, orig_h, padded.cols, padded.rows, pad_h, pad_w, target_size, target_size);
-    
-    return final_image;
+              orig_w, orig_h, padded_size, padded_size, padded_size - orig_h, padded_size - orig_w,
+              target_size, target_size);
 }
 
-cv::Mat TextDetector::preprocessAsync(const cv::Mat& image, int target_size, int& resized_h, int& resized_w) {
-    return preprocess(image, target_size, resized_h, resized_w);
+BufferLease TextDetector::preprocessAsync(const cv::Mat& image, int target_size, int& resized_h, int& resized_w) {
+    const auto& pool = (target_size == 640) ? inputPool640_ : inputPool960_;
+    BufferLease input;
+    if (pool && pool->matches(target_size, target_size, image.type())) {
+        input = pool->acquire();
+    }
+    // Without a matching pool (not initialized, non-BGR input) preprocess allocates a plain buffer
+    preprocess(image, target_size, resized_h, resized_w, input.mat());
+    return input;
 }
 
 void TextDetector::setCallback(DetectionCallback callback) {
     userCallback_ = callback;
 }
 
-int TextDetector::runAsync(const cv::Mat& input, int orig_h, int orig_w, int resized_h, int resized_w, int64_t taskId, const cv::Mat& originalImage, double preprocess_time) {
+int TextDetector::runAsync(BufferLease input, int orig_h, int orig_w, int resized_h, int resized_w, int64_t taskId, FramePtr frame, double preprocess_time) {
     // 使用默认检测参数调用重载版本
-    return runAsync(input, orig_h, orig_w, resized_h, resized_w, taskId, originalImage, preprocess_time,
+    return runAsync(std::move(input), orig_h, orig_w, resized_h, resized_w, taskId, std::move(frame), preprocess_time,
                     config_.thresh, config_.boxThresh, config_.unclipRatio);
 }
 
-int TextDetector::runAsync(const cv::Mat& input, int orig_h, int orig_w, int resized_h, int resized_w, 
-                           int64_t taskId, const cv::Mat& originalImage, double preprocess_time,
-                           float thresh, float boxThresh, float unclipRatio) {
-    auto* engine = selectModel(orig_h, orig_w);
-    if (!engine) return -1;
-
-    if (!input.isContinuous()) {
+int TextDetector::runAsync(BufferLease input, int orig_h, int orig_w, int resized_h, int resized_w, 
+                           int64_t taskId, FramePtr frame, double preprocess_time,
+                           float thresh, float boxThresh, float unclipRatio,
+                           uint64_t probMapKey) {
+    if (input.empty() || !input.mat().isContinuous()) {
         LOG_ERROR("Async inference requires continuous input memory");
         return -1;
     }
+    
+    // The model follows the preprocessed size (chooseTargetSize may differ from the size rule)
+    auto* engine = modelForSize(input.mat().rows);
+    if (!engine) return -1;
 
-    // Create context - CLONE input and originalImage to ensure they stay valid during async inference
+    // Create context - owns the input buffer until the callback; frame is shared (no deep copy)
     DetectionContext* ctx = new DetectionContext{
         orig_h, orig_w,
         resized_h, resized_w,  // Use the correct padded dimensions for coordinate mapping
         taskId,
-        originalImage.clone(),  // Deep copy to keep image alive
-        input.clone(),          // Deep copy to keep input data alive
+        std::move(frame),       // Shared immutable frame for next stage
+        std::move(input),       // Pooled buffer, returned when ctx is deleted
         preprocess_time,
         thresh,       // Per-task 二值化阈值
         boxThresh,    // Per-task 检测框置信度阈值
-        unclipRatio   // Per-task 检测扩张系数
+        unclipRatio,  // Per-task 检测扩张系数
+        probMapKey,   // 概率图缓存键（0 = 不缓存）
+        nullptr, 0,   // Not a tile
+        nullptr       // Not a mosaic
     };
 
     LOG_DEBUG("runAsync: taskId={}, thresh={:.2f}, boxThresh={:.2f}, unclipRatio={:.2f}",
               taskId, thresh, boxThresh, unclipRatio);
 
-    // Use ctx->inputImage.data to ensure we're using the cloned data
-    engine->RunAsync(ctx->inputImage.data, ctx);
+    // Use ctx->input.data() so the buffer is owned by the context
+    engine->RunAsync(ctx->input.data(), ctx);
     return 0;
 }
 
@@ -274,30 +422,43 @@ int TextDetector::internalCallback(dxrt::TensorPtrs& outputs, void* userArg) {
     DetectionContext* ctx = static_cast<DetectionContext*>(userArg);
     if (!ctx) return -1;
 
-    // Ensure context is deleted
+    // Ensure context is deleted (returns the input buffer to its pool)
     std::unique_ptr<DetectionContext> ctxGuard(ctx);
 
+    // A failed tile contributes no boxes, so the page still completes
+    auto fail = [this, ctx]() {
+        if (ctx->tiledJob) {
+            finishTile(*ctx, {});
+        } else if (ctx->mosaicJob) {
+            finishMosaic(*ctx, {}, 0.0);
+        }
+        return -1;
+    };
+
     if (outputs.empty()) {
         LOG_ERROR("Inference failed: no output tensors");
-        return -1;
+        return fail();
     }
     
     auto& output_tensor = outputs[0];
     if (!output_tensor) {
         LOG_ERROR("Output tensor is null");
-        return -1;
+        return fail();
     }
     
     auto shape = output_tensor->shape();
     if (shape.size() != 4) {
         LOG_ERROR("Unexpected output shape size: {}", shape.size());
-        return -1;
+        return fail();
     }
 
     int out_h = shape[2];
     int out_w = shape[3];
     cv::Mat pred(out_h, out_w, CV_32FC1);
     std::memcpy(pred.data, output_tensor->data(), out_h * out_w * sizeof(float));
+    if (ctx->probMapKey != 0) {
+        storeProbMap(ctx->probMapKey, pred);
+    }
     
     // Postprocess（使用 per-task 参数）
     auto t_start = std::chrono::high_resolution_clock::now();
@@ -309,16 +470,326 @@ int TextDetector::internalCallback(dxrt::TensorPtrs& outputs, void* userArg) {
     LOG_DEBUG("Detection postprocess: taskId={}, thresh={:.2f}, boxThresh={:.2f}, unclipRatio={:.2f}, boxes={}",
               ctx->taskId, ctx->thresh, ctx->boxThresh, ctx->unclipRatio, boxes.size());
 
+    if (ctx->tiledJob) {
+        finishTile(*ctx, std::move(boxes));
+        return 0;
+    }
+    if (ctx->mosaicJob) {
+        finishMosaic(*ctx, boxes, postprocess_time);
+        return 0;
+    }
+
     // Calculate inference time (approximate)
     double inference_time = 0.0; 
 
     if (userCallback_) {
-        userCallback_(boxes, ctx->taskId, ctx->originalImage, ctx->preprocess_time, inference_time, postprocess_time);
+        userCallback_(std::move(boxes), ctx->taskId, std::move(ctx->frame), ctx->preprocess_time, inference_time, postprocess_time);
     }
 
     return 0;
 }
 
+// ==================== Tiled Detection ====================
+
+bool TextDetector::shouldTile(int height, int width) {
+    if (!config_.useTiling || config_.tileSize <= 0) {
+        return false;
+    }
+    int target_size = getTargetSize(height, width);
+    return std::max(height, width) > config_.tileMinDownscale * target_size;
+}
+
+int TextDetector::runTiledAsync(int64_t taskId, FramePtr frame, double preprocess_time,
+                                float thresh, float boxThresh, float unclipRatio) {
+    if (!frame || frame->empty()) {
+        return -1;
+    }
+    const cv::Mat& page = frame->image();
+
+    auto job = std::make_shared<TiledDetectionJob>();
+    job->taskId = taskId;
+    job->preprocess_time = preprocess_time;
+    job->start = std::chrono::high_resolution_clock::now();
+    job->tiles = tiling::planTiles(page.rows, page.cols, config_.tileSize, config_.tileOverlap, config_.maxTiles);
+    job->frame = frame;  // Released by the last tile, after the merge
+
+    if (job->tiles.empty()) {
+        return -1;
+    }
+    LOG_INFO("Tiled detection: taskId={}, page {}x{} -> {} tiles ({}x{})", taskId, page.cols, page.rows,
+             job->tiles.size(), job->tiles[0].rect.width, job->tiles[0].rect.height);
+    return submitTiles(job, thresh, boxThresh, unclipRatio);
+}
+
+int TextDetector::runRegionsAsync(int64_t taskId, FramePtr frame, const std::vector<cv::Rect>& regions,
+                                  double preprocess_time, float thresh, float boxThresh, float unclipRatio,
+                                  const std::vector<double>& scales) {
+    if (!frame || frame->empty() || regions.empty()) {
+        return -1;
+    }
+    if (!scales.empty() && scales.size() != regions.size()) {
+        return -1;
+    }
+    for (double scale : scales) {
+        if (!(scale > 0.0)) {
+            return -1;
+        }
+    }
+    const cv::Rect page(0, 0, frame->cols(), frame->rows());
+
+    auto job = std::make_shared<TiledDetectionJob>();
+    job->taskId = taskId;
+    job->preprocess_time = preprocess_time;
+    job->start = std::chrono::high_resolution_clock::now();
+    for (const auto& region : regions) {
+        if (region.width <= 0 || region.height <= 0 || (region & page).area() != region.area()) {
+            return -1;
+        }
+        // No exclusive area: any two boxes from different regions may be duplicates
+        job->tiles.push_back(tiling::Tile{region, cv::Rect()});
+    }
+    job->scales = scales;
+    job->frame = frame;
+
+    LOG_INFO("Region detection: taskId={}, page {}x{} -> {} regions", taskId, page.width, page.height,
+             job->tiles.size());
+    return submitTiles(job, thresh, boxThresh, unclipRatio);
+}
+
+int TextDetector::submitTiles(const std::shared_ptr<TiledDetectionJob>& job,
+                              float thresh, float boxThresh, float unclipRatio) {
+    // Size each tile is detected at (the rect scaled by its ratio)
+    auto detSize = [&job](size_t i) {
+        const cv::Rect& rect = job->tiles[i].rect;
+        if (job->scales.empty() || job->scales[i] == 1.0) {
+            return rect.size();
+        }
+        return cv::Size(std::max(1, static_cast<int>(std::lround(rect.width * job->scales[i]))),
+                        std::max(1, static_cast<int>(std::lround(rect.height * job->scales[i]))));
+    };
+    for (size_t i = 0; i < job->tiles.size(); i++) {
+        cv::Size size = detSize(i);
+        if (!selectModel(size.height, size.width)) {
+            return -1;
+        }
+    }
+    job->boxes.resize(job->tiles.size());
+    job->remaining = job->tiles.size();
+    FramePtr frame = job->frame;  // Keeps the page alive while the loop reads it
+    const cv::Mat& page = frame->image();
+    const int64_t taskId = job->taskId;
+    const double preprocess_time = job->preprocess_time;
+
+    const int maxInFlight = std::max(1, config_.maxTilesInFlight);
+    for (size_t i = 0; i < job->tiles.size(); i++) {
+        {
+            std::unique_lock<std::mutex> lock(tileMutex_);
+            tileCv_.wait(lock, [this, maxInFlight]() { return tilesInFlight_ < maxInFlight; });
+            tilesInFlight_++;
+        }
+
+        // The tile is a view into the decoded page, resized straight into a pooled input buffer
+        const cv::Rect& rect = job->tiles[i].rect;
+        cv::Size size = detSize(i);
+        cv::Mat tile = page(rect);
+        if (size != rect.size()) {
+            cv::resize(page(rect), tile, size, 0, 0, size.area() < rect.area() ? cv::INTER_AREA : cv::INTER_LINEAR);
+            frame->recordCopy(tile.total() * tile.elemSize());
+        }
+        int target_size = getTargetSize(size.height, size.width);
+        int resized_h, resized_w;
+        BufferLease input = preprocessAsync(tile, target_size, resized_h, resized_w);
+        if (size != rect.size()) {
+            // The prob map covers the scaled tile's padded square: map it through the rect's padded square
+            resized_h = resized_w = std::max(rect.height, rect.width);
+        }
+
+        DetectionContext* ctx = new DetectionContext{
+            rect.height, rect.width,
+            resized_h, resized_w,
+            taskId,
+            nullptr,            // The page frame travels with the job
+            std::move(input),
+            preprocess_time,
+            thresh, boxThresh, unclipRatio,
+            0,                  // Tiles are not cached
+            job, i,
+            nullptr
+        };
+        selectModel(size.height, size.width)->RunAsync(ctx->input.data(), ctx);
+    }
+    return 0;
+}
+
+void TextDetector::finishTile(DetectionContext& ctx, std::vector<DeepXOCR::TextBox> boxes) {
+    auto job = ctx.tiledJob;
+    const cv::Rect& rect = job->tiles[ctx.tileIndex].rect;
+    for (auto& box : boxes) {
+        for (auto& point : box.points) {
+            point.x += rect.x;
+            point.y += rect.y;
+        }
+    }
+    job->boxes[ctx.tileIndex] = std::move(boxes);
+
+    {
+        std::lock_guard<std::mutex> lock(tileMutex_);
+        tilesInFlight_--;
+    }
+    tileCv_.notify_all();
+
+    if (job->remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    // Last tile of the page: merge duplicates in the overlaps and report once
+    auto t_start = std::chrono::high_resolution_clock::now();
+    size_t raw = 0;
+    for (const auto& tileBoxes : job->boxes) {
+        raw += tileBoxes.size();
+    }
+    auto merged = tiling::mergeTileBoxes(job->boxes, job->tiles);
+    auto t_end = std::chrono::high_resolution_clock::now();
+    double merge_time = std::chrono::duration<double, std::milli>(t_end - t_start).count();
+    double total_time = std::chrono::duration<double, std::milli>(t_end - job->start).count();
+
+    LOG_INFO("Tiled detection done: taskId={}, tiles={}, boxes {} -> {} | Merge: {:.2f}ms | Total: {:.2f}ms",
+             job->taskId, job->tiles.size(), raw, merged.size(), merge_time, total_time);
+
+    if (userCallback_) {
+        userCallback_(std::move(merged), job->taskId, std::move(job->frame), job->preprocess_time, 0.0, merge_time);
+    }
+}
+
+// ==================== Mosaic Detection ====================
+
+int TextDetector::mosaicCanvasSize() const {
+    return model640_ ? 640 : 960;
+}
+
+int TextDetector::runMosaicAsync(const std::vector<MosaicItem>& items, const std::vector<cv::Rect>& placements,
+                                 double preprocess_time, float thresh, float boxThresh, float unclipRatio) {
+    int canvas_size = mosaicCanvasSize();
+    auto* engine = (canvas_size == 640) ? model640_.get() : model960_.get();
+    if (!engine || items.empty() || items.size() != placements.size()) {
+        return -1;
+    }
+
+    const auto& pool = (canvas_size == 640) ? inputPool640_ : inputPool960_;
+    BufferLease input;
+    if (pool && pool->matches(canvas_size, canvas_size, CV_8UC3)) {
+        input = pool->acquire();
+    }
+    cv::Mat& canvas = input.mat();
+    canvas.create(canvas_size, canvas_size, CV_8UC3);
+    canvas.setTo(cv::Scalar(114, 114, 114));  // Same padding colour as preprocess
+    
+    for (size_t i = 0; i < items.size(); i++) {
+        const cv::Mat& image = items[i].frame->image();
+        const cv::Rect& rect = placements[i];
+        if (image.type() != CV_8UC3 || image.cols != rect.width || image.rows != rect.height ||
+            rect.x < 0 || rect.y < 0 || rect.x + rect.width > canvas_size || rect.y + rect.height > canvas_size) {
+            LOG_ERROR("Mosaic item {} does not match its placement", items[i].taskId);
+            return -1;
+        }
+        image.copyTo(canvas(rect));
+        items[i].frame->recordCopy(image.total() * image.elemSize());
+    }
+
+    auto job = std::make_shared<MosaicDetectionJob>();
+    job->items = items;
+    job->placements = placements;
+
+    // Canvas is already model-sized: orig = padded = canvas, boxes come back at scale 1
+    DetectionContext* ctx = new DetectionContext{
+        canvas_size, canvas_size,
+        canvas_size, canvas_size,
+        items[0].taskId,
+        nullptr,            // Source frames travel with the job
+        std::move(input),
+        preprocess_time,
+        thresh, boxThresh, unclipRatio,
+        0,                  // Mosaics are not cached
+        nullptr, 0,
+        std::move(job)
+    };
+
+    LOG_DEBUG("runMosaicAsync: {} images on a {} canvas, first taskId={}", items.size(), canvas_size, items[0].taskId);
+    engine->RunAsync(ctx->input.data(), ctx);
+    return 0;
+}
+
+void TextDetector::finishMosaic(DetectionContext& ctx, const std::vector<DeepXOCR::TextBox>& boxes,
+                                double postprocess_time) {
+    auto& job = *ctx.mosaicJob;
+    auto split = mosaic::splitBoxes(boxes, job.placements);
+
+    LOG_INFO("Mosaic detection done: {} images, {} boxes", job.items.size(), boxes.size());
+
+    if (userCallback_) {
+        for (size_t i = 0; i < job.items.size(); i++) {
+            userCallback_(std::move(split[i]), job.items[i].taskId, std::move(job.items[i].frame),
+                          ctx.preprocess_time, 0.0, postprocess_time);
+        }
+    }
+}
+
+// ==================== Probability Map Cache ====================
+
+uint64_t TextDetector::probMapKey(const cv::Mat& image, int target_size) const {
+    if (!probMapCache_ || image.empty()) {
+        return 0;
+    }
+    // Different model sizes produce different maps for the same pixels
+    uint64_t key = hashMat(image, static_cast<uint64_t>(target_size));
+    return key != 0 ? key : 1;
+}
+
+bool TextDetector::lookupProbMap(uint64_t key, cv::Mat& pred) {
+    cv::Mat quantized;
+    if (!probMapCache_ || !probMapCache_->get(key, quantized)) {
+        return false;
+    }
+    quantized.convertTo(pred, CV_32FC1, 1.0 / 255.0);
+    return true;
+}
+
+void TextDetector::storeProbMap(uint64_t key, const cv::Mat& pred) {
+    if (!probMapCache_) {
+        return;
+    }
+    cv::Mat quantized;
+    pred.convertTo(quantized, CV_8UC1, 255.0);  // Saturating round to [0, 255]
+    probMapCache_->put(key, std::move(quantized));
+}
+
+bool TextDetector::runCached(uint64_t key, int orig_h, int orig_w, int64_t taskId, FramePtr frame,
+                             double preprocess_time, float thresh, float boxThresh, float unclipRatio) {
+    cv::Mat pred;
+    if (key == 0 || !lookupProbMap(key, pred)) {
+        return false;
+    }
+
+    // Same coordinate mapping as the inference path: padded square of the original image
+    int padded = std::max(orig_h, orig_w);
+    auto t_start = std::chrono::high_resolution_clock::now();
+    auto boxes = postprocessor_->process(pred, orig_h, orig_w, padded, padded, thresh, boxThresh, unclipRatio);
+    auto t_end = std::chrono::high_resolution_clock::now();
+    double postprocess_time = std::chrono::duration<double, std::milli>(t_end - t_start).count();
+
+    LOG_DEBUG("Detection prob map cache hit: taskId={}, thresh={:.2f}, boxThresh={:.2f}, unclipRatio={:.2f}, boxes={}",
+              taskId, thresh, boxThresh, unclipRatio, boxes.size());
+
+    if (userCallback_) {
+        userCallback_(std::move(boxes), taskId, std::move(frame), preprocess_time, 0.0, postprocess_time);
+    }
+    return true;
+}
+
+StripedLruCache<cv::Mat>::Stats TextDetector::getProbMapCacheStats() const {
+    return probMapCache_ ? probMapCache_->stats() : StripedLruCache<cv::Mat>::Stats{};
+}
+
 cv::Mat TextDetector::runInference(dxrt::InferenceEngine* engine, const cv::Mat& input) {    
     // Ensure contiguous memory: avoid cloning when not necessary
     const uint8_t* input_ptr = nullptr;
@@ -0,0 +1,89 @@
+#include "detection/text_scale.h"
+#include <algorithm>
+#include <vector>
+
+namespace ocr {
+
+namespace {
+
+// 累加 bin 中每行的前景游程长度（忽略超过 maxRun 的游程）
+void accumulateRuns(const cv::Mat& bin, int maxRun, std::vector<int>& histogram) {
+    for (int y = 0; y < bin.rows; y++) {
+        const uint8_t* row = bin.ptr<uint8_t>(y);
+        int run = 0;
+        for (int x = 0; x <= bin.cols; x++) {
+            if (x < bin.cols && row[x]) {
+                run++;
+            } else if (run > 0) {
+                if (run <= maxRun) {
+                    histogram[run]++;
+                }
+                run = 0;
+            }
+        }
+    }
+}
+
+} // namespace
+
+TextScaleEstimate estimateTextScale(const cv::Mat& image, int maxThumbSide, float percentile, int minRuns) {
+    TextScaleEstimate estimate;
+    if (image.empty() || maxThumbSide <= 0) {
+        return estimate;
+    }
+
+    // 1. 缩略图（不放大）+ 灰度
+    int maxSide = std::max(image.rows, image.cols);
+    double scale = std::min(1.0, static_cast<double>(maxThumbSide) / maxSide);
+    cv::Mat thumb = image;
+    if (scale < 1.0) {
+        cv::resize(image, thumb, cv::Size(), scale, scale, cv::INTER_AREA);
+    }
+    cv::Mat gray;
+    if (thumb.channels() == 3) {
+        cv::cvtColor(thumb, gray, cv::COLOR_BGR2GRAY);
+    } else if (thumb.channels() == 4) {
+        cv::cvtColor(thumb, gray, cv::COLOR_BGRA2GRAY);
+    } else {
+        gray = thumb;
+    }
+
+    // 2. Otsu 二值化，墨迹（前景）取像素较少的一类
+    cv::Mat bin;
+    cv::threshold(gray, bin, 0, 255, cv::THRESH_BINARY_INV | cv::THRESH_OTSU);
+    if (cv::countNonZero(bin) * 2 > bin.rows * bin.cols) {
+        cv::bitwise_not(bin, bin);
+    }
+
+    // 3. 水平 + 垂直游程直方图
+    int maxRun = std::max(2, std::max(bin.rows, bin.cols) / 8);
+    std::vector<int> histogram(maxRun + 1, 0);
+    accumulateRuns(bin, maxRun, histogram);
+    accumulateRuns(bin.t(), maxRun, histogram);
+
+    int total = 0;
+    for (int count : histogram) {
+        total += count;
+    }
+    estimate.runs = total;
+    if (total < std::max(1, minRuns)) {
+        return estimate;
+    }
+
+    // 4. 分位数 → 原图像素
+    int target = std::max(1, static_cast<int>(total * std::clamp(percentile, 0.01f, 1.0f)));
+    int seen = 0;
+    int strokeRun = maxRun;
+    for (int run = 1; run <= maxRun; run++) {
+        seen += histogram[run];
+        if (seen >= target) {
+            strokeRun = run;
+            break;
+        }
+    }
+    estimate.strokeWidth = static_cast<float>(strokeRun / scale);
+    estimate.valid = true;
+    return estimate;
+}
+
+} // namespace ocr
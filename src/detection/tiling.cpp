@@ -0,0 +1,210 @@
+#include "detection/tiling.h"
+#include "common/geometry.h"
+#include <algorithm>
+#include <numeric>
+
+namespace ocr {
+namespace tiling {
+
+namespace {
+
+/**
+ * @brief 一个方向上各分块的起点：首块从 0 开始，末块与边缘对齐，中间均匀分布
+ *
+ * 块数取满足 n * side - (n - 1) * overlap >= length 的最小 n，均匀分布后的间距不大于
+ * side - overlap，因此相邻分块的重叠不小于 overlap。
+ */
+std::vector<int> axisStarts(int length, int side, int overlap) {
+    if (length <= side) {
+        return {0};
+    }
+    int step = side - overlap;
+    int count = (length - overlap + step - 1) / step;
+    std::vector<int> starts(count);
+    for (int i = 0; i < count; i++) {
+        starts[i] = static_cast<int>(static_cast<int64_t>(length - side) * i / (count - 1));
+    }
+    return starts;
+}
+
+struct Bounds {
+    float x0, y0, x1, y1;
+
+    float width() const { return x1 - x0; }
+    float height() const { return y1 - y0; }
+    float area() const { return width() * height(); }
+};
+
+Bounds boundsOf(const DeepXOCR::TextBox& box) {
+    Bounds b{box.points[0].x, box.points[0].y, box.points[0].x, box.points[0].y};
+    for (int i = 1; i < 4; i++) {
+        b.x0 = std::min(b.x0, box.points[i].x);
+        b.y0 = std::min(b.y0, box.points[i].y);
+        b.x1 = std::max(b.x1, box.points[i].x);
+        b.y1 = std::max(b.y1, box.points[i].y);
+    }
+    return b;
+}
+
+bool insideRect(const Bounds& b, const cv::Rect& rect) {
+    return b.x0 >= rect.x && b.y0 >= rect.y &&
+           b.x1 <= rect.x + rect.width && b.y1 <= rect.y + rect.height;
+}
+
+/**
+ * @brief 两个来自不同分块的框是否为同一段文本（重复检测或被分块边界截断）
+ */
+bool sameText(const Bounds& a, const Bounds& b) {
+    float ix = std::min(a.x1, b.x1) - std::max(a.x0, b.x0);
+    float iy = std::min(a.y1, b.y1) - std::max(a.y0, b.y0);
+    if (ix <= 0.0f || iy <= 0.0f) {
+        return false;
+    }
+    float minArea = std::min(a.area(), b.area());
+    if (minArea > 0.0f && ix * iy >= 0.5f * minArea) {
+        return true;
+    }
+    // 截断的文本行：方向相同，行高方向上大部分重叠（上下相邻的两行只在边缘接触，不合并）
+    bool aHorizontal = a.width() >= a.height();
+    bool bHorizontal = b.width() >= b.height();
+    if (aHorizontal != bHorizontal) {
+        return false;
+    }
+    if (aHorizontal) {
+        return iy >= 0.5f * std::min(a.height(), b.height());
+    }
+    return ix >= 0.5f * std::min(a.width(), b.width());
+}
+
+size_t findRoot(std::vector<size_t>& parent, size_t i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+} // namespace
+
+std::vector<Tile> planTiles(int height, int width, int tileSize, int overlap, int maxTiles) {
+    std::vector<Tile> tiles;
+    if (height <= 0 || width <= 0 || tileSize <= 0) {
+        return tiles;
+    }
+    overlap = std::clamp(overlap, 0, tileSize / 2);
+
+    // 块数超过上限时放大分块（每次 1.25 倍），直到整页只剩一块为止
+    double scale = 1.0;
+    int side = tileSize;
+    std::vector<int> xs, ys;
+    while (true) {
+        side = static_cast<int>(tileSize * scale + 0.5);
+        int scaledOverlap = static_cast<int>(overlap * scale + 0.5);
+        xs = axisStarts(width, side, scaledOverlap);
+        ys = axisStarts(height, side, scaledOverlap);
+        if (maxTiles <= 0 || static_cast<int>(xs.size() * ys.size()) <= maxTiles ||
+            (xs.size() == 1 && ys.size() == 1)) {
+            break;
+        }
+        scale *= 1.25;
+    }
+
+    // 独占区域：夹在前一块右(下)边缘和后一块左(上)边缘之间的部分
+    auto exclusiveRange = [side](const std::vector<int>& starts, int length, size_t i, int& lo, int& hi) {
+        lo = (i == 0) ? 0 : std::min(starts[i - 1] + side, length);
+        hi = (i + 1 == starts.size()) ? length : starts[i + 1];
+        hi = std::max(hi, lo);
+    };
+
+    tiles.reserve(xs.size() * ys.size());
+    for (size_t r = 0; r < ys.size(); r++) {
+        int y0, y1;
+        exclusiveRange(ys, height, r, y0, y1);
+        for (size_t c = 0; c < xs.size(); c++) {
+            int x0, x1;
+            exclusiveRange(xs, width, c, x0, x1);
+            Tile tile;
+            tile.rect = cv::Rect(xs[c], ys[r], std::min(side, width - xs[c]), std::min(side, height - ys[r]));
+            tile.exclusive = cv::Rect(x0, y0, x1 - x0, y1 - y0);
+            tiles.push_back(tile);
+        }
+    }
+    return tiles;
+}
+
+std::vector<DeepXOCR::TextBox> mergeTileBoxes(const std::vector<std::vector<DeepXOCR::TextBox>>& tileBoxes,
+                                              const std::vector<Tile>& tiles) {
+    // 展平，记录每个框所属的分块
+    std::vector<const DeepXOCR::TextBox*> boxes;
+    std::vector<size_t> owner;
+    std::vector<Bounds> bounds;
+    for (size_t t = 0; t < tileBoxes.size(); t++) {
+        for (const auto& box : tileBoxes[t]) {
+            boxes.push_back(&box);
+            owner.push_back(t);
+            bounds.push_back(boundsOf(box));
+        }
+    }
+
+    // 只有伸入重叠带的框才可能与其他分块的框重复
+    std::vector<size_t> candidates;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        if (owner[i] >= tiles.size() || !insideRect(bounds[i], tiles[owner[i]].exclusive)) {
+            candidates.push_back(i);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [&bounds](size_t a, size_t b) {
+        return bounds[a].x0 < bounds[b].x0;
+    });
+
+    // 按 x 扫描，只比较横向相交的候选框
+    std::vector<size_t> parent(boxes.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    for (size_t i = 0; i < candidates.size(); i++) {
+        const Bounds& a = bounds[candidates[i]];
+        for (size_t j = i + 1; j < candidates.size() && bounds[candidates[j]].x0 < a.x1; j++) {
+            if (owner[candidates[i]] != owner[candidates[j]] && sameText(a, bounds[candidates[j]])) {
+                size_t ra = findRoot(parent, candidates[i]);
+                size_t rb = findRoot(parent, candidates[j]);
+                if (ra != rb) {
+                    parent[std::max(ra, rb)] = std::min(ra, rb);
+                }
+            }
+        }
+    }
+
+    // 按组输出（组内第一个框的位置），多于一个框的组取所有顶点的最小外接矩形
+    std::vector<std::vector<size_t>> groups(boxes.size());
+    for (size_t i = 0; i < boxes.size(); i++) {
+        groups[findRoot(parent, i)].push_back(i);
+    }
+
+    std::vector<DeepXOCR::TextBox> merged;
+    merged.reserve(boxes.size());
+    for (const auto& group : groups) {
+        if (group.empty()) {
+            continue;
+        }
+        if (group.size() == 1) {
+            merged.push_back(*boxes[group[0]]);
+            continue;
+        }
+        std::vector<cv::Point2f> points;
+        DeepXOCR::TextBox box;
+        for (size_t i : group) {
+            points.insert(points.end(), boxes[i]->points, boxes[i]->points + 4);
+            box.confidence = std::max(box.confidence, boxes[i]->confidence);
+        }
+        cv::Point2f vertices[4];
+        cv::minAreaRect(points).points(vertices);
+        auto ordered = Geometry::orderPointsClockwise(std::vector<cv::Point2f>(vertices, vertices + 4));
+        for (int k = 0; k < 4; k++) {
+            box.points[k] = ordered[k];
+        }
+        merged.push_back(box);
+    }
+    return merged;
+}
+
+} // namespace tiling
+} // namespace ocr
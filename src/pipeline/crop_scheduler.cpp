@@ -0,0 +1,242 @@
+#include "pipeline/crop_scheduler.h"
+#include "common/logger.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace ocr {
+
+void CropSchedulerConfig::Show() const {
+    LOG_INFO("CropSchedulerConfig:");
+    LOG_INFO("  maxInFlight={}, maxRunLength={}", maxInFlight, maxRunLength);
+}
+
+void CropSchedulerStats::Show() const {
+    LOG_INFO("CropScheduler: policy={}", policy);
+    LOG_INFO("  queued={} crops ({} tasks), inFlight={}", queued, tasks, inFlight);
+    for (const auto& [engine, depth] : queueDepth) {
+        LOG_INFO("  tier{}/ratio_{} queue: {} jobs", engine / 1000, engine % 1000, depth);
+    }
+    LOG_INFO("  submitted={} jobs in {} runs (avg run {:.1f}), engine switches={}",
+             submitted, runs, avgRunLength(), engineSwitches);
+}
+
+CropScheduler::CropScheduler(const CropSchedulerConfig& config)
+    : config_(config) {
+    config_.maxInFlight = std::max<size_t>(config_.maxInFlight, 1);
+    config_.maxRunLength = std::max<size_t>(config_.maxRunLength, 1);
+}
+
+CropScheduler::~CropScheduler() {
+    stop();
+}
+
+void CropScheduler::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(&CropScheduler::dispatchLoop, this);
+}
+
+void CropScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    // 排队中的 job 的 crop 上下文由 job 持有，不能直接丢弃：取出后在锁外逐个结束
+    std::map<int64_t, TaskQueue> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queued_ > 0) {
+            LOG_WARN("CropScheduler stopped with {} queued crops, cancelling them", queued_);
+        }
+        pending.swap(tasks_);
+        queueDepth_.clear();
+        queued_ = 0;
+        inFlight_ = 0;
+    }
+    for (auto& [taskId, task] : pending) {
+        for (auto& [engine, queue] : task.byEngine) {
+            for (auto& job : queue) {
+                if (job.cancel) {
+                    job.cancel();
+                } else if (job.submit) {
+                    job.submit();
+                }
+            }
+        }
+    }
+}
+
+void CropScheduler::enqueue(CropJob job) {
+    job.weight = std::max<size_t>(job.weight, 1);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int engine = engineKey(job.tier, job.ratio);
+        queued_ += job.weight;
+        queueDepth_[engine]++;
+
+        TaskQueue& task = tasks_[job.taskId];
+        task.queued += job.weight;
+        if (job.remaining) {
+            task.remaining = job.remaining;
+        }
+        // 插入到同长度 job 之后，保持按 length 降序且稳定
+        auto& queue = task.byEngine[engine];
+        auto pos = std::upper_bound(queue.begin(), queue.end(), job.length,
+                                    [](int length, const CropJob& other) { return length > other.length; });
+        queue.insert(pos, std::move(job));
+    }
+    cv_.notify_one();
+}
+
+void CropScheduler::complete(size_t crops) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        inFlight_ -= std::min(crops, inFlight_);
+    }
+    cv_.notify_one();
+}
+
+bool CropScheduler::hasBudget(const CropJob& job, size_t inFlight) const {
+    // 比额度还大的 job（拼接批次）在没有在途 crop 时也允许提交，避免饿死
+    return inFlight + job.weight <= config_.maxInFlight || inFlight == 0;
+}
+
+void CropScheduler::takeFrom(TaskQueue& task, int engine, std::deque<CropJob>& run, size_t& inFlight) {
+    auto it = task.byEngine.find(engine);
+    if (it == task.byEngine.end()) {
+        return;
+    }
+    auto& queue = it->second;
+    while (!queue.empty() && run.size() < config_.maxRunLength && hasBudget(queue.front(), inFlight)) {
+        CropJob& job = queue.front();
+        inFlight += job.weight;
+        task.queued -= job.weight;
+        queued_ -= job.weight;
+        queueDepth_[engine]--;
+        run.push_back(std::move(job));
+        queue.pop_front();
+    }
+    if (queue.empty()) {
+        task.byEngine.erase(it);
+    }
+}
+
+size_t CropScheduler::dispatchOnce() {
+    std::deque<CropJob> run;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (tasks_.empty()) {
+            return 0;
+        }
+
+        // 1. 剩余 crop 最少的任务（相同时先到的任务，即 taskId 较小者）
+        //    剩余数在锁外由完成回调递减，排序前取一次快照，保证比较的一致性
+        std::vector<std::pair<size_t, std::map<int64_t, TaskQueue>::iterator>> ranked;
+        ranked.reserve(tasks_.size());
+        for (auto it = tasks_.begin(); it != tasks_.end(); ++it) {
+            ranked.emplace_back(it->second.priority(), it);
+        }
+        std::stable_sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+        std::vector<std::map<int64_t, TaskQueue>::iterator> order;
+        order.reserve(ranked.size());
+        for (const auto& entry : ranked) {
+            order.push_back(entry.second);
+        }
+        TaskQueue& first = order.front()->second;
+
+        // 2. 该任务中最长 crop 所在的引擎（长度相同时优先沿用上一个引擎）
+        int engine = -1;
+        int longest = -1;
+        for (const auto& [r, queue] : first.byEngine) {
+            int length = queue.front().length;
+            if (length > longest || (length == longest && r == lastEngine_)) {
+                longest = length;
+                engine = r;
+            }
+        }
+
+        size_t inFlight = inFlight_;
+        if (!hasBudget(first.byEngine[engine].front(), inFlight)) {
+            return 0;
+        }
+
+        // 3. 同一引擎上连续提交：先取该任务的，再按任务优先级补满
+        for (auto& it : order) {
+            takeFrom(it->second, engine, run, inFlight);
+            if (run.size() >= config_.maxRunLength) {
+                break;
+            }
+        }
+        for (auto& it : order) {
+            if (it->second.queued == 0) {
+                tasks_.erase(it);
+            }
+        }
+
+        inFlight_ = inFlight;
+        submitted_ += run.size();
+        runs_++;
+        if (lastEngine_ != -1 && lastEngine_ != engine) {
+            engineSwitches_++;
+        }
+        lastEngine_ = engine;
+    }
+
+    // 在锁外提交：识别器可能同步回调 complete()
+    for (auto& job : run) {
+        job.submit();
+    }
+    return run.size();
+}
+
+void CropScheduler::dispatchLoop() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] {
+                return !running_ || (!tasks_.empty() && inFlight_ < config_.maxInFlight);
+            });
+            if (!running_) {
+                return;
+            }
+        }
+        if (dispatchOnce() == 0) {
+            // 队首 job 超出额度：等待 complete() 唤醒
+            std::unique_lock<std::mutex> lock(mutex_);
+            size_t inFlight = inFlight_;
+            cv_.wait(lock, [this, inFlight] { return !running_ || inFlight_ < inFlight || tasks_.empty(); });
+        }
+    }
+}
+
+CropSchedulerStats CropScheduler::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CropSchedulerStats stats;
+    stats.policy = "fewest-remaining-task-first, longest-crop-first, ratio runs <= " +
+                   std::to_string(config_.maxRunLength) + ", inflight <= " +
+                   std::to_string(config_.maxInFlight);
+    stats.queued = queued_;
+    stats.inFlight = inFlight_;
+    stats.tasks = tasks_.size();
+    for (const auto& [engine, depth] : queueDepth_) {
+        if (depth > 0) {
+            stats.queueDepth[engine] = depth;
+        }
+    }
+    stats.submitted = submitted_;
+    stats.runs = runs_;
+    stats.engineSwitches = engineSwitches_;
+    return stats;
+}
+
+} // namespace ocr
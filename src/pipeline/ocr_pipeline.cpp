@@ -2,6 +2,7 @@
 #include "common/visualizer.h"
 #include "common/geometry.h"
 #include "common/logger.hpp"
+#include "detection/mosaic.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
@@ -28,14 +29,63 @@ void OCRPipelineConfig::Show() const {
     }
     LOG_INFO("\nRecognition Config:");
     recognizerConfig.Show();
+    if (useCropScheduler) {
+        LOG_INFO("\nCrop Scheduler Config:");
+        cropSchedulerConfig.Show();
+    }
     LOG_INFO("\nPipeline Config:");
     LOG_INFO("  Use Document Preprocessing: {}", useDocPreprocessing ? "true" : "false");
     LOG_INFO("  Use Classification: {}", useClassification ? "true" : "false");
+    LOG_INFO("  Speculative Recognition: {}", speculativeRecognition ? "true" : "false");
+    LOG_INFO("  Fast Tier: {}", loadFastTier ? "loaded" : "not loaded");
+    LOG_INFO("  Recognition Cascade: {} (threshold={:.2f})", useRecognitionCascade ? "true" : "false",
+             cascadeThreshold);
+    LOG_INFO("  Mosaic Detection: {} (maxSide={}, margin={}, maxImages={}, waitMs={})",
+             useMosaic ? "true" : "false", mosaicMaxSide, mosaicMargin, mosaicMaxImages, mosaicWaitMs);
+    LOG_INFO("  Skip Blank Pages: {} (thumbSide={}, maxStdDev={:.1f}, maxInkRatio={:.5f}, maxEdgeRatio={:.5f})",
+             skipBlankPages ? "true" : "false", blankPageConfig.thumbSide, blankPageConfig.maxStdDev,
+             blankPageConfig.maxInkRatio, blankPageConfig.maxEdgeRatio);
     LOG_INFO("  Enable Visualization: {}", enableVisualization ? "true" : "false");
     LOG_INFO("  Sort Results: {}", sortResults ? "true" : "false");
     LOG_INFO("===============================================");
 }
 
+// ==================== OCRTaskConfig ====================
+
+double OCRTaskConfig::detResizeRatio(int height, int width) const {
+    if (textDetLimitSideLen <= 0 || height <= 0 || width <= 0) {
+        return 1.0;
+    }
+    int maxSide = std::max(height, width);
+    int minSide = std::min(height, width);
+    if (textDetLimitType == DetLimitType::Max) {
+        return maxSide > textDetLimitSideLen ? static_cast<double>(textDetLimitSideLen) / maxSide : 1.0;
+    }
+    if (minSide >= textDetLimitSideLen || maxSide >= kMaxDetUpscaleSide) {
+        return 1.0;
+    }
+    return std::min(static_cast<double>(textDetLimitSideLen) / minSide,
+                    static_cast<double>(kMaxDetUpscaleSide) / maxSide);
+}
+
+std::vector<cv::Rect> OCRTaskConfig::roiRects(int height, int width) const {
+    std::vector<cv::Rect> rects;
+    const cv::Rect page(0, 0, width, height);
+    float sx = roisNormalized ? static_cast<float>(width) : 1.0f;
+    float sy = roisNormalized ? static_cast<float>(height) : 1.0f;
+    for (const auto& roi : rois) {
+        int x0 = static_cast<int>(std::floor(roi.x * sx));
+        int y0 = static_cast<int>(std::floor(roi.y * sy));
+        int x1 = static_cast<int>(std::ceil((roi.x + roi.width) * sx));
+        int y1 = static_cast<int>(std::ceil((roi.y + roi.height) * sy));
+        cv::Rect rect = cv::Rect(x0, y0, x1 - x0, y1 - y0) & page;
+        if (rect.width > 0 && rect.height > 0) {
+            rects.push_back(rect);
+        }
+    }
+    return rects;
+}
+
 // ==================== OCRResult ====================
 
 cv::Rect PipelineOCRResult::getBoundingRect() const {
@@ -136,6 +186,10 @@ OCRPipeline::OCRPipeline(const OCRPipelineConfig& config)
     constexpr size_t STAGE_EXECUTOR_THREADS = 8;  // Similar to Python's max_workers=16
     stageExecutor_ = std::make_unique<ThreadPool>(STAGE_EXECUTOR_THREADS);
     
+    if (config_.useCropScheduler) {
+        cropScheduler_ = std::make_unique<CropScheduler>(config_.cropSchedulerConfig);
+    }
+    
     LOG_INFO("OCRPipeline: Detected {} CPU cores", numCores);
     LOG_INFO("  Detection threads: {}", numDetectionThreads_);
     LOG_INFO("  Recognition threads: {}", numRecognitionThreads_);
@@ -158,12 +212,13 @@ bool OCRPipeline::initialize() {
     
     // Set callback for async mode
     // Detection callback is kept lightweight - it only dispatches to stageExecutor_
-    detector_->setCallback([this](std::vector<DeepXOCR::TextBox> boxes, int64_t taskId, cv::Mat image, double /*pp*/, double /*inf*/, double /*post*/) {
+    // (shared by both model tiers: the task config travels through pendingTaskConfigs_)
+    auto onDetection = [this](std::vector<DeepXOCR::TextBox> boxes, int64_t taskId, FramePtr frame, double /*pp*/, double /*inf*/, double /*post*/) {
         LOG_INFO("Detection callback: taskId={}, boxes={}", taskId, boxes.size());
         
         // Dispatch heavy work (sorting, queue push) to stageExecutor_
         // This avoids blocking DXRT internal callback thread
-        stageExecutor_->dispatch([this, boxes = std::move(boxes), taskId, image]() mutable {
+        stageExecutor_->dispatch([this, boxes = std::move(boxes), taskId, frame = std::move(frame)]() mutable {
             // 从 map 中获取并移除任务配置
             OCRTaskConfig taskConfig;
             {
@@ -177,6 +232,23 @@ bool OCRPipeline::initialize() {
                 }
             }
             
+            // 感兴趣区域：中心不在任何区域内的框不识别
+            if (!taskConfig.rois.empty() && frame) {
+                auto regions = taskConfig.roiRects(frame->rows(), frame->cols());
+                size_t detected = boxes.size();
+                boxes.erase(std::remove_if(boxes.begin(), boxes.end(), [&regions](const DeepXOCR::TextBox& box) {
+                    cv::Point2f center((box.points[0].x + box.points[1].x + box.points[2].x + box.points[3].x) * 0.25f,
+                                       (box.points[0].y + box.points[1].y + box.points[2].y + box.points[3].y) * 0.25f);
+                    return std::none_of(regions.begin(), regions.end(), [&center](const cv::Rect& rect) {
+                        return center.x >= rect.x && center.y >= rect.y &&
+                               center.x < rect.x + rect.width && center.y < rect.y + rect.height;
+                    });
+                }), boxes.end());
+                if (boxes.size() != detected) {
+                    LOG_DEBUG("ROI filter: taskId={}, boxes {} -> {}", taskId, detected, boxes.size());
+                }
+            }
+            
             // Sort Boxes (only if there are boxes to sort)
             if (boxes.size() > 1) {
                 std::sort(boxes.begin(), boxes.end(), [](const DeepXOCR::TextBox& a, const DeepXOCR::TextBox& b) {
@@ -203,7 +275,7 @@ bool OCRPipeline::initialize() {
             // Check both running_ and recQueue_ existence atomically
             if (running_ && recQueue_) {
                 size_t boxCount = boxes.size();
-                RecognitionTask task{image, std::move(boxes), taskId, taskConfig};
+                RecognitionTask task(std::move(frame), std::move(boxes), taskId, taskConfig);
                 // Use try_push with longer timeout to avoid blocking callback threads
                 while (running_ && recQueue_ && !recQueue_->try_push(std::move(task), std::chrono::milliseconds(500))) {
                     LOG_WARN("Recognition queue full, waiting... id={}", taskId);
@@ -215,13 +287,26 @@ bool OCRPipeline::initialize() {
                 LOG_WARN("Pipeline stopping, discarding detection callback for taskId={}", taskId);
             }
         });
-    });
+    };
+    detector_->setCallback(onDetection);
 
     if (!detector_->init()) {
         LOG_ERROR("Failed to initialize TextDetector");
         return false;
     }
     
+    // 初始化 fast 档位检测器（可选，失败时 fast 任务回退到默认模型）
+    if (config_.loadFastTier) {
+        fastDetector_ = std::make_unique<TextDetector>(config_.fastDetectorConfig);
+        fastDetector_->setCallback(onDetection);
+        if (!fastDetector_->init()) {
+            LOG_WARN("Failed to initialize fast tier TextDetector, fast tasks will use the default detector");
+            fastDetector_.reset();
+        } else {
+            LOG_INFO("Fast tier TextDetector initialized");
+        }
+    }
+    
     // 初始化Document Preprocessing Pipeline（统一管理）
     if (config_.useDocPreprocessing) {
         docPreprocessing_ = std::make_unique<DocumentPreprocessingPipeline>(
@@ -264,6 +349,28 @@ bool OCRPipeline::initialize() {
     });
     LOG_INFO("Recognition async callback registered");
     
+    // 初始化 fast 档位识别器（fast 任务和 recognition cascade 使用）
+    if (config_.loadFastTier || config_.useRecognitionCascade) {
+        fastRecognizer_ = std::make_unique<TextRecognizer>(config_.fastRecognizerConfig);
+        if (!fastRecognizer_->Initialize()) {
+            if (config_.useRecognitionCascade) {
+                LOG_ERROR("Failed to initialize cascade (mobile) TextRecognizer");
+                return false;
+            }
+            LOG_WARN("Failed to initialize fast tier TextRecognizer, fast tasks will use the default recognizer");
+            fastRecognizer_.reset();
+        } else {
+            fastRecognizer_->RegisterCallback([this](const std::string& text, float confidence, void* userArg) {
+                this->onRecognitionComplete(text, confidence, userArg);
+            });
+            LOG_INFO("Fast tier TextRecognizer initialized");
+        }
+        if (config_.useRecognitionCascade) {
+            LOG_INFO("Recognition cascade enabled: mobile first, server below confidence {:.2f}",
+                     config_.cascadeThreshold);
+        }
+    }
+    
     initialized_ = true;
     LOG_INFO("✅ OCR Pipeline initialized successfully!\n");
     
@@ -289,6 +396,7 @@ bool OCRPipeline::saveResultsToJSON(const std::vector<PipelineOCRResult>& result
         ofs << "      \"text\": \"" << result.text << "\",\n";
         ofs << "      \"confidence\": " << std::fixed << std::setprecision(4) 
             << result.confidence << ",\n";
+        ofs << "      \"tier\": \"" << recognitionTierName(result.tier) << "\",\n";
         ofs << "      \"box\": [\n";
         
         for (size_t j = 0; j < result.box.size(); ++j) {
@@ -370,6 +478,10 @@ void OCRPipeline::start() {
         LOG_INFO("Started recognition thread {}/{}", i + 1, numRecognitionThreads_);
     }
     
+    if (cropScheduler_) {
+        cropScheduler_->start();
+    }
+    
     LOG_INFO("Async pipeline started: {} detection + {} recognition threads", 
              numDetectionThreads_, numRecognitionThreads_);
 }
@@ -399,6 +511,49 @@ void OCRPipeline::stop() {
     }
     recThreads_.clear();
     
+    if (cropScheduler_) {
+        cropScheduler_->getStats().Show();
+        cropScheduler_->stop();
+    }
+    if (config_.speculativeRecognition) {
+        LOG_INFO("Speculative recognition: {} upright hits, {} rotated re-runs",
+                 speculativeHits_.load(), speculativeMisses_.load());
+    }
+    if (config_.useRecognitionCascade) {
+        LOG_INFO("Recognition cascade: {} mobile results kept, {} escalated to server",
+                 cascadeAccepted_.load(), cascadeEscalated_.load());
+    }
+    if (config_.useMosaic) {
+        LOG_INFO("Mosaic detection: {} images on {} canvases", mosaicImages_.load(), mosaicCanvases_.load());
+    }
+    if (config_.skipBlankPages) {
+        LOG_INFO("Blank page fast path: {} pages skipped", blankPagesSkipped_.load());
+    }
+    for (const TextDetector* detector : {detector_.get(), fastDetector_.get()}) {
+        if (!detector) {
+            continue;
+        }
+        auto cache = detector->getProbMapCacheStats();
+        if (cache.capacity > 0) {
+            LOG_INFO("Detection prob map cache{}: {} hits, {} misses ({:.1f}% hit rate), {}/{} maps",
+                     detector == fastDetector_.get() ? " (fast tier)" : "",
+                     cache.hits, cache.misses, cache.hitRate() * 100.0, cache.entries, cache.capacity);
+        }
+    }
+    getDetectionResolutionStats().Show();
+    for (const TextRecognizer* recognizer : {recognizer_.get(), fastRecognizer_.get()}) {
+        if (!recognizer) {
+            continue;
+        }
+        auto cache = recognizer->GetCacheStats();
+        if (cache.capacity > 0) {
+            LOG_INFO("Recognition cache{}: {} hits, {} misses ({:.1f}% hit rate), {}/{} entries, {} evictions",
+                     recognizer == fastRecognizer_.get() ? " (fast tier)" : "",
+                     cache.hits, cache.misses, cache.hitRate() * 100.0, cache.entries, cache.capacity,
+                     cache.evictions);
+        }
+    }
+    
     if (detQueue_) detQueue_->clear();
     if (recQueue_) recQueue_->clear();
     if (outQueue_) outQueue_->clear();
@@ -412,9 +567,14 @@ bool OCRPipeline::pushTask(const cv::Mat& image, int64_t id) {
 }
 
 bool OCRPipeline::pushTask(const cv::Mat& image, int64_t id, const OCRTaskConfig& config) {
-    if (!running_ || !detQueue_) return false;
+    // 共享调用者的像素缓冲（不拷贝），之后整个 pipeline 只传递这一份帧
+    return pushTask(Frame::share(image), id, config);
+}
+
+bool OCRPipeline::pushTask(FramePtr frame, int64_t id, const OCRTaskConfig& config) {
+    if (!running_ || !detQueue_ || !frame) return false;
     // Use try_push to avoid blocking - return false if queue is full
-    if (!detQueue_->try_push({image, id, config}, std::chrono::milliseconds(100))) {
+    if (!detQueue_->try_push(DetectionTask(std::move(frame), id, config), std::chrono::milliseconds(100))) {
         return false;  // Queue full, caller should retry
     }
     LOG_INFO("Task pushed to detection queue, id={}, config: docOri={}, docUnwarp={}, textlineOri={}, detThresh={:.2f}, boxThresh={:.2f}, unclipRatio={:.2f}, recThresh={:.2f}",
@@ -424,6 +584,50 @@ bool OCRPipeline::pushTask(const cv::Mat& image, int64_t id, const OCRTaskConfig
     return true;
 }
 
+bool OCRPipeline::pushRecognitionTask(const cv::Mat& image, std::vector<TextBox> boxes, int64_t id,
+                                      const OCRTaskConfig& config) {
+    return pushRecognitionTask(Frame::share(image), std::move(boxes), id, config);
+}
+
+bool OCRPipeline::pushRecognitionTask(FramePtr frame, std::vector<TextBox> boxes, int64_t id,
+                                      const OCRTaskConfig& config) {
+    if (!running_ || !recQueue_ || !frame || frame->empty()) return false;
+    size_t boxCount = boxes.size();
+    if (!recQueue_->try_push(RecognitionTask(std::move(frame), std::move(boxes), id, config),
+                             std::chrono::milliseconds(100))) {
+        return false;  // Queue full, caller should retry
+    }
+    LOG_INFO("Recognition-only task pushed to recognition queue, id={}, boxes={}, textlineOri={}, recThresh={:.2f}",
+             id, boxCount, config.useTextlineOrientation, config.textRecScoreThresh);
+    return true;
+}
+
+bool OCRPipeline::isCharsetSupported(const std::string& charset) const {
+    if (charset.empty()) return true;
+    if (!recognizer_) return false;
+    ocr::CharsetIndexPtr compiled;
+    return recognizer_->CompileCharset(charset, compiled);
+}
+
+DetectionResolutionStats OCRPipeline::getDetectionResolutionStats() const {
+    DetectionResolutionStats stats;
+    for (const TextDetector* detector : {detector_.get(), fastDetector_.get()}) {
+        if (detector) {
+            stats.add(detector->getResolutionStats());
+        }
+    }
+    return stats;
+}
+
+CropSchedulerStats OCRPipeline::getCropSchedulerStats() const {
+    if (!cropScheduler_) {
+        CropSchedulerStats stats;
+        stats.policy = "disabled";
+        return stats;
+    }
+    return cropScheduler_->getStats();
+}
+
 bool OCRPipeline::getResult(std::vector<PipelineOCRResult>& results, int64_t& id, cv::Mat* processedImage, bool* success) {
     if (!running_ || !outQueue_) return false;
     
@@ -435,7 +639,8 @@ bool OCRPipeline::getResult(std::vector<PipelineOCRResult>& results, int64_t& id
     results = std::move(task.results);
     id = task.id;
     if (processedImage) {
-        *processedImage = task.processedImage;
+        // 共享帧的像素缓冲（不拷贝）
+        *processedImage = task.frame ? task.frame->image() : cv::Mat();
     }
     if (success) {
         *success = task.success;
@@ -444,82 +649,291 @@ bool OCRPipeline::getResult(std::vector<PipelineOCRResult>& results, int64_t& id
 }
 
 void OCRPipeline::detectionLoop() {
+    // 攒 mosaic 时取到的不能并入当前画布的任务，留到下一轮处理（已完成文档预处理）
+    std::optional<PreparedDetection> carried;
+    
     while (running_) {
-        DetectionTask task;
-        if (!detQueue_->try_pop(task, std::chrono::milliseconds(100))) {
-            LOG_DEBUG("Detection queue pop timeout, retrying...");
-            continue;  // Timeout, check running_ and retry
+        PreparedDetection prepared;
+        if (carried) {
+            prepared = std::move(*carried);
+            carried.reset();
+        } else {
+            DetectionTask task;
+            if (!detQueue_->try_pop(task, std::chrono::milliseconds(100))) {
+                LOG_DEBUG("Detection queue pop timeout, retrying...");
+                continue;  // Timeout, check running_ and retry
+            }
+            LOG_INFO("Task popped from detection queue, id={}", task.id);
+            if (!running_) break;
+            if (!prepareDetection(std::move(task), prepared)) continue;
         }
-        LOG_INFO("Task popped from detection queue, id={}", task.id);
-        if (!running_) break;
-        if (task.image.empty()) continue;
 
-        // 存储任务配置到 map 中（用于在检测回调中传递给识别阶段）
-        {
-            std::lock_guard<std::mutex> lock(pendingTaskConfigsMutex_);
-            pendingTaskConfigs_[task.id] = task.config;
+        if (!mosaicEligible(prepared)) {
+            submitDetection(prepared);
+            continue;
         }
 
-        // 1. Doc Preprocessing (Doc Ori + UVDoc) - 根据 task.config 控制
-        auto t1 = std::chrono::high_resolution_clock::now();
-        cv::Mat processedImage = task.image;
+        // Mosaic：继续取队列中检测参数相同的小图，直到画布放满、达到张数上限或短暂等待后队列为空
+        TextDetector* detector = detectorFor(prepared.task.config.modelTier);
+        std::vector<PreparedDetection> batch;
+        std::vector<cv::Size> sizes{prepared.frame->image().size()};
+        batch.push_back(std::move(prepared));
         
-        // 使用 task.config 控制是否进行文档预处理
-        bool useDocPreproc = (task.config.useDocOrientationClassify || task.config.useDocUnwarping);
-        if (useDocPreproc && docPreprocessing_) {
-            // 动态设置文档预处理配置
-            DocumentPreprocessingConfig dynamicConfig;
-            dynamicConfig.useOrientation = task.config.useDocOrientationClassify;
-            dynamicConfig.useUnwarping = task.config.useDocUnwarping;
+        while (running_ && static_cast<int>(batch.size()) < config_.mosaicMaxImages) {
+            DetectionTask task;
+            if (!detQueue_->try_pop(task, std::chrono::milliseconds(config_.mosaicWaitMs))) {
+                break;
+            }
+            LOG_INFO("Task popped from detection queue, id={}", task.id);
+            PreparedDetection next;
+            if (!prepareDetection(std::move(task), next)) continue;
             
-            auto preprocResult = docPreprocessing_->Process(task.image, dynamicConfig);
-            if (preprocResult.success && !preprocResult.processedImage.empty()) {
-                processedImage = preprocResult.processedImage;
-                LOG_DEBUG("Doc preprocessing applied: ori={}, unwarp={}", 
-                          task.config.useDocOrientationClassify, task.config.useDocUnwarping);
+            const OCRTaskConfig& first = batch[0].task.config;
+            const OCRTaskConfig& other = next.task.config;
+            bool compatible = mosaicEligible(next) && other.modelTier == first.modelTier &&
+                              other.textDetThresh == first.textDetThresh &&
+                              other.textDetBoxThresh == first.textDetBoxThresh &&
+                              other.textDetUnclipRatio == first.textDetUnclipRatio;
+            if (compatible) {
+                sizes.push_back(next.frame->image().size());
+                compatible = mosaic::pack(sizes, detector->mosaicCanvasSize(), config_.mosaicMargin).size() == sizes.size();
             }
+            if (!compatible) {
+                carried = std::move(next);
+                break;
+            }
+            batch.push_back(std::move(next));
         }
 
-        // 2. Detection Preprocess
-        int resized_h, resized_w;
-        int h = processedImage.rows;
-        int w = processedImage.cols;
+        if (batch.size() == 1) {
+            submitDetection(batch[0]);
+        } else {
+            submitMosaic(batch, detector);
+        }
+    }
+    
+    // 停止时丢弃未提交的任务（与队列中剩余的任务一样）
+    if (carried) {
+        std::lock_guard<std::mutex> lock(pendingTaskConfigsMutex_);
+        pendingTaskConfigs_.erase(carried->task.id);
+    }
+}
+
+bool OCRPipeline::prepareDetection(DetectionTask task, PreparedDetection& prepared) {
+    if (!task.frame || task.frame->empty()) return false;
+
+    // 0. 空白页：直接输出空结果，不做文档预处理和检测
+    if (config_.skipBlankPages) {
+        auto check = checkBlankPage(task.frame->image(), config_.blankPageConfig);
+        if (check.blank) {
+            blankPagesSkipped_++;
+            LOG_INFO("Blank page (stdDev={:.1f}), skipping detection, id={}", check.stdDev, task.id);
+            pushEmptyResult(task.frame, task.id, task.config);
+            return false;
+        }
+    }
+
+    // 存储任务配置到 map 中（用于在检测回调中传递给识别阶段）
+    {
+        std::lock_guard<std::mutex> lock(pendingTaskConfigsMutex_);
+        pendingTaskConfigs_[task.id] = task.config;
+    }
+
+    // 1. Doc Preprocessing (Doc Ori + UVDoc) - 根据 task.config 控制
+    prepared.start = std::chrono::high_resolution_clock::now();
+    FramePtr frame = task.frame;
+    
+    // 使用 task.config 控制是否进行文档预处理
+    bool useDocPreproc = (task.config.useDocOrientationClassify || task.config.useDocUnwarping);
+    if (useDocPreproc && docPreprocessing_) {
+        // 动态设置文档预处理配置
+        DocumentPreprocessingConfig dynamicConfig;
+        dynamicConfig.useOrientation = task.config.useDocOrientationClassify;
+        dynamicConfig.useUnwarping = task.config.useDocUnwarping;
         
-        int target_size = detector_->getTargetSize(h, w);
+        auto preprocResult = docPreprocessing_->Process(task.frame->image(), dynamicConfig);
+        if (preprocResult.success && !preprocResult.processedImage.empty()) {
+            // 预处理生成新图像，作为新帧继续传递（不拷贝）
+            frame = Frame::derive(preprocResult.processedImage, task.frame);
+            LOG_DEBUG("Doc preprocessing applied: ori={}, unwarp={}", 
+                      task.config.useDocOrientationClassify, task.config.useDocUnwarping);
+        }
+    }
+    
+    prepared.frame = std::move(frame);
+    prepared.task = std::move(task);
+    return true;
+}
 
-        cv::Mat preprocessed = detector_->preprocessAsync(processedImage, target_size, resized_h, resized_w);
-        auto t2 = std::chrono::high_resolution_clock::now();
-        double preprocess_time = std::chrono::duration<double, std::milli>(t2 - t1).count();
+bool OCRPipeline::mosaicEligible(const PreparedDetection& prepared) const {
+    if (!config_.useMosaic) {
+        return false;
+    }
+    const cv::Mat& image = prepared.frame->image();
+    return image.type() == CV_8UC3 && std::max(image.rows, image.cols) <= config_.mosaicMaxSide &&
+           prepared.task.config.detResizeRatio(image.rows, image.cols) == 1.0 && prepared.task.config.rois.empty();
+}
 
-        // 3. Submit Async Inference（使用 task.config 中的检测参数）
-        int ret = detector_->runAsync(preprocessed, h, w, resized_h, resized_w, task.id, processedImage, preprocess_time,
-                            task.config.textDetThresh, task.config.textDetBoxThresh, task.config.textDetUnclipRatio);
-        if (ret < 0) {
-            LOG_ERROR("Failed to submit async inference, id={} ret={}", task.id, ret);
-            
-            // 删除刚插入的配置，避免内存泄漏
+void OCRPipeline::submitDetection(PreparedDetection& prepared) {
+    const DetectionTask& task = prepared.task;
+    const FramePtr& frame = prepared.frame;
+
+    // 2. Detection Preprocess
+    int resized_h, resized_w;
+    int h = frame->rows();
+    int w = frame->cols();
+    
+    TextDetector* detector = detectorFor(task.config.modelTier);
+    int ret = 0;
+    
+    // 感兴趣区域：合计面积不超过页面一半时只检测区域子图，否则检测整页（区域外的框在检测回调中丢弃）
+    std::vector<cv::Rect> regions;
+    if (!task.config.rois.empty()) {
+        regions = task.config.roiRects(h, w);
+        if (regions.empty()) {
+            LOG_WARN("No ROI inside the {}x{} page, skipping detection, id={}", w, h, task.id);
             {
                 std::lock_guard<std::mutex> lock(pendingTaskConfigsMutex_);
                 pendingTaskConfigs_.erase(task.id);
             }
-            
-            // 推送失败结果到输出队列，确保调用者能收到响应（避免无限等待）
-            if (outQueue_ && running_) {
-                OutputTask errorResult;
-                errorResult.results = std::vector<PipelineOCRResult>{};     // 空结果
-                errorResult.processedImage = processedImage;
-                errorResult.id = task.id;
-                errorResult.config = task.config;
-                errorResult.success = false;  // 标记为失败（检测引擎异常）
-                
-                if (!outQueue_->try_push(std::move(errorResult), std::chrono::milliseconds(100))) {
-                    LOG_WARN("Failed to push error result to output queue, id={}", task.id);
-                } else {
-                    LOG_INFO("Pushed error result (success=false) for failed detection, id={}", task.id);
-                }
+            pushEmptyResult(frame, task.id, task.config);
+            return;
+        }
+        double area = 0.0;
+        for (const auto& rect : regions) {
+            area += rect.area();
+        }
+        if (area > kRoiFullPageCoverage * h * w) {
+            regions.clear();
+        }
+    }
+    
+    // textDetLimitSideLen / textDetLimitType：先按请求的边长限制缩放，检测框仍映射回原图坐标
+    double ratio = task.config.detResizeRatio(h, w);
+    
+    if (!regions.empty()) {
+        auto t2 = std::chrono::high_resolution_clock::now();
+        double preprocess_time = std::chrono::duration<double, std::milli>(t2 - prepared.start).count();
+        // 边长限制按区域计算（每个区域单独检测）
+        std::vector<double> scales;
+        if (task.config.textDetLimitSideLen > 0) {
+            for (const auto& rect : regions) {
+                scales.push_back(task.config.detResizeRatio(rect.height, rect.width));
             }
-            
-            continue;
+        }
+        ret = detector->runRegionsAsync(task.id, frame, regions, preprocess_time,
+                                        task.config.textDetThresh, task.config.textDetBoxThresh,
+                                        task.config.textDetUnclipRatio, scales);
+    } else if (ratio == 1.0 && detector->shouldTile(h, w)) {
+        // 远大于模型输入的页面（长票据、大幅图纸）：分块检测，回调收到合并后的整页检测框
+        auto t2 = std::chrono::high_resolution_clock::now();
+        double preprocess_time = std::chrono::duration<double, std::milli>(t2 - prepared.start).count();
+        ret = detector->runTiledAsync(task.id, frame, preprocess_time,
+                                      task.config.textDetThresh, task.config.textDetBoxThresh,
+                                      task.config.textDetUnclipRatio);
+    } else {
+        cv::Mat det_image = frame->image();
+        if (ratio != 1.0) {
+            int det_h = std::max(1, static_cast<int>(std::lround(h * ratio)));
+            int det_w = std::max(1, static_cast<int>(std::lround(w * ratio)));
+            cv::resize(frame->image(), det_image, cv::Size(det_w, det_h), 0, 0,
+                       ratio < 1.0 ? cv::INTER_AREA : cv::INTER_LINEAR);
+            frame->recordCopy(det_image.total() * det_image.elemSize());
+        }
+        
+        // 按尺寸规则或文字大小估计选择检测模型（adaptiveResolution）
+        int target_size = detector->chooseTargetSize(det_image);
+        
+        // 同一图像已推理过（只换了检测阈值）：直接用缓存的概率图做后处理，跳过前处理和推理
+        uint64_t probMapKey = detector->probMapKey(det_image, target_size);
+        if (probMapKey != 0 &&
+            detector->runCached(probMapKey, h, w, task.id, frame, 0.0,
+                                task.config.textDetThresh, task.config.textDetBoxThresh,
+                                task.config.textDetUnclipRatio)) {
+            return;
+        }
+
+        BufferLease preprocessed = detector->preprocessAsync(det_image, target_size, resized_h, resized_w);
+        if (ratio != 1.0) {
+            // 概率图覆盖缩放后图像的补边正方形，按原图的补边正方形映射即得到原图坐标
+            resized_h = resized_w = std::max(h, w);
+        }
+        auto t2 = std::chrono::high_resolution_clock::now();
+        double preprocess_time = std::chrono::duration<double, std::milli>(t2 - prepared.start).count();
+
+        // 3. Submit Async Inference（使用 task.config 中的检测参数）
+        ret = detector->runAsync(std::move(preprocessed), h, w, resized_h, resized_w, task.id, frame, preprocess_time,
+                            task.config.textDetThresh, task.config.textDetBoxThresh, task.config.textDetUnclipRatio,
+                            probMapKey);
+    }
+    if (ret < 0) {
+        LOG_ERROR("Failed to submit async inference, id={} ret={}", task.id, ret);
+        failDetection(prepared);
+    }
+}
+
+void OCRPipeline::submitMosaic(std::vector<PreparedDetection>& batch, TextDetector* detector) {
+    std::vector<cv::Size> sizes;
+    std::vector<MosaicItem> items;
+    for (const auto& prepared : batch) {
+        sizes.push_back(prepared.frame->image().size());
+        items.push_back(MosaicItem{prepared.task.id, prepared.frame});
+    }
+    auto placements = mosaic::pack(sizes, detector->mosaicCanvasSize(), config_.mosaicMargin);
+    
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double preprocess_time = std::chrono::duration<double, std::milli>(t2 - batch[0].start).count();
+    
+    // 同一批次的检测参数相同（见 detectionLoop）
+    const OCRTaskConfig& config = batch[0].task.config;
+    int ret = -1;
+    if (placements.size() == items.size()) {
+        ret = detector->runMosaicAsync(items, placements, preprocess_time,
+                                       config.textDetThresh, config.textDetBoxThresh, config.textDetUnclipRatio);
+    }
+    if (ret < 0) {
+        LOG_ERROR("Failed to submit mosaic detection of {} images, first id={}", batch.size(), batch[0].task.id);
+        for (const auto& prepared : batch) {
+            failDetection(prepared);
+        }
+        return;
+    }
+    mosaicImages_ += batch.size();
+    mosaicCanvases_++;
+    LOG_INFO("Submitted mosaic detection: {} images, first id={}", batch.size(), batch[0].task.id);
+}
+
+void OCRPipeline::pushEmptyResult(FramePtr frame, int64_t id, const OCRTaskConfig& config, bool success) {
+    if (outQueue_ && running_) {
+        logFrameCopies(frame, id);
+        outQueue_->push(OutputTask(std::vector<PipelineOCRResult>{}, std::move(frame), id, config, success));
+        LOG_INFO("Pushed empty result (success={}) to output queue, id={}", success, id);
+    }
+}
+
+void OCRPipeline::failDetection(const PreparedDetection& prepared) {
+    const DetectionTask& task = prepared.task;
+    
+    // 删除刚插入的配置，避免内存泄漏
+    {
+        std::lock_guard<std::mutex> lock(pendingTaskConfigsMutex_);
+        pendingTaskConfigs_.erase(task.id);
+    }
+    
+    // 推送失败结果到输出队列，确保调用者能收到响应（避免无限等待）
+    if (outQueue_ && running_) {
+        OutputTask errorResult;
+        errorResult.results = std::vector<PipelineOCRResult>{};     // 空结果
+        errorResult.frame = prepared.frame;
+        errorResult.id = task.id;
+        errorResult.config = task.config;
+        errorResult.success = false;  // 标记为失败（检测引擎异常）
+        logFrameCopies(errorResult.frame, task.id);
+        
+        if (!outQueue_->try_push(std::move(errorResult), std::chrono::milliseconds(100))) {
+            LOG_WARN("Failed to push error result to output queue, id={}", task.id);
+        } else {
+            LOG_INFO("Pushed error result (success=false) for failed detection, id={}", task.id);
         }
     }
 }
@@ -534,10 +948,19 @@ void OCRPipeline::recognitionLoop() {
         LOG_INFO("Task popped from recognition queue, id={}", task.id);
 
         if (!running_) break;
+        
+        // 字符集约束每个任务只编译一次，所有 crop 共享；没有一个字符在字典中时任务失败
+        ocr::CharsetIndexPtr allowedClasses;
+        if (!recognizer_->CompileCharset(task.config.allowedCharset, allowedClasses)) {
+            LOG_ERROR("allowedCharset has no character in the recognition dictionary, id={}", task.id);
+            pushEmptyResult(std::move(task.frame), task.id, task.config, false);
+            continue;
+        }
         if (task.boxes.empty()) {
             // No boxes detected, push empty result
             if (outQueue_) {
-                outQueue_->push({std::vector<PipelineOCRResult>{}, task.image, task.id, task.config, true});
+                logFrameCopies(task.frame, task.id);
+                outQueue_->push(OutputTask(std::vector<PipelineOCRResult>{}, std::move(task.frame), task.id, task.config, true));
                 LOG_INFO("Pushed empty result (no text detected) to output queue, id={}", task.id);
             }
             continue;
@@ -551,8 +974,32 @@ void OCRPipeline::recognitionLoop() {
         // ============================================================
         
         size_t validBoxCount = task.boxes.size();
-        auto taskCtx = std::make_shared<RecognitionTaskContext>(task.id, validBoxCount);
-        taskCtx->processedImage = task.image.clone();  // 保存处理后的图像用于可视化
+        auto taskCtx = std::make_shared<RecognitionTaskContext>(task.id, validBoxCount, task.config);
+        taskCtx->frame = task.frame;  // 共享处理后的图像用于可视化（不拷贝）
+        taskCtx->allowedClasses = std::move(allowedClasses);
+        // 模型档位：fast 只用 mobile，accurate 只用默认模型，default 按 pipeline 配置（可能走 cascade）
+        switch (task.config.modelTier) {
+        case ModelTier::Fast:
+            taskCtx->cascade = false;
+            taskCtx->firstTier = (fastRecognizer_ || config_.recognizerConfig.useMobileModel)
+                                     ? RecognitionTier::Mobile : RecognitionTier::Server;
+            break;
+        case ModelTier::Accurate:
+            taskCtx->cascade = false;
+            taskCtx->firstTier = config_.recognizerConfig.useMobileModel
+                                     ? RecognitionTier::Mobile : RecognitionTier::Server;
+            break;
+        default:
+            taskCtx->cascade = config_.useRecognitionCascade && fastRecognizer_ != nullptr;
+            taskCtx->firstTier = (taskCtx->cascade || config_.recognizerConfig.useMobileModel)
+                                     ? RecognitionTier::Mobile : RecognitionTier::Server;
+            break;
+        }
+        if (config_.useClassification && classifier_ && config_.speculativeRecognition) {
+            taskCtx->speculative = true;
+            taskCtx->speculation.resize(validBoxCount);
+        }
+        const cv::Mat& image = task.frame->image();
         
         LOG_INFO("Starting interleaved crop & submit for {} boxes, id={}, cls={}", 
                  validBoxCount, task.id, 
@@ -567,12 +1014,12 @@ void OCRPipeline::recognitionLoop() {
             std::vector<cv::Point2f> box_points(4);
             for (int j = 0; j < 4; ++j) box_points[j] = task.boxes[i].points[j];
             
-            // Crop this single box
-            cv::Mat textImage = Geometry::getRotateCropImage(task.image, box_points);
-            
-            if (textImage.empty()) {
+            // Crop geometry only: pixels are sampled straight into the cls/rec input buffers
+            TextCropGeometry geom;
+            if (!computeTextCropGeometry(box_points, geom)) {
                 // This crop failed, decrement pending count
                 ++failedCrops;
+                markCropSubmitted(taskCtx);
                 int remaining = taskCtx->pendingCount.fetch_sub(1) - 1;
                 LOG_DEBUG("Crop {} failed (empty), remaining pending={}", i, remaining);
                 
@@ -584,7 +1031,7 @@ void OCRPipeline::recognitionLoop() {
             }
             
             // Store crop and box points in context
-            taskCtx->crops[actualCropIndex] = std::move(textImage);
+            taskCtx->crops[actualCropIndex] = std::move(geom);
             taskCtx->boxPoints[actualCropIndex] = std::move(box_points);
             taskCtx->results[actualCropIndex].box = taskCtx->boxPoints[actualCropIndex];
             taskCtx->results[actualCropIndex].index = static_cast<int>(actualCropIndex);
@@ -593,7 +1040,11 @@ void OCRPipeline::recognitionLoop() {
             // NPU starts processing while CPU continues to crop next box
             if (config_.useClassification && classifier_) {
                 ClassificationCropContext* clsCtx = new ClassificationCropContext{taskCtx, actualCropIndex};
-                classifier_->ClassifyAsync(taskCtx->crops[actualCropIndex], clsCtx);
+                classifier_->ClassifyRegionAsync(image, taskCtx->crops[actualCropIndex], clsCtx);
+                if (taskCtx->speculative) {
+                    // Recognize the upright crop at the same time; kept if cls says "0"
+                    submitCropForRecognition(taskCtx, actualCropIndex, false, true);
+                }
             } else {
                 submitCropForRecognition(taskCtx, actualCropIndex);
             }
@@ -607,12 +1058,107 @@ void OCRPipeline::recognitionLoop() {
 }
 
 // Helper: Submit a single crop for recognition (after classification or directly)
-void OCRPipeline::submitCropForRecognition(std::shared_ptr<RecognitionTaskContext> taskCtx, size_t cropIndex) {
-    const cv::Mat& crop = taskCtx->crops[cropIndex];
+void OCRPipeline::submitCropForRecognition(std::shared_ptr<RecognitionTaskContext> taskCtx, size_t cropIndex,
+                                           bool rotate180, bool speculative) {
+    const TextCropGeometry& geom = taskCtx->crops[cropIndex];
     
     // Submit async recognition (model will handle all ratios including long text via ratio_35)
-    RecognitionCropContext* cropCtx = new RecognitionCropContext{taskCtx, cropIndex};
-    recognizer_->RecognizeAsync(crop, cropCtx);
+    // The crop is rendered from the shared frame straight into the 48xW model input
+    if (recognizerFor(taskCtx->firstTier)->IsPackable(geom)) {
+        // Short crop: held back and packed with the task's other short crops
+        RecognitionCropContext* cropCtx = new RecognitionCropContext{taskCtx, cropIndex, speculative,
+                                                                     rotate180, taskCtx->firstTier};
+        std::lock_guard<std::mutex> lock(taskCtx->packMutex);
+        taskCtx->packedCrops.push_back(PackedCrop{&geom, rotate180, cropCtx});
+    } else {
+        scheduleCrop(taskCtx, cropIndex, rotate180, speculative, taskCtx->firstTier);
+    }
+    markCropSubmitted(taskCtx);
+}
+
+void OCRPipeline::scheduleCrop(const std::shared_ptr<RecognitionTaskContext>& taskCtx, size_t cropIndex,
+                               bool rotate180, bool speculative, RecognitionTier tier) {
+    const TextCropGeometry& geom = taskCtx->crops[cropIndex];
+    TextRecognizer* recognizer = recognizerFor(tier);
+    RecognitionCropContext* cropCtx = new RecognitionCropContext{taskCtx, cropIndex, speculative, rotate180, tier};
+    
+    CropJob job;
+    job.taskId = taskCtx->taskId;
+    job.ratio = recognizer->RatioOf(geom);
+    job.tier = static_cast<int>(tier);
+    job.length = recognizer->ScaledWidth(geom);
+    job.remaining = std::shared_ptr<const std::atomic<int>>(taskCtx, &taskCtx->pendingCount);
+    job.submit = [recognizer, taskCtx, cropCtx, &geom, rotate180]() {
+        recognizer->RecognizeRegionAsync(taskCtx->frame->image(), geom, rotate180, cropCtx,
+                                         taskCtx->allowedClasses);
+    };
+    job.cancel = [this, cropCtx]() {
+        onRecognitionComplete("", 0.0f, cropCtx);
+    };
+    scheduleRecognition(std::move(job));
+}
+
+TextDetector* OCRPipeline::detectorFor(ModelTier tier) const {
+    if (tier == ModelTier::Fast && fastDetector_) {
+        return fastDetector_.get();
+    }
+    return detector_.get();
+}
+
+TextRecognizer* OCRPipeline::recognizerFor(RecognitionTier tier) const {
+    if (tier == RecognitionTier::Mobile && fastRecognizer_) {
+        return fastRecognizer_.get();
+    }
+    return recognizer_.get();
+}
+
+void OCRPipeline::scheduleRecognition(CropJob job) {
+    if (cropScheduler_ && running_) {
+        cropScheduler_->enqueue(std::move(job));
+    } else {
+        job.submit();
+    }
+}
+
+void OCRPipeline::markCropSubmitted(const std::shared_ptr<RecognitionTaskContext>& taskCtx) {
+    // The last crop (after classification, if enabled) releases the packed batch
+    if (taskCtx->unsubmittedCount.fetch_sub(1) == 1) {
+        flushPackedCrops(taskCtx);
+    }
+}
+
+void OCRPipeline::flushPackedCrops(const std::shared_ptr<RecognitionTaskContext>& taskCtx) {
+    std::vector<PackedCrop> crops;
+    {
+        std::lock_guard<std::mutex> lock(taskCtx->packMutex);
+        crops.swap(taskCtx->packedCrops);
+    }
+    if (crops.empty()) {
+        return;
+    }
+    // Scheduled as one job on the widest engine; geometry pointers refer to taskCtx->crops,
+    // which the job keeps alive through taskCtx until the packed inputs are rendered
+    TextRecognizer* recognizer = recognizerFor(taskCtx->firstTier);
+    CropJob job;
+    job.taskId = taskCtx->taskId;
+    job.ratio = recognizer->MaxRatio();
+    job.tier = static_cast<int>(taskCtx->firstTier);
+    job.weight = crops.size();
+    job.remaining = std::shared_ptr<const std::atomic<int>>(taskCtx, &taskCtx->pendingCount);
+    for (const auto& crop : crops) {
+        job.length += recognizer->ScaledWidth(*crop.geom);
+    }
+    job.cancel = [this, crops]() {
+        for (const auto& crop : crops) {
+            onRecognitionComplete("", 0.0f, crop.userArg);
+        }
+    };
+    job.submit = [recognizer, taskCtx, crops = std::move(crops)]() {
+        [[maybe_unused]] int jobs = recognizer->RecognizePackedAsync(taskCtx->frame->image(), crops,
+                                                                     taskCtx->allowedClasses);
+        LOG_DEBUG("Task {}: {} short crops packed into {} recognition jobs", taskCtx->taskId, crops.size(), jobs);
+    };
+    scheduleRecognition(std::move(job));
 }
 
 void OCRPipeline::onClassificationComplete(const std::string& label, float confidence, void* userArg) {
@@ -636,14 +1182,43 @@ void OCRPipeline::onClassificationComplete(const std::string& label, float confi
     // Dispatch heavy work to thread pool (similar to Python's _dispatch_stage)
     // This avoids blocking DXRT internal callback thread
     stageExecutor_->dispatch([this, taskCtx, idx, needsRotation]() {
-        // Rotate image if needed (in-place on taskCtx->crops)
+        // 180-degree rotation is folded into the recognition sampling (no extra pass)
         if (needsRotation) {
-            cv::rotate(taskCtx->crops[idx], taskCtx->crops[idx], cv::ROTATE_180);
-            LOG_DEBUG("Rotated crop {} by 180 degrees", idx);
+            LOG_DEBUG("Rotating crop {} by 180 degrees", idx);
+        }
+        
+        if (taskCtx->speculative) {
+            // Upright recognition is already in flight (or done)
+            bool ready = false;
+            std::string text;
+            float conf = 0.0f;
+            RecognitionTier tier = taskCtx->firstTier;
+            {
+                std::lock_guard<std::mutex> lock(taskCtx->resultMutex);
+                auto& state = taskCtx->speculation[idx];
+                state.orientation = needsRotation ? SpeculativeCropState::Orientation::Rotated
+                                                  : SpeculativeCropState::Orientation::Upright;
+                if (!needsRotation && state.recognized) {
+                    ready = true;
+                    text = std::move(state.text);
+                    conf = state.confidence;
+                    tier = state.tier;
+                }
+            }
+            if (needsRotation) {
+                speculativeMisses_++;
+                scheduleCrop(taskCtx, idx, true, false, taskCtx->firstTier);
+            } else {
+                speculativeHits_++;
+                if (ready) {
+                    deliverCrop(taskCtx, idx, std::move(text), conf, tier, false);
+                }
+            }
+            return;
         }
         
         // Submit to recognition (pipelined)
-        submitCropForRecognition(taskCtx, idx);
+        submitCropForRecognition(taskCtx, idx, needsRotation);
     });
 }
 
@@ -654,34 +1229,85 @@ void OCRPipeline::onRecognitionComplete(const std::string& text, float confidenc
         return;
     }
 
+    // Release the crop's in-flight slot in the scheduler right away (cheap, no dispatch needed)
+    if (cropScheduler_) {
+        cropScheduler_->complete();
+    }
+    
     // Extract context data (lightweight)
     auto taskCtx = cropCtx->taskCtx;  // shared_ptr copy
     size_t idx = cropCtx->cropIndex;
     std::string textCopy = text;  // Copy text for dispatch
+    bool speculative = cropCtx->speculative;
+    bool rotate180 = cropCtx->rotate180;
+    RecognitionTier tier = cropCtx->tier;
     
     // Clean up the raw pointer
     delete cropCtx;
 
     // Dispatch to thread pool to avoid blocking DXRT callback thread
-    stageExecutor_->dispatch([this, taskCtx, idx, textCopy = std::move(textCopy), confidence]() {
-        // Update result for this crop
-        {
+    stageExecutor_->dispatch([this, taskCtx, idx, textCopy = std::move(textCopy), confidence,
+                              speculative, rotate180, tier]() mutable {
+        if (speculative) {
             std::lock_guard<std::mutex> lock(taskCtx->resultMutex);
-            taskCtx->results[idx].text = textCopy;
-            taskCtx->results[idx].confidence = confidence;
+            auto& state = taskCtx->speculation[idx];
+            switch (state.orientation) {
+            case SpeculativeCropState::Orientation::Pending:
+                // Classification not back yet: hold the result until it is
+                state.recognized = true;
+                state.text = std::move(textCopy);
+                state.confidence = confidence;
+                state.tier = tier;
+                return;
+            case SpeculativeCropState::Orientation::Rotated:
+                // Crop is upside down; the rotated re-run delivers the result
+                LOG_DEBUG("Discarding speculative result for rotated crop {} of task {}", idx, taskCtx->taskId);
+                return;
+            case SpeculativeCropState::Orientation::Upright:
+                break;
+            }
         }
+        deliverCrop(taskCtx, idx, std::move(textCopy), confidence, tier, rotate180);
+    });
+}
 
-        // Decrement pending count
-        int remaining = taskCtx->pendingCount.fetch_sub(1) - 1;
-        
-        LOG_DEBUG("Recognition complete for crop {} of task {}, remaining={}, text='{}'",
-                  idx, taskCtx->taskId, remaining, textCopy.empty() ? "<empty>" : textCopy.substr(0, 20));
-
-        // If all crops done, finalize and output
-        if (remaining == 0) {
-            finalizeRecognitionTask(taskCtx);
+void OCRPipeline::deliverCrop(const std::shared_ptr<RecognitionTaskContext>& taskCtx, size_t idx,
+                              std::string text, float confidence, RecognitionTier tier, bool rotate180) {
+    if (taskCtx->cascade && tier == RecognitionTier::Mobile) {
+        if (confidence < config_.cascadeThreshold) {
+            // Low mobile confidence: same crop, same orientation, server model
+            cascadeEscalated_++;
+            LOG_DEBUG("Escalating crop {} of task {} to server tier (mobile conf={:.3f})",
+                      idx, taskCtx->taskId, confidence);
+            scheduleCrop(taskCtx, idx, rotate180, false, RecognitionTier::Server);
+            return;
         }
-    });
+        cascadeAccepted_++;
+    }
+    completeCrop(taskCtx, idx, std::move(text), confidence, tier);
+}
+
+void OCRPipeline::completeCrop(const std::shared_ptr<RecognitionTaskContext>& taskCtx, size_t idx,
+                               std::string text, float confidence, RecognitionTier tier) {
+    LOG_DEBUG("Recognition complete for crop {} of task {}, text='{}'",
+              idx, taskCtx->taskId, text.empty() ? "<empty>" : text.substr(0, 20));
+    
+    // Update result for this crop
+    {
+        std::lock_guard<std::mutex> lock(taskCtx->resultMutex);
+        taskCtx->results[idx].text = std::move(text);
+        taskCtx->results[idx].confidence = confidence;
+        taskCtx->results[idx].tier = tier;
+    }
+
+    // Decrement pending count
+    int remaining = taskCtx->pendingCount.fetch_sub(1) - 1;
+    LOG_DEBUG("Task {} remaining crops={}", taskCtx->taskId, remaining);
+
+    // If all crops done, finalize and output
+    if (remaining == 0) {
+        finalizeRecognitionTask(taskCtx);
+    }
 }
 
 void OCRPipeline::finalizeRecognitionTask(std::shared_ptr<RecognitionTaskContext> taskCtx) {
@@ -722,8 +1348,10 @@ void OCRPipeline::finalizeRecognitionTask(std::shared_ptr<RecognitionTaskContext
     // 传递 task config 到 output
     if (outQueue_ && running_) {
         size_t resultCount = validResults.size();  // Save before move
-        while (running_ && !outQueue_->try_push({std::move(validResults), taskCtx->processedImage, taskCtx->taskId, taskCtx->config, true}, 
-                                                 std::chrono::milliseconds(500))) {
+        logFrameCopies(taskCtx->frame, taskCtx->taskId);
+        // try_push 只在成功时移走 output，重试不会丢失结果
+        OutputTask output(std::move(validResults), taskCtx->frame, taskCtx->taskId, taskCtx->config, true);
+        while (running_ && !outQueue_->try_push(std::move(output), std::chrono::milliseconds(500))) {
             LOG_WARN("Output queue full, waiting... id={}", taskCtx->taskId);
         }
         if (running_) {
@@ -733,4 +1361,11 @@ void OCRPipeline::finalizeRecognitionTask(std::shared_ptr<RecognitionTaskContext
     }
 }
 
+void OCRPipeline::logFrameCopies(const FramePtr& frame, int64_t taskId) {
+    if (!frame) return;
+    LOG_DEBUG("Frame copies: id={}, deepCopies={} ({} bytes), process total={} ({} bytes)",
+              taskId, frame->deepCopies(), frame->deepCopyBytes(),
+              Frame::totalDeepCopies(), Frame::totalDeepCopyBytes());
+}
+
 } // namespace ocr
@@ -0,0 +1,72 @@
+#include "preprocessing/blank_page.h"
+#include <algorithm>
+
+namespace ocr {
+
+namespace {
+
+// 灰度差超过 delta 的像素数
+int countAbove(const cv::Mat& a, const cv::Mat& b, int delta) {
+    cv::Mat diff;
+    cv::absdiff(a, b, diff);
+    cv::threshold(diff, diff, delta, 255, cv::THRESH_BINARY);
+    return cv::countNonZero(diff);
+}
+
+} // namespace
+
+BlankPageCheck checkBlankPage(const cv::Mat& image, const BlankPageConfig& config) {
+    BlankPageCheck check;
+    if (image.empty() || config.thumbSide <= 0) {
+        return check;
+    }
+
+    // 1. 缩略图（不放大）+ 灰度
+    int maxSide = std::max(image.rows, image.cols);
+    double scale = std::min(1.0, static_cast<double>(config.thumbSide) / maxSide);
+    cv::Mat thumb = image;
+    if (scale < 1.0) {
+        cv::resize(image, thumb, cv::Size(), scale, scale, cv::INTER_AREA);
+    }
+    cv::Mat gray;
+    if (thumb.channels() == 3) {
+        cv::cvtColor(thumb, gray, cv::COLOR_BGR2GRAY);
+    } else if (thumb.channels() == 4) {
+        cv::cvtColor(thumb, gray, cv::COLOR_BGRA2GRAY);
+    } else {
+        gray = thumb;
+    }
+
+    // 2. 去掉边框
+    int bx = static_cast<int>(gray.cols * config.borderRatio);
+    int by = static_cast<int>(gray.rows * config.borderRatio);
+    if (gray.cols - 2 * bx < 2 || gray.rows - 2 * by < 2) {
+        return check;
+    }
+    cv::Mat page = gray(cv::Rect(bx, by, gray.cols - 2 * bx, gray.rows - 2 * by));
+    double total = static_cast<double>(page.rows) * page.cols;
+
+    // 3. 标准差
+    cv::Scalar mean, stddev;
+    cv::meanStdDev(page, mean, stddev);
+    check.stdDev = static_cast<float>(stddev[0]);
+    if (check.stdDev > config.maxStdDev) {
+        return check;
+    }
+
+    // 4. 墨迹占比
+    cv::Mat background(page.size(), CV_8UC1, cv::Scalar(mean[0]));
+    check.inkRatio = static_cast<float>(countAbove(page, background, config.inkDelta) / total);
+    if (check.inkRatio > config.maxInkRatio) {
+        return check;
+    }
+
+    // 5. 边缘占比（水平、垂直相邻像素）
+    int edges = countAbove(page.colRange(1, page.cols), page.colRange(0, page.cols - 1), config.edgeDelta) +
+                countAbove(page.rowRange(1, page.rows), page.rowRange(0, page.rows - 1), config.edgeDelta);
+    check.edgeRatio = static_cast<float>(edges / total);
+    check.blank = check.edgeRatio <= config.maxEdgeRatio;
+    return check;
+}
+
+} // namespace ocr
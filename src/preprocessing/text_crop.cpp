@@ -0,0 +1,117 @@
+#include "preprocessing/text_crop.h"
+#include "common/geometry.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ocr {
+
+namespace {
+
+// 四条边在该容差内与坐标轴平行时视为轴对齐框（像素）
+constexpr float kAxisAlignedTolerance = 0.5f;
+
+/**
+ * 输出像素 (u, v) -> 旋转后裁剪图坐标 -> 矫正裁剪图坐标 -> 原图坐标，
+ * 三步都是射影变换，合成为一个矩阵后交给 warpPerspective 一次采样。
+ * sx / sy 为 resize 的缩放比（裁剪图尺寸 / 输出尺寸），采用 cv::resize 的像素中心约定。
+ */
+void sampleCrop(const cv::Mat& image, const TextCropGeometry& geom, bool rotate180,
+                double sx, double sy, cv::Mat& dst) {
+    cv::Matx33d toCrop(sx, 0, 0.5 * sx - 0.5,
+                       0, sy, 0.5 * sy - 0.5,
+                       0, 0, 1);
+    if (rotate180) {
+        // (x, y) -> (outW - 1 - x, outH - 1 - y)
+        toCrop = cv::Matx33d(-1, 0, geom.outWidth() - 1,
+                             0, -1, geom.outHeight() - 1,
+                             0, 0, 1) * toCrop;
+    }
+    if (geom.vertical) {
+        // 逆时针旋转 90 度的逆映射: (x, y) -> (width - 1 - y, x)
+        toCrop = cv::Matx33d(0, -1, geom.width - 1,
+                             1, 0, 0,
+                             0, 0, 1) * toCrop;
+    }
+    cv::Matx33d toImage = geom.cropToImage * toCrop;
+
+    // dst 已是目标尺寸（可能是池缓冲的子区域），warpPerspective 直接写入不重新分配
+    cv::warpPerspective(image, dst, toImage, dst.size(),
+                        cv::INTER_LINEAR | cv::WARP_INVERSE_MAP, cv::BORDER_REPLICATE);
+}
+
+} // namespace
+
+bool computeTextCropGeometry(const std::vector<cv::Point2f>& box, TextCropGeometry& geom) {
+    if (box.size() != 4) {
+        return false;
+    }
+
+    // 与 Geometry::cropTextRegion 相同的尺寸计算
+    geom.ordered = Geometry::orderPointsClockwise(box);
+    const auto& p = geom.ordered;
+    float max_width = std::max(Geometry::distance(p[0], p[1]), Geometry::distance(p[2], p[3]));
+    float max_height = std::max(Geometry::distance(p[0], p[3]), Geometry::distance(p[1], p[2]));
+    geom.width = static_cast<int>(std::round(max_width));
+    geom.height = static_cast<int>(std::round(max_height));
+    if (geom.width < 1 || geom.height < 1) {
+        return false;
+    }
+    geom.vertical = geom.height > geom.width * 2;
+
+    std::vector<cv::Point2f> crop_pts = {
+        cv::Point2f(0, 0),
+        cv::Point2f(static_cast<float>(geom.width), 0),
+        cv::Point2f(static_cast<float>(geom.width), static_cast<float>(geom.height)),
+        cv::Point2f(0, static_cast<float>(geom.height))
+    };
+    geom.cropToImage = cv::Matx33d(cv::getPerspectiveTransform(crop_pts, geom.ordered));
+
+    geom.axisAligned = std::abs(p[0].y - p[1].y) < kAxisAlignedTolerance &&
+                       std::abs(p[3].y - p[2].y) < kAxisAlignedTolerance &&
+                       std::abs(p[0].x - p[3].x) < kAxisAlignedTolerance &&
+                       std::abs(p[1].x - p[2].x) < kAxisAlignedTolerance;
+    return true;
+}
+
+void renderTextCrop(const cv::Mat& image, const TextCropGeometry& geom, bool rotate180, cv::Mat& dst) {
+    CV_Assert(!dst.empty() && dst.type() == image.type());
+    double sx = static_cast<double>(geom.outWidth()) / dst.cols;
+    double sy = static_cast<double>(geom.outHeight()) / dst.rows;
+    sampleCrop(image, geom, rotate180, sx, sy, dst);
+}
+
+void renderRecognitionInput(const cv::Mat& image, const TextCropGeometry& geom, bool rotate180,
+                            int targetWidth, int targetHeight, cv::Mat& dst) {
+    dst.create(targetHeight, targetWidth, image.type());
+
+    // PPOCR: 比目标窄时右侧补边到目标宽高比，再整体 resize
+    int out_w = geom.outWidth();
+    int out_h = geom.outHeight();
+    float target_ratio = static_cast<float>(targetWidth) / targetHeight;
+    float orig_ratio = static_cast<float>(out_w) / out_h;
+    int padded_w = orig_ratio < target_ratio ? static_cast<int>(out_h * target_ratio) : out_w;
+    padded_w = std::max(padded_w, out_w);
+
+    double sx = static_cast<double>(padded_w) / targetWidth;
+    double sy = static_cast<double>(out_h) / targetHeight;
+    int content_w = std::min(targetWidth, std::max(1, cvRound(out_w / sx)));
+
+    // 使用灰色(114,114,114)填充，与Python保持一致
+    if (content_w < targetWidth) {
+        dst(cv::Rect(content_w, 0, targetWidth - content_w, targetHeight)).setTo(cv::Scalar(114, 114, 114));
+    }
+    cv::Mat content = dst(cv::Rect(0, 0, content_w, targetHeight));
+
+    // 快速路径：轴对齐且无需旋转的框（大部分文档文字），ROI 视图直接 resize
+    if (geom.axisAligned && !geom.vertical && !rotate180) {
+        cv::Rect roi(cvRound(geom.ordered[0].x), cvRound(geom.ordered[0].y), geom.width, geom.height);
+        if ((roi & cv::Rect(0, 0, image.cols, image.rows)) == roi) {
+            cv::resize(image(roi), content, content.size());
+            return;
+        }
+    }
+
+    sampleCrop(image, geom, rotate180, sx, sy, content);
+}
+
+} // namespace ocr
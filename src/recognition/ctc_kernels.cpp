@@ -0,0 +1,286 @@
+#include "recognition/ctc_kernels.h"
+#include "common/simd.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CTC_KERNELS_HAVE_X86 1
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CTC_KERNELS_HAVE_NEON 1
+#endif
+
+namespace ocr {
+namespace ctc_kernels {
+
+namespace {
+
+using ArgmaxKernel = int (*)(const float*, int, float&);
+
+// Each vector kernel keeps 4 independent (max, index) accumulators per lane,
+// so the compare/blend chains do not serialize on a single register.
+// Lanes only ever replace their value on a strictly greater score, so every
+// lane holds its first maximum; the reduction then picks the smallest index
+// among lanes holding the global maximum, matching the scalar loop exactly.
+inline int reduceLanes(const float* values, const int32_t* indices, int lanes, float& maxValue) {
+    int best = 0;
+    for (int l = 1; l < lanes; l++) {
+        if (values[l] > values[best] ||
+            (values[l] == values[best] && indices[l] < indices[best])) {
+            best = l;
+        }
+    }
+    maxValue = values[best];
+    return indices[best];
+}
+
+// Scalar tail: indices here are larger than every lane index, so a strict
+// compare keeps first-occurrence semantics.
+inline int scanTail(const float* row, int begin, int n, int maxIdx, float& maxValue) {
+    for (int c = begin; c < n; c++) {
+        if (row[c] > maxValue) {
+            maxValue = row[c];
+            maxIdx = c;
+        }
+    }
+    return maxIdx;
+}
+
+#ifdef CTC_KERNELS_HAVE_X86
+__attribute__((target("avx2")))
+int argmaxAvx2(const float* row, int n, float& maxValue) {
+    if (n < 32) return argmaxScalar(row, n, maxValue);
+
+    const __m256i step = _mm256_set1_epi32(32);
+    __m256i c0 = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i c1 = _mm256_add_epi32(c0, _mm256_set1_epi32(8));
+    __m256i c2 = _mm256_add_epi32(c0, _mm256_set1_epi32(16));
+    __m256i c3 = _mm256_add_epi32(c0, _mm256_set1_epi32(24));
+
+    __m256 m0 = _mm256_loadu_ps(row);
+    __m256 m1 = _mm256_loadu_ps(row + 8);
+    __m256 m2 = _mm256_loadu_ps(row + 16);
+    __m256 m3 = _mm256_loadu_ps(row + 24);
+    __m256i i0 = c0, i1 = c1, i2 = c2, i3 = c3;
+
+    int c = 32;
+    for (; c + 32 <= n; c += 32) {
+        c0 = _mm256_add_epi32(c0, step);
+        c1 = _mm256_add_epi32(c1, step);
+        c2 = _mm256_add_epi32(c2, step);
+        c3 = _mm256_add_epi32(c3, step);
+
+        __m256 v0 = _mm256_loadu_ps(row + c);
+        __m256 v1 = _mm256_loadu_ps(row + c + 8);
+        __m256 v2 = _mm256_loadu_ps(row + c + 16);
+        __m256 v3 = _mm256_loadu_ps(row + c + 24);
+
+        __m256 g0 = _mm256_cmp_ps(v0, m0, _CMP_GT_OQ);
+        __m256 g1 = _mm256_cmp_ps(v1, m1, _CMP_GT_OQ);
+        __m256 g2 = _mm256_cmp_ps(v2, m2, _CMP_GT_OQ);
+        __m256 g3 = _mm256_cmp_ps(v3, m3, _CMP_GT_OQ);
+
+        m0 = _mm256_blendv_ps(m0, v0, g0);
+        m1 = _mm256_blendv_ps(m1, v1, g1);
+        m2 = _mm256_blendv_ps(m2, v2, g2);
+        m3 = _mm256_blendv_ps(m3, v3, g3);
+
+        i0 = _mm256_blendv_epi8(i0, c0, _mm256_castps_si256(g0));
+        i1 = _mm256_blendv_epi8(i1, c1, _mm256_castps_si256(g1));
+        i2 = _mm256_blendv_epi8(i2, c2, _mm256_castps_si256(g2));
+        i3 = _mm256_blendv_epi8(i3, c3, _mm256_castps_si256(g3));
+    }
+
+    alignas(32) float values[32];
+    alignas(32) int32_t indices[32];
+    _mm256_store_ps(values, m0);
+    _mm256_store_ps(values + 8, m1);
+    _mm256_store_ps(values + 16, m2);
+    _mm256_store_ps(values + 24, m3);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(indices), i0);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(indices + 8), i1);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(indices + 16), i2);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(indices + 24), i3);
+
+    int maxIdx = reduceLanes(values, indices, 32, maxValue);
+    return scanTail(row, c, n, maxIdx, maxValue);
+}
+
+__attribute__((target("avx512f")))
+int argmaxAvx512(const float* row, int n, float& maxValue) {
+    if (n < 64) return argmaxAvx2(row, n, maxValue);
+
+    const __m512i step = _mm512_set1_epi32(64);
+    __m512i c0 = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m512i c1 = _mm512_add_epi32(c0, _mm512_set1_epi32(16));
+    __m512i c2 = _mm512_add_epi32(c0, _mm512_set1_epi32(32));
+    __m512i c3 = _mm512_add_epi32(c0, _mm512_set1_epi32(48));
+
+    __m512 m0 = _mm512_loadu_ps(row);
+    __m512 m1 = _mm512_loadu_ps(row + 16);
+    __m512 m2 = _mm512_loadu_ps(row + 32);
+    __m512 m3 = _mm512_loadu_ps(row + 48);
+    __m512i i0 = c0, i1 = c1, i2 = c2, i3 = c3;
+
+    int c = 64;
+    for (; c + 64 <= n; c += 64) {
+        c0 = _mm512_add_epi32(c0, step);
+        c1 = _mm512_add_epi32(c1, step);
+        c2 = _mm512_add_epi32(c2, step);
+        c3 = _mm512_add_epi32(c3, step);
+
+        __m512 v0 = _mm512_loadu_ps(row + c);
+        __m512 v1 = _mm512_loadu_ps(row + c + 16);
+        __m512 v2 = _mm512_loadu_ps(row + c + 32);
+        __m512 v3 = _mm512_loadu_ps(row + c + 48);
+
+        __mmask16 g0 = _mm512_cmp_ps_mask(v0, m0, _CMP_GT_OQ);
+        __mmask16 g1 = _mm512_cmp_ps_mask(v1, m1, _CMP_GT_OQ);
+        __mmask16 g2 = _mm512_cmp_ps_mask(v2, m2, _CMP_GT_OQ);
+        __mmask16 g3 = _mm512_cmp_ps_mask(v3, m3, _CMP_GT_OQ);
+
+        m0 = _mm512_mask_blend_ps(g0, m0, v0);
+        m1 = _mm512_mask_blend_ps(g1, m1, v1);
+        m2 = _mm512_mask_blend_ps(g2, m2, v2);
+        m3 = _mm512_mask_blend_ps(g3, m3, v3);
+
+        i0 = _mm512_mask_blend_epi32(g0, i0, c0);
+        i1 = _mm512_mask_blend_epi32(g1, i1, c1);
+        i2 = _mm512_mask_blend_epi32(g2, i2, c2);
+        i3 = _mm512_mask_blend_epi32(g3, i3, c3);
+    }
+
+    alignas(64) float values[64];
+    alignas(64) int32_t indices[64];
+    _mm512_store_ps(values, m0);
+    _mm512_store_ps(values + 16, m1);
+    _mm512_store_ps(values + 32, m2);
+    _mm512_store_ps(values + 48, m3);
+    _mm512_store_si512(indices, i0);
+    _mm512_store_si512(indices + 16, i1);
+    _mm512_store_si512(indices + 32, i2);
+    _mm512_store_si512(indices + 48, i3);
+
+    int maxIdx = reduceLanes(values, indices, 64, maxValue);
+    return scanTail(row, c, n, maxIdx, maxValue);
+}
+#endif
+
+#ifdef CTC_KERNELS_HAVE_NEON
+int argmaxNeon(const float* row, int n, float& maxValue) {
+    if (n < 16) return argmaxScalar(row, n, maxValue);
+
+    const uint32x4_t step = vdupq_n_u32(16);
+    const uint32_t base[4] = {0, 1, 2, 3};
+    uint32x4_t c0 = vld1q_u32(base);
+    uint32x4_t c1 = vaddq_u32(c0, vdupq_n_u32(4));
+    uint32x4_t c2 = vaddq_u32(c0, vdupq_n_u32(8));
+    uint32x4_t c3 = vaddq_u32(c0, vdupq_n_u32(12));
+
+    float32x4_t m0 = vld1q_f32(row);
+    float32x4_t m1 = vld1q_f32(row + 4);
+    float32x4_t m2 = vld1q_f32(row + 8);
+    float32x4_t m3 = vld1q_f32(row + 12);
+    uint32x4_t i0 = c0, i1 = c1, i2 = c2, i3 = c3;
+
+    int c = 16;
+    for (; c + 16 <= n; c += 16) {
+        c0 = vaddq_u32(c0, step);
+        c1 = vaddq_u32(c1, step);
+        c2 = vaddq_u32(c2, step);
+        c3 = vaddq_u32(c3, step);
+
+        float32x4_t v0 = vld1q_f32(row + c);
+        float32x4_t v1 = vld1q_f32(row + c + 4);
+        float32x4_t v2 = vld1q_f32(row + c + 8);
+        float32x4_t v3 = vld1q_f32(row + c + 12);
+
+        uint32x4_t g0 = vcgtq_f32(v0, m0);
+        uint32x4_t g1 = vcgtq_f32(v1, m1);
+        uint32x4_t g2 = vcgtq_f32(v2, m2);
+        uint32x4_t g3 = vcgtq_f32(v3, m3);
+
+        m0 = vbslq_f32(g0, v0, m0);
+        m1 = vbslq_f32(g1, v1, m1);
+        m2 = vbslq_f32(g2, v2, m2);
+        m3 = vbslq_f32(g3, v3, m3);
+
+        i0 = vbslq_u32(g0, c0, i0);
+        i1 = vbslq_u32(g1, c1, i1);
+        i2 = vbslq_u32(g2, c2, i2);
+        i3 = vbslq_u32(g3, c3, i3);
+    }
+
+    float values[16];
+    int32_t indices[16];
+    vst1q_f32(values, m0);
+    vst1q_f32(values + 4, m1);
+    vst1q_f32(values + 8, m2);
+    vst1q_f32(values + 12, m3);
+    vst1q_s32(indices, vreinterpretq_s32_u32(i0));
+    vst1q_s32(indices + 4, vreinterpretq_s32_u32(i1));
+    vst1q_s32(indices + 8, vreinterpretq_s32_u32(i2));
+    vst1q_s32(indices + 12, vreinterpretq_s32_u32(i3));
+
+    int maxIdx = reduceLanes(values, indices, 16, maxValue);
+    return scanTail(row, c, n, maxIdx, maxValue);
+}
+#endif
+
+struct Dispatch {
+    ArgmaxKernel kernel = argmaxScalar;
+    simd::Isa isa = simd::Isa::Scalar;
+
+    Dispatch() {
+#ifdef CTC_KERNELS_HAVE_X86
+        if (simd::hasAvx512()) {
+            kernel = argmaxAvx512;
+            isa = simd::Isa::AVX512;
+        } else if (simd::hasAvx2()) {
+            kernel = argmaxAvx2;
+            isa = simd::Isa::AVX2;
+        }
+#endif
+#ifdef CTC_KERNELS_HAVE_NEON
+        kernel = argmaxNeon;
+        isa = simd::Isa::NEON;
+#endif
+    }
+};
+
+const Dispatch& dispatch() {
+    static const Dispatch instance;
+    return instance;
+}
+
+} // namespace
+
+int argmaxScalar(const float* row, int n, float& maxValue) {
+    maxValue = row[0];
+    return scanTail(row, 1, n, 0, maxValue);
+}
+
+int argmaxIndexed(const float* row, const int* classes, int count, float& maxValue) {
+    int maxIdx = classes[0];
+    maxValue = row[maxIdx];
+    for (int i = 1; i < count; i++) {
+        float v = row[classes[i]];
+        if (v > maxValue) {
+            maxValue = v;
+            maxIdx = classes[i];
+        }
+    }
+    return maxIdx;
+}
+
+int argmax(const float* row, int n, float& maxValue) {
+    return dispatch().kernel(row, n, maxValue);
+}
+
+const char* argmaxIsaName() {
+    return simd::isaName(dispatch().isa);
+}
+
+} // namespace ctc_kernels
+} // namespace ocr
@@ -1,12 +1,31 @@
 #include "recognition/rec_postprocess.h"
+#include "recognition/ctc_kernels.h"
 #include "common/logger.hpp"
 #include <fstream>
 #include <algorithm>
-#include <numeric>
 #include <cstring>
 
 namespace ocr {
 
+namespace {
+
+// decode() 在栈上解码，超过此长度才使用堆缓冲
+constexpr size_t kStackTextBytes = 2048;
+
+// 编译后的字符集缓存上限（超过后整体清空）
+constexpr size_t kCharsetCacheSize = 64;
+
+// UTF-8 首字节对应的字符长度（非法首字节按 1 字节处理）
+size_t utf8Length(unsigned char lead) {
+    if (lead < 0x80) return 1;
+    if ((lead >> 5) == 0x6) return 2;
+    if ((lead >> 4) == 0xE) return 3;
+    if ((lead >> 3) == 0x1E) return 4;
+    return 1;
+}
+
+} // namespace
+
 CTCDecoder::CTCDecoder(const std::string& dict_path, bool use_space_char)
     : use_space_char_(use_space_char), blank_index_(0) {
     
@@ -15,6 +34,11 @@ CTCDecoder::CTCDecoder(const std::string& dict_path, bool use_space_char)
     }
 }
 
+CTCDecoder::CTCDecoder(const std::vector<std::string>& characters, bool use_space_char)
+    : use_space_char_(use_space_char), blank_index_(0) {
+    buildTable(characters, use_space_char);
+}
+
 bool CTCDecoder::loadDictionary(const std::string& dict_path, bool use_space_char) {
     std::ifstream file(dict_path, std::ios::binary);
     if (!file.is_open()) {
@@ -22,11 +46,8 @@ bool CTCDecoder::loadDictionary(const std::string& dict_path, bool use_space_cha
         return false;
     }
     
-    // 添加 blank 字符作为索引0
-    character_dict_.clear();
-    character_dict_.push_back("blank");
-    
     // 读取字典文件 (UTF-8编码)
+    std::vector<std::string> characters;
     std::string line;
     while (std::getline(file, line)) {
         // 移除换行符
@@ -38,31 +59,118 @@ bool CTCDecoder::loadDictionary(const std::string& dict_path, bool use_space_cha
         }
         
         if (!line.empty()) {
-            character_dict_.push_back(line);
+            characters.push_back(line);
         }
     }
     
+    file.close();
+    
+    buildTable(characters, use_space_char);
+    
+    LOG_INFO("Loaded dictionary with {} characters (including blank)", getDictSize());
+    LOG_DEBUG("First few chars: blank, {}, {}, {}", 
+              getDictSize() > 1 ? getChar(1) : "N/A",
+              getDictSize() > 2 ? getChar(2) : "N/A",
+              getDictSize() > 3 ? getChar(3) : "N/A");
+    
+    return true;
+}
+
+void CTCDecoder::buildTable(const std::vector<std::string>& characters, bool use_space_char) {
+    dict_chars_.clear();
+    dict_offsets_.clear();
+    max_char_bytes_ = 1;
+    
+    size_t total = 0;
+    for (const auto& ch : characters) {
+        total += ch.size();
+    }
+    dict_chars_.reserve(total + 1);
+    dict_offsets_.reserve(characters.size() + 3);
+    
+    // 添加 blank 字符作为索引0（不输出任何字节）
+    dict_offsets_.push_back(0);
+    dict_offsets_.push_back(0);
+    
+    auto append = [this](const std::string& ch) {
+        dict_chars_ += ch;
+        dict_offsets_.push_back(static_cast<uint32_t>(dict_chars_.size()));
+        max_char_bytes_ = std::max(max_char_bytes_, ch.size());
+    };
+    for (const auto& ch : characters) {
+        append(ch);
+    }
+    
     // 如果使用空格，添加空格字符
     if (use_space_char) {
-        character_dict_.push_back(" ");
+        append(" ");
     }
     
-    file.close();
+    // dict_chars_ 不再变化，字符索引可以直接引用其中的字节
+    char_index_.clear();
+    char_index_.reserve(getDictSize());
+    for (size_t i = 1; i < getDictSize(); i++) {
+        char_index_.emplace(getChar(static_cast<int>(i)), static_cast<int>(i));
+    }
     
-    LOG_INFO("Loaded dictionary with {} characters (including blank)", 
-             character_dict_.size());
-    LOG_DEBUG("First few chars: blank, {}, {}, {}", 
-              character_dict_.size() > 1 ? character_dict_[1] : "N/A",
-              character_dict_.size() > 2 ? character_dict_[2] : "N/A",
-              character_dict_.size() > 3 ? character_dict_[3] : "N/A");
+    std::lock_guard<std::mutex> lock(charset_mutex_);
+    charset_cache_.clear();
+}
+
+bool CTCDecoder::compileCharset(const std::string& charset, CharsetIndexPtr& compiled) const {
+    compiled = nullptr;
+    if (charset.empty()) {
+        return true;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(charset_mutex_);
+        auto it = charset_cache_.find(charset);
+        if (it != charset_cache_.end()) {
+            compiled = it->second;
+            return true;
+        }
+    }
+    
+    CharsetIndex indices;
+    indices.push_back(blank_index_);
+    int unknown = 0;
+    for (size_t i = 0; i < charset.size();) {
+        size_t len = std::min(utf8Length(static_cast<unsigned char>(charset[i])), charset.size() - i);
+        auto it = char_index_.find(std::string_view(charset.data() + i, len));
+        if (it != char_index_.end()) {
+            indices.push_back(it->second);
+        } else {
+            unknown++;
+        }
+        i += len;
+    }
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    
+    // 只剩 blank 时解码结果恒为空串，不能当作"不限制"或静默返回空结果
+    if (indices.size() == 1) {
+        LOG_ERROR("allowedCharset: none of the {} characters is in the dictionary", unknown);
+        return false;
+    }
+    if (unknown > 0) {
+        LOG_WARN("allowedCharset: {} characters not in dictionary, ignored", unknown);
+    }
+    LOG_DEBUG("Compiled allowedCharset to {} classes (including blank)", indices.size());
     
+    compiled = std::make_shared<const CharsetIndex>(std::move(indices));
+    std::lock_guard<std::mutex> lock(charset_mutex_);
+    if (charset_cache_.size() >= kCharsetCacheSize) {
+        charset_cache_.clear();
+    }
+    charset_cache_.emplace(charset, compiled);
     return true;
 }
 
-std::pair<std::string, float> CTCDecoder::decode(const dxrt::TensorPtr& output) {
+const float* CTCDecoder::checkOutput(const dxrt::TensorPtr& output, int& time_steps) const {
     if (!output) {
         LOG_ERROR("Output tensor is null");
-        return {"", 0.0f};
+        return nullptr;
     }
     
     auto shape = output->shape();
@@ -70,104 +178,141 @@ std::pair<std::string, float> CTCDecoder::decode(const dxrt::TensorPtr& output)
     if (shape.size() != 3) {
         LOG_ERROR("Expected 3D output [batch, time_steps, num_classes], got {} dimensions", 
                   shape.size());
-        return {"", 0.0f};
+        return nullptr;
     }
     
     int batch_size = shape[0];
-    int time_steps = shape[1];
+    time_steps = shape[1];
     int num_classes = shape[2];
     
     if (batch_size != 1) {
         LOG_WARN("Batch size is {}, only processing first sample", batch_size);
     }
     
-    if (num_classes != static_cast<int>(character_dict_.size())) {
+    if (num_classes != static_cast<int>(getDictSize())) {
         LOG_ERROR("Dictionary size mismatch: model={}, dict={}", 
-                  num_classes, character_dict_.size());
-        return {"", 0.0f};
+                  num_classes, getDictSize());
+        return nullptr;
     }
     
     // 获取数据指针
-    const float* data = reinterpret_cast<const float*>(output->data());
+    return reinterpret_cast<const float*>(output->data());
+}
+
+std::pair<std::string, float> CTCDecoder::decodeSpan(const float* logits, int t_begin, int t_end,
+                                                     const CharsetIndex* allowed) const {
+    int time_steps = t_end - t_begin;
+    if (time_steps <= 0) {
+        return {"", 0.0f};
+    }
     
-    // Step 1: Argmax - 获取每个时间步的最大概率索引
-    std::vector<int> pred_indices;
-    std::vector<float> pred_probs;
+    // 解码到栈缓冲（超长时退回堆缓冲），只在返回时构造一次 std::string
+    char stack_text[kStackTextBytes];
+    std::string heap_text;
+    size_t capacity = maxTextBytes(time_steps);
+    char* text = stack_text;
+    if (capacity > sizeof(stack_text)) {
+        heap_text.resize(capacity);
+        text = &heap_text[0];
+    }
     
-    pred_indices.reserve(time_steps);
-    pred_probs.reserve(time_steps);
+    size_t length = 0;
+    float confidence = decodeInto(logits + static_cast<size_t>(t_begin) * getDictSize(), time_steps,
+                                  text, capacity, length, allowed);
+    return {std::string(text, length), confidence};
+}
+
+std::pair<std::string, float> CTCDecoder::decode(const dxrt::TensorPtr& output,
+                                                 const CharsetIndex* allowed) {
+    int time_steps = 0;
+    const float* data = checkOutput(output, time_steps);
+    if (!data) {
+        return {"", 0.0f};
+    }
+    return decodeSpan(data, 0, time_steps, allowed);
+}
+
+std::vector<std::pair<std::string, float>> CTCDecoder::decodeColumns(
+    const dxrt::TensorPtr& output, int input_width,
+    const std::vector<std::pair<int, int>>& columns,
+    const CharsetIndex* allowed) {
+    int time_steps = 0;
+    const float* data = checkOutput(output, time_steps);
+    if (!data) {
+        return std::vector<std::pair<std::string, float>>(columns.size(), {"", 0.0f});
+    }
+    return decodeColumns(data, time_steps, input_width, columns, allowed);
+}
+
+std::vector<std::pair<std::string, float>> CTCDecoder::decodeColumns(
+    const float* logits, int time_steps, int input_width,
+    const std::vector<std::pair<int, int>>& columns,
+    const CharsetIndex* allowed) const {
+    std::vector<std::pair<std::string, float>> results(columns.size(), {"", 0.0f});
+    if (!logits || time_steps <= 0 || input_width <= 0) {
+        return results;
+    }
     
-    for (int t = 0; t < time_steps; t++) {
-        const float* timestep_data = data + t * num_classes;
-        
-        // 找到最大值索引和概率
-        int max_idx = 0;
-        float max_prob = timestep_data[0];
-        
-        for (int c = 1; c < num_classes; c++) {
-            if (timestep_data[c] > max_prob) {
-                max_prob = timestep_data[c];
-                max_idx = c;
-            }
+    // 列 -> 时间步：每个时间步覆盖 input_width / time_steps 列
+    for (size_t i = 0; i < columns.size(); i++) {
+        int64_t x0 = std::max(0, columns[i].first);
+        int64_t x1 = std::min(input_width, columns[i].second);
+        if (x1 <= x0) {
+            continue;
         }
-        
-        pred_indices.push_back(max_idx);
-        pred_probs.push_back(max_prob);
+        int t_begin = static_cast<int>(x0 * time_steps / input_width);
+        int t_end = static_cast<int>((x1 * time_steps + input_width - 1) / input_width);
+        results[i] = decodeSpan(logits, t_begin, std::min(t_end, time_steps), allowed);
     }
-    
-    // Step 2-5: CTC解码
-    return decodeSequence(pred_indices, pred_probs);
+    return results;
 }
 
-std::pair<std::string, float> CTCDecoder::decodeSequence(
-    const std::vector<int>& indices,
-    const std::vector<float>& probs) {
-    
-    if (indices.empty()) {
-        return {"", 0.0f};
+float CTCDecoder::decodeInto(const float* logits, int time_steps,
+                             char* text, size_t capacity, size_t& length,
+                             const CharsetIndex* allowed) const {
+    length = 0;
+    const int num_classes = static_cast<int>(getDictSize());
+    if (!logits || time_steps <= 0 || num_classes == 0) {
+        return 0.0f;
     }
     
-    // Step 2: 去重复 (CTC特性 - 连续相同的字符只保留一个)
-    std::vector<int> deduped_indices;
-    std::vector<float> deduped_probs;
+    // 字符集约束：只在允许的类别上取 argmax
+    const int* classes = (allowed && !allowed->empty()) ? allowed->data() : nullptr;
+    const int class_count = classes ? static_cast<int>(allowed->size()) : 0;
     
-    deduped_indices.push_back(indices[0]);
-    deduped_probs.push_back(probs[0]);
+    // 单次遍历完成: argmax -> 去重复 -> 去 blank -> 拼接文本 -> 累加置信度
+    float conf_sum = 0.0f;
+    int conf_count = 0;
+    int prev_idx = -1;
     
-    for (size_t i = 1; i < indices.size(); i++) {
-        if (indices[i] != indices[i-1]) {
-            deduped_indices.push_back(indices[i]);
-            deduped_probs.push_back(probs[i]);
+    for (int t = 0; t < time_steps; t++) {
+        const float* row = logits + static_cast<size_t>(t) * num_classes;
+        float max_prob = 0.0f;
+        int max_idx = classes ? ctc_kernels::argmaxIndexed(row, classes, class_count, max_prob)
+                              : ctc_kernels::argmax(row, num_classes, max_prob);
+        
+        // CTC特性 - 连续相同的字符只保留一个，blank 不输出
+        if (max_idx == prev_idx) {
+            continue;
         }
-    }
-    
-    // Step 3: 去除 blank (index=0)
-    std::string text;
-    std::vector<float> confidences;
-    
-    for (size_t i = 0; i < deduped_indices.size(); i++) {
-        if (deduped_indices[i] != blank_index_) {
-            int char_idx = deduped_indices[i];
-            
-            // 边界检查
-            if (char_idx >= 0 && char_idx < static_cast<int>(character_dict_.size())) {
-                text += character_dict_[char_idx];
-                confidences.push_back(deduped_probs[i]);
-            } else {
-                LOG_WARN("Character index {} out of bounds (dict size: {})", 
-                         char_idx, character_dict_.size());
-            }
+        prev_idx = max_idx;
+        if (max_idx == blank_index_) {
+            continue;
         }
+        
+        uint32_t begin = dict_offsets_[max_idx];
+        uint32_t bytes = dict_offsets_[max_idx + 1] - begin;
+        if (length + bytes > capacity) {
+            continue;
+        }
+        std::memcpy(text + length, dict_chars_.data() + begin, bytes);
+        length += bytes;
+        conf_sum += max_prob;
+        conf_count++;
     }
     
-    // Step 4: 计算平均置信度
-    float avg_confidence = 0.0f;
-    if (!confidences.empty()) {
-        avg_confidence = std::accumulate(confidences.begin(), confidences.end(), 0.0f) 
-                        / confidences.size();
-    }
-    
-    return {text, avg_confidence};
+    // 计算平均置信度
+    return conf_count > 0 ? conf_sum / conf_count : 0.0f;
 }
 
 } // namespace ocr
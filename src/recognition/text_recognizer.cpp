@@ -2,12 +2,20 @@
 #include "recognition/rec_postprocess.h"
 #include "preprocessing/image_ops.h"
 #include "common/geometry.h"
+#include "common/hash.hpp"
 #include "common/logger.hpp"
 #include <algorithm>
 #include <cmath>
 
 namespace DeepXOCR {
 
+// Idle input buffers kept per ratio model
+static constexpr size_t kInputPoolIdle = 32;
+
+// Packed crops start on multiples of the rec models' CTC stride (8 columns per
+// time step), so crop boundaries fall on time-step boundaries
+static constexpr int kPackAlignment = 8;
+
 TextRecognizer::TextRecognizer(const RecognizerConfig& config)
     : config_(config) {
 }
@@ -24,6 +32,8 @@ bool TextRecognizer::Initialize() {
         try {
             auto model = std::make_unique<dxrt::InferenceEngine>(model_path);
             models_[ratio] = std::move(model);
+            inputPools_[ratio] = ocr::BufferPool::create(config_.inputHeight, InputWidth(ratio),
+                                                         CV_8UC3, kInputPoolIdle);
             LOG_INFO("  Loaded ratio_{} model: {}", ratio, model_path);
         } catch (const std::exception& e) {
             LOG_ERROR("Failed to load ratio_{} model: {}", ratio, e.what());
@@ -45,6 +55,10 @@ bool TextRecognizer::Initialize() {
         return false;
     }
     
+    if (config_.resultCacheSize > 0) {
+        resultCache_ = std::make_unique<ocr::StripedLruCache<CachedRecognition>>(config_.resultCacheSize);
+    }
+    
     LOG_INFO("TextRecognizer initialized successfully");
     LOG_INFO("  Models: {} ratios", models_.size());
     LOG_INFO("  Dictionary: {} characters", decoder_->getDictSize());
@@ -133,7 +147,11 @@ std::vector<std::pair<std::string, float>> TextRecognizer::RecognizeBatch(
 }
 
 dxrt::InferenceEngine* TextRecognizer::SelectModel(const cv::Mat& image) {
-    int ratio = CalculateRatio(image.cols, image.rows);
+    return SelectModel(image.cols, image.rows);
+}
+
+dxrt::InferenceEngine* TextRecognizer::SelectModel(int width, int height) {
+    int ratio = CalculateRatio(width, height);
     
     // Track model usage statistics
     model_usage_[ratio]++;
@@ -166,7 +184,7 @@ dxrt::InferenceEngine* TextRecognizer::SelectModel(const cv::Mat& image) {
     return nullptr;
 }
 
-int TextRecognizer::CalculateRatio(int width, int height) {
+int TextRecognizer::CalculateRatio(int width, int height) const {
     if (height == 0) {
         return 35;  // 默认最大ratio
     }
@@ -182,21 +200,28 @@ int TextRecognizer::CalculateRatio(int width, int height) {
     return 35;
 }
 
+int TextRecognizer::InputWidth(int ratio) const {
+    // Python的映射：ratio_3 -> 120, ratio_5 -> 240, ratio_10 -> 480, ...
+    if (ratio == 3) {
+        return 120;  // Special case: 120 instead of 144
+    }
+    return config_.inputHeight * ratio;
+}
+
 cv::Mat TextRecognizer::Preprocess(const cv::Mat& image, int ratio) {
+    cv::Mat resized;
+    PreprocessInto(image, ratio, resized);
+    return resized;
+}
+
+void TextRecognizer::PreprocessInto(const cv::Mat& image, int ratio, cv::Mat& resized) {
     // Recognition预处理 (完全按照Python来):
     // DXNN模型内部会自动处理归一化，所以只需要:
     // 1. resize (mode=ppocr, pad + resize)
     // 输出: HWC uint8 (DXNN内部会处理归一化)
     
     int target_height = config_.inputHeight;  // 48
-    int target_width;
-    
-    // Python的映射：ratio_3 -> 120, ratio_5 -> 240, ratio_10 -> 480, ...
-    if (ratio == 3) {
-        target_width = 120;  // Special case: 120 instead of 144
-    } else {
-        target_width = target_height * ratio;
-    }
+    int target_width = InputWidth(ratio);
     
     LOG_DEBUG("Preprocessing: {}x{} -> {}x{} (ratio_{})",
               image.cols, image.rows, target_width, target_height, ratio);
@@ -220,11 +245,10 @@ cv::Mat TextRecognizer::Preprocess(const cv::Mat& image, int ratio) {
         cv::copyMakeBorder(image, padded, 0, 0, 0, pad_w,
                           cv::BORDER_CONSTANT, PAD_COLOR);
     } else {
-        padded = image.clone();
+        padded = image;  // resize 只读源图，无需拷贝
     }
     
-    // Resize到目标尺寸
-    cv::Mat resized;
+    // Resize到目标尺寸（resized 已是目标尺寸时直接写入，不重新分配）
     cv::resize(padded, resized, cv::Size(target_width, target_height));
     
     // 确保连续内存和正确类型 (uint8 HWC)
@@ -234,18 +258,25 @@ cv::Mat TextRecognizer::Preprocess(const cv::Mat& image, int ratio) {
     
     LOG_DEBUG("Preprocessed: input {}x{} -> padded {}x{} -> resized {}x{} HWC uint8",
               image.cols, image.rows, padded.cols, padded.rows, target_width, target_height);
-    
-    return resized;
 }
 
-std::pair<std::string, float> TextRecognizer::Postprocess(dxrt::TensorPtrs& outputs) {
+std::pair<std::string, float> TextRecognizer::Postprocess(dxrt::TensorPtrs& outputs,
+                                                           const ocr::CharsetIndex* allowed) {
     if (outputs.empty()) {
         LOG_ERROR("Empty output tensors");
         return {"", 0.0f};
     }
     
     // 使用CTC解码器
-    return decoder_->decode(outputs[0]);
+    return decoder_->decode(outputs[0], allowed);
+}
+
+bool TextRecognizer::CompileCharset(const std::string& charset, ocr::CharsetIndexPtr& compiled) const {
+    if (!decoder_) {
+        compiled = nullptr;
+        return charset.empty();
+    }
+    return decoder_->compileCharset(charset, compiled);
 }
 
 void TextRecognizer::PrintModelUsageStats() const {
@@ -272,8 +303,12 @@ void TextRecognizer::PrintModelUsageStats() const {
 
 // Context for async recognition
 struct RecognitionContext {
-    cv::Mat preprocessed;  // Keep preprocessed image alive during async inference
+    ocr::BufferLease input;  // Pooled input buffer, returned to its pool when the context is deleted
+    ocr::CharsetIndexPtr allowed;  // Charset constraint for decoding (nullptr = full dictionary)
     void* userArg;
+    std::vector<PackedSegment> segments;  // Packed input: one entry per crop (userArg unused)
+    uint64_t cacheKey = 0;                // Result cache key (single-crop inputs only)
+    bool cacheable = false;
 };
 
 void TextRecognizer::RegisterCallback(std::function<void(const std::string&, float, void*)> callback) {
@@ -290,7 +325,8 @@ void TextRecognizer::RegisterCallback(std::function<void(const std::string&, flo
     }
 }
 
-int TextRecognizer::RecognizeAsync(const cv::Mat& textImage, void* userArg) {
+int TextRecognizer::RecognizeAsync(const cv::Mat& textImage, void* userArg,
+                                   ocr::CharsetIndexPtr allowed) {
     if (textImage.empty()) {
         LOG_ERROR("Input image is empty");
         if (userCallback_) {
@@ -310,11 +346,12 @@ int TextRecognizer::RecognizeAsync(const cv::Mat& textImage, void* userArg) {
         return -1;
     }
     
-    // Get ratio and preprocess
+    // Get ratio and preprocess straight into a pooled input buffer
     int ratio = CalculateRatio(textImage.cols, textImage.rows);
-    cv::Mat preprocessed = Preprocess(textImage, ratio);
+    ocr::BufferLease input = AcquireInput(ratio, textImage.type());
+    PreprocessInto(textImage, ratio, input.mat());
     
-    if (preprocessed.empty()) {
+    if (input.empty()) {
         LOG_ERROR("Preprocessing failed");
         if (userCallback_) {
             userCallback_("", 0.0f, userArg);
@@ -322,20 +359,216 @@ int TextRecognizer::RecognizeAsync(const cv::Mat& textImage, void* userArg) {
         return -1;
     }
     
-    // Ensure continuous memory
-    if (!preprocessed.isContinuous()) {
-        preprocessed = preprocessed.clone();
+    SubmitOrServe(engine, ratio, std::move(input), userArg, std::move(allowed));
+    return 0;
+}
+
+int TextRecognizer::RecognizeRegionAsync(const cv::Mat& image, const ocr::TextCropGeometry& geom,
+                                         bool rotate180, void* userArg,
+                                         ocr::CharsetIndexPtr allowed) {
+    if (image.empty() || geom.width < 1 || geom.height < 1) {
+        LOG_ERROR("Input image or text region is empty");
+        if (userCallback_) {
+            userCallback_("", 0.0f, userArg);
+        }
+        return -1;
     }
     
-    // Create context - store preprocessed image to keep it alive during async inference
-    RecognitionContext* ctx = new RecognitionContext{preprocessed.clone(), userArg};
+    // Ratio is decided by the crop as it would look after vertical rotation
+    auto* engine = SelectModel(geom.outWidth(), geom.outHeight());
+    if (!engine) {
+        LOG_ERROR("No suitable model for text region {}x{}", geom.outWidth(), geom.outHeight());
+        if (userCallback_) {
+            userCallback_("", 0.0f, userArg);
+        }
+        return -1;
+    }
     
-    // Submit async inference (use preprocessed.data directly, same as sync version)
-    engine->RunAsync(ctx->preprocessed.data, ctx);
+    int ratio = CalculateRatio(geom.outWidth(), geom.outHeight());
+    ocr::BufferLease input = AcquireInput(ratio, image.type());
+    ocr::renderRecognitionInput(image, geom, rotate180, InputWidth(ratio), config_.inputHeight, input.mat());
     
+    SubmitOrServe(engine, ratio, std::move(input), userArg, std::move(allowed));
     return 0;
 }
 
+// ==================== Crop-level Result Cache ====================
+
+uint64_t TextRecognizer::CacheKey(const cv::Mat& input, int ratio, const ocr::CharsetIndex* allowed) const {
+    // The same pixels decode differently under a different model or charset constraint
+    uint64_t seed = static_cast<uint64_t>(ratio);
+    if (allowed) {
+        seed = ocr::xxh64(allowed->data(), allowed->size() * sizeof(int), seed);
+    }
+    return ocr::hashMat(input, seed);
+}
+
+bool TextRecognizer::ServeFromCache(uint64_t key, void* userArg) {
+    CachedRecognition cached;
+    if (!resultCache_ || !resultCache_->get(key, cached)) {
+        return false;
+    }
+    if (cached.confidence < config_.confThreshold) {
+        cached.text.clear();
+    }
+    LOG_DEBUG("Recognition cache hit: text='{}', conf={:.4f}", cached.text, cached.confidence);
+    if (userCallback_) {
+        userCallback_(cached.text, cached.confidence, userArg);
+    }
+    return true;
+}
+
+void TextRecognizer::SubmitOrServe(dxrt::InferenceEngine* engine, int ratio, ocr::BufferLease input,
+                                   void* userArg, ocr::CharsetIndexPtr allowed) {
+    if (!resultCache_) {
+        SubmitAsync(engine, std::move(input), userArg, std::move(allowed));
+        return;
+    }
+    uint64_t key = CacheKey(input.mat(), ratio, allowed.get());
+    if (ServeFromCache(key, userArg)) {
+        return;  // input returns to its pool here
+    }
+    RecognitionContext* ctx = new RecognitionContext{std::move(input), std::move(allowed), userArg, {}, key, true};
+    engine->RunAsync(ctx->input.data(), ctx);
+}
+
+TextRecognizer::CacheStats TextRecognizer::GetCacheStats() const {
+    return resultCache_ ? resultCache_->stats() : CacheStats{};
+}
+
+// ==================== Multi-crop Packing ====================
+
+int TextRecognizer::ScaledWidth(const ocr::TextCropGeometry& geom) const {
+    double scale = static_cast<double>(config_.inputHeight) / geom.outHeight();
+    return std::max(1, static_cast<int>(std::lround(geom.outWidth() * scale)));
+}
+
+int TextRecognizer::PackRatio(int minWidth) const {
+    for (const auto& [ratio, _] : models_) {
+        if (ratio > config_.packMaxRatio && ratio >= config_.packTargetRatio && InputWidth(ratio) >= minWidth) {
+            return ratio;
+        }
+    }
+    return -1;
+}
+
+bool TextRecognizer::IsPackable(const ocr::TextCropGeometry& geom) const {
+    if (!config_.enablePacking || geom.width < 1 || geom.height < 1) {
+        return false;
+    }
+    return CalculateRatio(geom.outWidth(), geom.outHeight()) <= config_.packMaxRatio &&
+           PackRatio(ScaledWidth(geom)) != -1;
+}
+
+int TextRecognizer::RecognizePackedAsync(const cv::Mat& image, const std::vector<PackedCrop>& crops,
+                                         ocr::CharsetIndexPtr allowed) {
+    if (crops.empty()) {
+        return 0;
+    }
+    
+    int widest = PackRatio(0) == -1 ? -1 : InputWidth(models_.rbegin()->first);
+    if (image.empty() || widest <= 0) {
+        LOG_ERROR("Cannot pack {} crops: empty image or no wide recognition model", crops.size());
+        if (userCallback_) {
+            for (const auto& crop : crops) {
+                userCallback_("", 0.0f, crop.userArg);
+            }
+        }
+        return 0;
+    }
+    
+    // Greedy left-to-right fill of the widest input
+    std::vector<int> widths;
+    widths.reserve(crops.size());
+    for (const auto& crop : crops) {
+        widths.push_back(ScaledWidth(*crop.geom));
+    }
+    auto groups = PlanPacking(widths, widest, config_.packSeparatorWidth, kPackAlignment);
+    for (const auto& group : groups) {
+        SubmitPacked(image, &crops[group.begin], group, allowed);
+    }
+    
+    LOG_DEBUG("Packed {} short crops into {} recognition inputs", crops.size(), groups.size());
+    return static_cast<int>(groups.size());
+}
+
+std::vector<PackedGroup> TextRecognizer::PlanPacking(const std::vector<int>& widths, int capacity,
+                                                     int separator, int alignment) {
+    std::vector<PackedGroup> groups;
+    alignment = std::max(alignment, 1);
+    int x = 0;
+    for (size_t i = 0; i < widths.size(); i++) {
+        if (groups.empty() || (!groups.back().columns.empty() && x + widths[i] > capacity)) {
+            groups.push_back(PackedGroup{i, {}});
+            x = 0;
+        }
+        groups.back().columns.emplace_back(x, x + widths[i]);
+        // Next crop starts after the separator, on a CTC time-step boundary
+        x = (x + widths[i] + separator + alignment - 1) / alignment * alignment;
+    }
+    return groups;
+}
+
+void TextRecognizer::SubmitPacked(const cv::Mat& image, const PackedCrop* crops, const PackedGroup& group,
+                                  const ocr::CharsetIndexPtr& allowed) {
+    size_t count = group.columns.size();
+    if (count == 1) {
+        // Nothing to pack with: regular per-crop input
+        RecognizeRegionAsync(image, *crops[0].geom, crops[0].rotate180, crops[0].userArg, allowed);
+        return;
+    }
+    
+    // Column layout: crops left to right, separated by blank (padding-colored) columns
+    std::vector<PackedSegment> segments;
+    segments.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        segments.push_back({group.columns[i].first, group.columns[i].second, crops[i].userArg});
+    }
+    
+    // Narrowest wide model that holds the row (ratio_25 when it fits, else ratio_35)
+    int used = segments.back().x1;
+    int ratio = PackRatio(used);
+    int width = InputWidth(ratio);
+    model_usage_[ratio]++;
+    
+    ocr::BufferLease input = AcquireInput(ratio, image.type());
+    if (input.empty()) {
+        input = ocr::BufferLease::unpooled(cv::Mat(config_.inputHeight, width, image.type()));
+    }
+    cv::Mat& canvas = input.mat();
+    canvas.setTo(cv::Scalar(114, 114, 114));
+    for (size_t i = 0; i < count; i++) {
+        // Same PPOCR pad path as an unpacked crop: the segment already has the crop's aspect
+        // ratio, so this is the unpacked rendering without the right-hand pad
+        int w = segments[i].x1 - segments[i].x0;
+        cv::Mat dst = canvas(cv::Rect(segments[i].x0, 0, w, config_.inputHeight));
+        ocr::renderRecognitionInput(image, *crops[i].geom, crops[i].rotate180, w, config_.inputHeight, dst);
+    }
+    
+    LOG_DEBUG("Packed {} crops into ratio_{} input ({}/{} columns)", count, ratio, used, width);
+    SubmitAsync(models_[ratio].get(), std::move(input), nullptr, allowed, std::move(segments));
+}
+
+ocr::BufferLease TextRecognizer::AcquireInput(int ratio, int type) {
+    auto pool = inputPools_.find(ratio);
+    if (pool != inputPools_.end() &&
+        pool->second->matches(config_.inputHeight, InputWidth(ratio), type)) {
+        return pool->second->acquire();
+    }
+    // No pool for this shape/type: preprocessing allocates a plain buffer
+    return ocr::BufferLease();
+}
+
+void TextRecognizer::SubmitAsync(dxrt::InferenceEngine* engine, ocr::BufferLease input, void* userArg,
+                                 ocr::CharsetIndexPtr allowed, std::vector<PackedSegment> segments) {
+    // Create context - owns the input buffer until the callback (no copy)
+    RecognitionContext* ctx = new RecognitionContext{std::move(input), std::move(allowed), userArg,
+                                                     std::move(segments)};
+    
+    // Submit async inference (use the input buffer directly, same as sync version)
+    engine->RunAsync(ctx->input.data(), ctx);
+}
+
 int TextRecognizer::internalCallback(dxrt::TensorPtrs& outputs, void* userArg) {
     RecognitionContext* ctx = static_cast<RecognitionContext*>(userArg);
     if (!ctx) {
@@ -345,13 +578,18 @@ int TextRecognizer::internalCallback(dxrt::TensorPtrs& outputs, void* userArg) {
         return 0;  // Return success, not error
     }
     
-    // Ensure context is deleted
+    // Ensure context is deleted (returns the input buffer to its pool)
     std::unique_ptr<RecognitionContext> ctxGuard(ctx);
     
     if (outputs.empty()) {
         LOG_ERROR("Recognition inference failed: no output tensors");
         if (userCallback_) {
-            userCallback_("", 0.0f, ctx->userArg);
+            if (ctx->segments.empty()) {
+                userCallback_("", 0.0f, ctx->userArg);
+            }
+            for (const auto& segment : ctx->segments) {
+                userCallback_("", 0.0f, segment.userArg);
+            }
         }
         return -1;
     }
@@ -363,8 +601,32 @@ int TextRecognizer::internalCallback(dxrt::TensorPtrs& outputs, void* userArg) {
               shape.size() > 0 ? std::to_string(shape[0]) + (shape.size() > 1 ? "," + std::to_string(shape[1]) : "") + (shape.size() > 2 ? "," + std::to_string(shape[2]) : "") : "empty",
               tensor->size());
     
+    // Packed input: split the CTC output back per crop by column range
+    if (!ctx->segments.empty()) {
+        std::vector<std::pair<int, int>> columns;
+        columns.reserve(ctx->segments.size());
+        for (const auto& segment : ctx->segments) {
+            columns.emplace_back(segment.x0, segment.x1);
+        }
+        auto results = decoder_->decodeColumns(tensor, ctx->input.mat().cols, columns, ctx->allowed.get());
+        for (size_t i = 0; i < results.size(); i++) {
+            auto& [text, confidence] = results[i];
+            if (confidence < config_.confThreshold) {
+                LOG_DEBUG("Low confidence filtered: text='{}', conf={:.4f}", text, confidence);
+                text.clear();
+            }
+            if (userCallback_) {
+                userCallback_(text, confidence, ctx->segments[i].userArg);
+            }
+        }
+        return 0;
+    }
+    
     // Postprocess (CTC decode)
-    auto [text, confidence] = Postprocess(outputs);
+    auto [text, confidence] = Postprocess(outputs, ctx->allowed.get());
+    if (ctx->cacheable && resultCache_) {
+        resultCache_->put(ctx->cacheKey, CachedRecognition{text, confidence});
+    }
     
     LOG_DEBUG("Recognition result: text='{}', conf={:.4f}", text.empty() ? "<empty>" : text.substr(0, 30), confidence);
     
@@ -0,0 +1,70 @@
+/**
+ * @file test_blank_page.cpp
+ * @brief 空白页判定测试（合成的 A4 300dpi 页面）
+ */
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include "preprocessing/blank_page.h"
+
+using namespace ocr;
+
+namespace {
+
+cv::Mat makePage(int value = 245) {
+    return cv::Mat(3508, 2480, CV_8UC3, cv::Scalar::all(value));
+}
+
+// 模拟一个字符：4px 笔画的方框（约 10pt 字号）
+void drawGlyph(cv::Mat& page, int x, int y, int w = 24, int h = 40, int value = 20) {
+    cv::rectangle(page, cv::Rect(x, y, w, h), cv::Scalar::all(value), 4);
+}
+
+} // namespace
+
+/**
+ * @brief 纯色页面和带扫描噪声的页面为空白页
+ */
+TEST(BlankPage, UniformPageIsBlank) {
+    EXPECT_TRUE(checkBlankPage(makePage()).blank);
+    EXPECT_TRUE(checkBlankPage(makePage(30)).blank);  // 深色底
+
+    cv::Mat noisy = makePage(237);
+    cv::Mat noise(noisy.size(), CV_8UC3);
+    cv::randn(noise, cv::Scalar::all(8), cv::Scalar::all(4));
+    cv::add(noisy, noise, noisy);
+    EXPECT_TRUE(checkBlankPage(noisy).blank);
+}
+
+/**
+ * @brief 小于缩略图像素的灰尘和边框阴影不影响判定
+ */
+TEST(BlankPage, DustAndBorderIgnored) {
+    cv::Mat page = makePage();
+    for (int i = 0; i < 200; i++) {
+        page.at<cv::Vec3b>(100 + (i * 37) % 3300, 100 + (i * 91) % 2280) = cv::Vec3b(0, 0, 0);
+    }
+    cv::rectangle(page, cv::Rect(0, 0, 40, page.rows), cv::Scalar::all(0), cv::FILLED);
+    EXPECT_TRUE(checkBlankPage(page).blank);
+}
+
+/**
+ * @brief 文本页、只有页码的页面不是空白页
+ */
+TEST(BlankPage, TextIsNotBlank) {
+    cv::Mat text = makePage();
+    for (int line = 0; line < 40; line++) {
+        for (int c = 0; c < 60; c++) {
+            drawGlyph(text, 200 + c * 34, 200 + line * 80);
+        }
+    }
+    auto check = checkBlankPage(text);
+    EXPECT_FALSE(check.blank);
+    EXPECT_GT(check.stdDev, 10.0f);
+
+    cv::Mat pageNumber = makePage();
+    drawGlyph(pageNumber, 1228, 3300);
+    check = checkBlankPage(pageNumber);
+    EXPECT_FALSE(check.blank);
+    EXPECT_GT(check.inkRatio, 0.0f);
+}
@@ -0,0 +1,118 @@
+/**
+ * @file test_buffer_pool.cpp
+ * @brief 推理输入缓冲池测试
+ * 
+ * 验证缓冲页对齐、归还后被复用、空闲上限，以及池先于租约销毁时的安全性
+ */
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+#include "common/buffer_pool.hpp"
+
+using namespace ocr;
+
+/**
+ * @brief 借出的缓冲形状正确、连续且按页对齐
+ */
+TEST(BufferPool, LeaseIsPageAligned) {
+    auto pool = BufferPool::create(48, 240, CV_8UC3);
+    BufferLease lease = pool->acquire();
+
+    ASSERT_FALSE(lease.empty());
+    EXPECT_TRUE(lease.pooled());
+    EXPECT_EQ(lease.mat().rows, 48);
+    EXPECT_EQ(lease.mat().cols, 240);
+    EXPECT_EQ(lease.mat().type(), CV_8UC3);
+    EXPECT_TRUE(lease.mat().isContinuous());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(lease.data()) % BufferPool::kAlignment, 0u);
+}
+
+/**
+ * @brief 租约析构后缓冲回到池中，下次借出复用同一块内存
+ */
+TEST(BufferPool, ReleasedBufferIsReused) {
+    auto pool = BufferPool::create(80, 160, CV_8UC3);
+    void* first = nullptr;
+    {
+        BufferLease lease = pool->acquire();
+        first = lease.data();
+        EXPECT_EQ(pool->idle(), 0u);
+    }
+    EXPECT_EQ(pool->idle(), 1u);
+
+    BufferLease again = pool->acquire();
+    EXPECT_EQ(again.data(), first);
+    EXPECT_EQ(pool->allocated(), 1u);
+    EXPECT_EQ(pool->reused(), 1u);
+}
+
+/**
+ * @brief 移动租约只转移所有权，缓冲只归还一次
+ */
+TEST(BufferPool, MoveTransfersOwnership) {
+    auto pool = BufferPool::create(16, 16, CV_8UC1);
+    BufferLease a = pool->acquire();
+    void* data = a.data();
+
+    BufferLease b = std::move(a);
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(b.data(), data);
+
+    a.reset();
+    EXPECT_EQ(pool->idle(), 0u);
+    b.reset();
+    EXPECT_EQ(pool->idle(), 1u);
+}
+
+/**
+ * @brief 超过空闲上限的缓冲在归还时直接释放
+ */
+TEST(BufferPool, IdleCountIsBounded) {
+    auto pool = BufferPool::create(16, 16, CV_8UC1, 2);
+    {
+        std::vector<BufferLease> leases;
+        for (int i = 0; i < 5; i++) {
+            leases.push_back(pool->acquire());
+        }
+        EXPECT_EQ(pool->allocated(), 5u);
+    }
+    EXPECT_EQ(pool->idle(), 2u);
+}
+
+/**
+ * @brief 在途租约持有池的引用，池的所有者先销毁也安全
+ */
+TEST(BufferPool, LeaseOutlivesOwner) {
+    auto pool = BufferPool::create(16, 16, CV_8UC1);
+    BufferLease lease = pool->acquire();
+    lease.mat().setTo(cv::Scalar(9));
+    pool.reset();
+
+    EXPECT_EQ(lease.mat().at<uint8_t>(15, 15), 9);
+    lease.reset();  // 最后一个引用，池随之释放
+}
+
+/**
+ * @brief 写入已是目标尺寸的缓冲不会重新分配（前处理可直接写入池缓冲）
+ */
+TEST(BufferPool, ResizeWritesInPlace) {
+    auto pool = BufferPool::create(48, 120, CV_8UC3);
+    BufferLease lease = pool->acquire();
+    void* data = lease.data();
+
+    cv::Mat crop(30, 70, CV_8UC3, cv::Scalar(10, 20, 30));
+    cv::resize(crop, lease.mat(), cv::Size(120, 48));
+    EXPECT_EQ(lease.data(), data);
+}
+
+/**
+ * @brief unpooled() 包装普通 cv::Mat，不归还任何池
+ */
+TEST(BufferPool, UnpooledLease) {
+    cv::Mat image(10, 10, CV_8UC3, cv::Scalar(1, 2, 3));
+    BufferLease lease = BufferLease::unpooled(image);
+    EXPECT_FALSE(lease.pooled());
+    EXPECT_EQ(lease.data(), image.data);
+}
@@ -0,0 +1,229 @@
+/**
+ * @file test_crop_scheduler.cpp
+ * @brief 识别 crop 调度器测试（手动 dispatchOnce，不启动调度线程）
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "pipeline/crop_scheduler.h"
+
+using namespace ocr;
+
+namespace {
+
+struct Submitted {
+    int64_t taskId;
+    int ratio;
+    int length;
+};
+
+CropJob makeJob(std::vector<Submitted>& log, int64_t taskId, int ratio, int length) {
+    CropJob job;
+    job.taskId = taskId;
+    job.ratio = ratio;
+    job.length = length;
+    job.submit = [&log, taskId, ratio, length]() { log.push_back({taskId, ratio, length}); };
+    return job;
+}
+
+} // namespace
+
+/**
+ * @brief 剩余 crop 最少的任务先提交
+ */
+TEST(CropScheduler, FewestRemainingTaskFirst) {
+    std::vector<Submitted> log;
+    CropScheduler scheduler(CropSchedulerConfig{64, 1});
+
+    for (int i = 0; i < 5; i++) scheduler.enqueue(makeJob(log, 1, 10, 100));
+    for (int i = 0; i < 2; i++) scheduler.enqueue(makeJob(log, 2, 10, 100));
+
+    while (scheduler.dispatchOnce() > 0) {}
+    ASSERT_EQ(log.size(), 7u);
+    EXPECT_EQ(log[0].taskId, 2);
+    EXPECT_EQ(log[1].taskId, 2);
+    EXPECT_EQ(log[2].taskId, 1);
+}
+
+/**
+ * @brief 优先级按任务全部未完成的 crop 计算：刚开始逐个入队的大页面不抢占快完成的页面
+ */
+TEST(CropScheduler, LateLargeTaskDoesNotPreemptNearlyDoneTask) {
+    std::vector<Submitted> log;
+    CropScheduler scheduler(CropSchedulerConfig{64, 1});
+
+    auto nearlyDone = std::make_shared<std::atomic<int>>(3);
+    auto largePage = std::make_shared<std::atomic<int>>(100);
+
+    for (int i = 0; i < 3; i++) {
+        CropJob job = makeJob(log, 1, 10, 100);
+        job.remaining = nearlyDone;
+        scheduler.enqueue(std::move(job));
+    }
+    // 100 个框的页面刚裁剪出第一个 crop（调度器中只排队 1 个）
+    CropJob job = makeJob(log, 2, 10, 100);
+    job.remaining = largePage;
+    scheduler.enqueue(std::move(job));
+
+    while (scheduler.dispatchOnce() > 0) {}
+    ASSERT_EQ(log.size(), 4u);
+    EXPECT_EQ(log[0].taskId, 1);
+    EXPECT_EQ(log[1].taskId, 1);
+    EXPECT_EQ(log[2].taskId, 1);
+    EXPECT_EQ(log[3].taskId, 2);
+}
+
+/**
+ * @brief 任务内长 crop 先提交，同长度保持入队顺序
+ */
+TEST(CropScheduler, LongestCropFirst) {
+    std::vector<Submitted> log;
+    CropScheduler scheduler(CropSchedulerConfig{64, 1});
+
+    scheduler.enqueue(makeJob(log, 1, 5, 200));
+    scheduler.enqueue(makeJob(log, 1, 35, 1500));
+    scheduler.enqueue(makeJob(log, 1, 10, 400));
+    scheduler.enqueue(makeJob(log, 1, 10, 450));
+
+    while (scheduler.dispatchOnce() > 0) {}
+    ASSERT_EQ(log.size(), 4u);
+    EXPECT_EQ(log[0].length, 1500);
+    EXPECT_EQ(log[1].length, 450);
+    EXPECT_EQ(log[2].length, 400);
+    EXPECT_EQ(log[3].length, 200);
+}
+
+/**
+ * @brief 一个 run 只提交同一 ratio 的 job，并用其他任务同 ratio 的 job 补满
+ */
+TEST(CropScheduler, RunsStayOnOneEngine) {
+    std::vector<Submitted> log;
+    CropScheduler scheduler(CropSchedulerConfig{64, 8});
+
+    // 阅读顺序交替使用两个引擎
+    for (int i = 0; i < 4; i++) {
+        scheduler.enqueue(makeJob(log, 1, 10, 400));
+        scheduler.enqueue(makeJob(log, 1, 5, 200));
+    }
+    scheduler.enqueue(makeJob(log, 2, 10, 300));
+
+    EXPECT_EQ(scheduler.dispatchOnce(), 5u);
+    for (const auto& s : log) EXPECT_EQ(s.ratio, 10);
+    EXPECT_EQ(log.front().taskId, 2);  // 剩余最少的任务先取
+
+    EXPECT_EQ(scheduler.dispatchOnce(), 4u);
+    EXPECT_EQ(scheduler.dispatchOnce(), 0u);
+
+    auto stats = scheduler.getStats();
+    EXPECT_EQ(stats.submitted, 9u);
+    EXPECT_EQ(stats.runs, 2u);
+    EXPECT_EQ(stats.engineSwitches, 1u);
+    EXPECT_EQ(stats.queued, 0u);
+    EXPECT_TRUE(stats.queueDepth.empty());
+}
+
+/**
+ * @brief 在途额度用完后不再提交，complete() 后继续
+ */
+TEST(CropScheduler, InFlightLimit) {
+    std::vector<Submitted> log;
+    CropScheduler scheduler(CropSchedulerConfig{3, 16});
+
+    for (int i = 0; i < 5; i++) scheduler.enqueue(makeJob(log, 1, 10, 400));
+
+    EXPECT_EQ(scheduler.dispatchOnce(), 3u);
+    EXPECT_EQ(scheduler.dispatchOnce(), 0u);
+
+    auto stats = scheduler.getStats();
+    EXPECT_EQ(stats.inFlight, 3u);
+    EXPECT_EQ(stats.queued, 2u);
+    EXPECT_EQ(stats.queueDepth.at(10), 2u);
+
+    scheduler.complete(2);
+    EXPECT_EQ(scheduler.dispatchOnce(), 2u);
+    EXPECT_EQ(scheduler.getStats().inFlight, 3u);
+}
+
+/**
+ * @brief 停止时排队的 job 逐个 cancel（没有 cancel 的直接 submit），不丢弃 crop 上下文
+ */
+TEST(CropScheduler, StopCancelsQueuedJobs) {
+    std::vector<Submitted> log;
+    std::vector<int64_t> cancelled;
+    CropScheduler scheduler(CropSchedulerConfig{1, 16});
+
+    for (int64_t taskId : {2, 1, 1}) {
+        CropJob job = makeJob(log, taskId, 10, 100);
+        job.cancel = [&cancelled, &scheduler, taskId]() {
+            cancelled.push_back(taskId);
+            scheduler.complete();  // 与识别回调一样，在 cancel 中释放额度不会死锁
+        };
+        scheduler.enqueue(std::move(job));
+    }
+    scheduler.enqueue(makeJob(log, 3, 5, 100));  // 没有 cancel
+
+    EXPECT_EQ(scheduler.dispatchOnce(), 1u);
+    ASSERT_EQ(log.size(), 1u);
+    EXPECT_EQ(log[0].taskId, 2);
+
+    scheduler.stop();
+    EXPECT_EQ(cancelled, (std::vector<int64_t>{1, 1}));
+    ASSERT_EQ(log.size(), 2u);
+    EXPECT_EQ(log[1].taskId, 3);
+
+    auto stats = scheduler.getStats();
+    EXPECT_EQ(stats.queued, 0u);
+    EXPECT_EQ(stats.tasks, 0u);
+    EXPECT_EQ(scheduler.dispatchOnce(), 0u);
+}
+
+/**
+ * @brief 调度线程提交全部 job
+ */
+TEST(CropScheduler, DispatchThread) {
+    std::atomic<int> submitted{0};
+    CropScheduler scheduler(CropSchedulerConfig{4, 2});
+    scheduler.start();
+
+    for (int i = 0; i < 50; i++) {
+        CropJob job;
+        job.taskId = i % 3;
+        job.ratio = (i % 2) ? 5 : 10;
+        job.length = i;
+        job.submit = [&submitted, &scheduler]() {
+            submitted++;
+            scheduler.complete();
+        };
+        scheduler.enqueue(std::move(job));
+    }
+
+    for (int i = 0; i < 200 && submitted.load() < 50; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    scheduler.stop();
+    EXPECT_EQ(submitted.load(), 50);
+}
+
+/**
+ * @brief 不同档位的同一 ratio 是不同引擎，不在一个 run 中混合
+ */
+TEST(CropScheduler, TiersAreSeparateEngines) {
+    std::vector<Submitted> log;
+    CropScheduler scheduler(CropSchedulerConfig{64, 16});
+
+    for (int i = 0; i < 3; i++) {
+        CropJob job = makeJob(log, 1, 10, 400);
+        job.tier = 1;
+        scheduler.enqueue(std::move(job));
+        scheduler.enqueue(makeJob(log, 1, 10, 300));
+    }
+
+    EXPECT_EQ(scheduler.dispatchOnce(), 3u);
+    for (const auto& s : log) EXPECT_EQ(s.length, 400);
+    EXPECT_EQ(scheduler.getStats().queueDepth.at(CropScheduler::engineKey(0, 10)), 3u);
+    EXPECT_EQ(scheduler.dispatchOnce(), 3u);
+}
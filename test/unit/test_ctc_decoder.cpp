@@ -0,0 +1,292 @@
+/**
+ * @file test_ctc_decoder.cpp
+ * @brief CTC 解码器测试（不加载模型）
+ * 
+ * 验证 SIMD argmax 与标量循环结果一致，以及连续字典表上的贪心解码
+ */
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "recognition/rec_postprocess.h"
+#include "recognition/ctc_kernels.h"
+
+using namespace ocr;
+
+namespace {
+
+std::vector<float> randomRow(int n, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    std::vector<float> row(n);
+    for (auto& v : row) v = dist(rng);
+    return row;
+}
+
+// 每个时间步在 index 处放一个尖峰，其余为小值
+std::vector<float> makeLogits(const std::vector<int>& indices, int num_classes, float peak = 0.9f) {
+    std::vector<float> logits(indices.size() * num_classes, 0.0001f);
+    for (size_t t = 0; t < indices.size(); t++) {
+        logits[t * num_classes + indices[t]] = peak;
+    }
+    return logits;
+}
+
+} // namespace
+
+// ==================== argmax 内核 ====================
+
+/**
+ * @brief 各种长度（含尾部）下与标量实现一致
+ */
+TEST(CTCKernels, ArgmaxMatchesScalar) {
+    for (int n : {1, 7, 15, 16, 31, 33, 63, 64, 65, 127, 1000, 18385}) {
+        for (uint32_t seed = 0; seed < 8; seed++) {
+            auto row = randomRow(n, seed * 7919 + n);
+            float simdMax = 0.0f, scalarMax = 0.0f;
+            int simdIdx = ctc_kernels::argmax(row.data(), n, simdMax);
+            int scalarIdx = ctc_kernels::argmaxScalar(row.data(), n, scalarMax);
+            EXPECT_EQ(simdIdx, scalarIdx) << "n=" << n << " isa=" << ctc_kernels::argmaxIsaName();
+            EXPECT_EQ(simdMax, scalarMax);
+        }
+    }
+}
+
+/**
+ * @brief 多个相同最大值时返回最小索引（跨向量通道、跨累加器、尾部）
+ */
+TEST(CTCKernels, ArgmaxTiesPickFirst) {
+    const int n = 18385;
+    for (int first : {0, 5, 17, 40, 100, 9000, 18380}) {
+        std::vector<float> row(n, 0.1f);
+        row[first] = 1.0f;
+        for (int other : {first + 1, first + 8, first + 33, n - 1}) {
+            if (other < n) row[other] = 1.0f;
+        }
+        float maxValue = 0.0f;
+        EXPECT_EQ(ctc_kernels::argmax(row.data(), n, maxValue), first);
+        EXPECT_EQ(maxValue, 1.0f);
+    }
+}
+
+// ==================== 解码 ====================
+
+/**
+ * @brief 去重复 + 去 blank，多字节 UTF-8 字符按字典表拼接
+ */
+TEST(CTCDecoder, GreedyDecode) {
+    CTCDecoder decoder(std::vector<std::string>{"a", "b", "中", "文"}, true);  // 0=blank, 1..4, 5=space
+    ASSERT_EQ(decoder.getDictSize(), 6u);
+    EXPECT_EQ(decoder.getChar(3), "中");
+    EXPECT_EQ(decoder.getChar(5), " ");
+
+    // a a blank a b b space 中 文 文
+    std::vector<int> path = {1, 1, 0, 1, 2, 2, 5, 3, 4, 4};
+    auto logits = makeLogits(path, 6, 0.5f);
+
+    char text[64];
+    size_t length = 0;
+    float conf = decoder.decodeInto(logits.data(), static_cast<int>(path.size()), text, sizeof(text), length);
+    EXPECT_EQ(std::string(text, length), "aab 中文");
+    EXPECT_FLOAT_EQ(conf, 0.5f);
+}
+
+/**
+ * @brief 全部为 blank 时输出为空，置信度为 0
+ */
+TEST(CTCDecoder, AllBlank) {
+    CTCDecoder decoder(std::vector<std::string>{"x", "y"}, false);
+    auto logits = makeLogits({0, 0, 0, 0}, 3);
+    char text[16];
+    size_t length = 123;
+    EXPECT_EQ(decoder.decodeInto(logits.data(), 4, text, sizeof(text), length), 0.0f);
+    EXPECT_EQ(length, 0u);
+}
+
+/**
+ * @brief 缓冲不足时丢弃放不下的字符，不越界
+ */
+TEST(CTCDecoder, CapacityIsRespected) {
+    CTCDecoder decoder(std::vector<std::string>{"a", "中"}, false);
+    EXPECT_EQ(decoder.maxTextBytes(4), 12u);  // "中" 为 3 字节
+
+    auto logits = makeLogits({2, 0, 2, 0, 1}, 3);
+    char text[8] = {};
+    size_t length = 0;
+    decoder.decodeInto(logits.data(), 5, text, 4, length);
+    EXPECT_EQ(std::string(text, length), "中a");
+}
+
+/**
+ * @brief 大字典（与 PP-OCRv5 类别数相同）上的解码结果与期望路径一致
+ */
+TEST(CTCDecoder, LargeDictionary) {
+    std::vector<std::string> chars;
+    for (int i = 0; i < 18383; i++) {
+        chars.push_back(std::string(1, static_cast<char>('A' + i % 26)));
+    }
+    CTCDecoder decoder(chars, true);
+    const int num_classes = static_cast<int>(decoder.getDictSize());
+    ASSERT_EQ(num_classes, 18385);
+
+    std::vector<int> path = {8, 0, 5, 12, 12, 0, 12, 15, num_classes - 1, 18000};
+    auto logits = makeLogits(path, num_classes);
+    std::string text(decoder.maxTextBytes(static_cast<int>(path.size())), '\0');
+    size_t length = 0;
+    decoder.decodeInto(logits.data(), static_cast<int>(path.size()), &text[0], text.size(), length);
+    text.resize(length);
+
+    std::string expected;
+    int prev = -1;
+    for (int idx : path) {
+        if (idx != prev && idx != 0) expected += std::string(decoder.getChar(idx));
+        prev = idx;
+    }
+    EXPECT_EQ(text, expected);
+}
+
+// ==================== 字符集约束 ====================
+
+/**
+ * @brief 子集 argmax 在并列时取较小的类别索引
+ */
+TEST(CTCKernels, ArgmaxIndexed) {
+    std::vector<float> row = {0.1f, 0.9f, 0.3f, 0.3f, 0.2f};
+    std::vector<int> classes = {0, 2, 3, 4};
+    float maxValue = 0.0f;
+    EXPECT_EQ(ctc_kernels::argmaxIndexed(row.data(), classes.data(), 4, maxValue), 2);
+    EXPECT_FLOAT_EQ(maxValue, 0.3f);
+}
+
+/**
+ * @brief 字符集编译：含 blank、升序去重、忽略字典外字符、结果缓存
+ */
+TEST(CTCDecoder, CompileCharset) {
+    CTCDecoder decoder(std::vector<std::string>{"0", "1", "O", "l", "中"}, false);
+    CharsetIndexPtr none;
+    EXPECT_TRUE(decoder.compileCharset("", none));
+    EXPECT_EQ(none, nullptr);
+
+    CharsetIndexPtr allowed;
+    ASSERT_TRUE(decoder.compileCharset("中10中?", allowed));
+    ASSERT_NE(allowed, nullptr);
+    EXPECT_EQ(*allowed, (CharsetIndex{0, 1, 2, 5}));
+    CharsetIndexPtr cached;
+    ASSERT_TRUE(decoder.compileCharset("中10中?", cached));
+    EXPECT_EQ(cached, allowed);
+}
+
+/**
+ * @brief 没有一个字符在字典中的字符集编译失败（不能退化成只有 blank 的约束）
+ */
+TEST(CTCDecoder, CompileCharsetWithoutDictionaryCharactersFails) {
+    CTCDecoder decoder(std::vector<std::string>{"0", "1", "O", "l"}, false);
+    CharsetIndexPtr compiled = std::make_shared<const CharsetIndex>(CharsetIndex{0});
+    EXPECT_FALSE(decoder.compileCharset("中文?", compiled));
+    EXPECT_EQ(compiled, nullptr);
+    // 失败不被缓存成可用的约束
+    EXPECT_FALSE(decoder.compileCharset("中文?", compiled));
+    EXPECT_TRUE(decoder.compileCharset("中文?0", compiled));
+    ASSERT_NE(compiled, nullptr);
+    EXPECT_EQ(*compiled, (CharsetIndex{0, 1}));
+}
+
+/**
+ * @brief 约束解码：把形近字母限制为数字
+ */
+TEST(CTCDecoder, CharsetConstrainedDecode) {
+    CTCDecoder decoder(std::vector<std::string>{"0", "1", "O", "l"}, false);  // 1=0 2=1 3=O 4=l
+    const int num_classes = 5;
+
+    // 每个时间步：字母得分最高，对应数字次之
+    std::vector<std::pair<int, int>> steps = {{3, 1}, {0, 0}, {4, 2}, {4, 2}, {0, 0}, {3, 1}};
+    std::vector<float> logits(steps.size() * num_classes, 0.01f);
+    for (size_t t = 0; t < steps.size(); t++) {
+        logits[t * num_classes + steps[t].first] = 0.6f;
+        if (steps[t].first != steps[t].second) {
+            logits[t * num_classes + steps[t].second] = 0.3f;
+        }
+    }
+
+    char text[32];
+    size_t length = 0;
+    decoder.decodeInto(logits.data(), static_cast<int>(steps.size()), text, sizeof(text), length);
+    EXPECT_EQ(std::string(text, length), "OlO");
+
+    CharsetIndexPtr digits;
+    ASSERT_TRUE(decoder.compileCharset("0123456789", digits));
+    float conf = decoder.decodeInto(logits.data(), static_cast<int>(steps.size()), text, sizeof(text), length,
+                                    digits.get());
+    EXPECT_EQ(std::string(text, length), "010");
+    EXPECT_FLOAT_EQ(conf, 0.3f);
+}
+
+// ==================== 分段解码（多 crop 拼接输入） ====================
+
+/**
+ * @brief 列范围按 8 列/时间步映射：x0 向下取整、x1 向上取整，分隔列上的字符不属于任何段
+ */
+TEST(CTCDecoder, DecodeColumnsSegmentBoundaries) {
+    CTCDecoder decoder(std::vector<std::string>{"a", "b", "c", "d", "x"}, false);  // 0=blank, 1..5
+    // 80 列输入，10 个时间步
+    // t:   0  1  2  3  4  5  6  7  8  9
+    std::vector<int> path = {1, 2, 0, 5, 0, 3, 4, 0, 0, 0};
+    auto logits = makeLogits(path, 6);
+
+    // 段 1 = 列 [0, 20) -> 时间步 [0, 3)；段 2 = 列 [40, 60) -> 时间步 [5, 8)；t=3 的 x 落在分隔列
+    auto results = decoder.decodeColumns(logits.data(), 10, 80, {{0, 20}, {40, 60}});
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].first, "ab");
+    EXPECT_EQ(results[1].first, "cd");
+    EXPECT_FLOAT_EQ(results[0].second, 0.9f);
+    EXPECT_FLOAT_EQ(results[1].second, 0.9f);
+
+    // x1 跨进下一个时间步时向上取整：[0, 25) -> [0, 4)，包含 x
+    results = decoder.decodeColumns(logits.data(), 10, 80, {{0, 25}});
+    EXPECT_EQ(results[0].first, "abx");
+}
+
+/**
+ * @brief 相邻段各自去重：前一段末尾和后一段开头的相同字符都保留，且互不串入
+ */
+TEST(CTCDecoder, DecodeColumnsAdjacentSegments) {
+    CTCDecoder decoder(std::vector<std::string>{"a", "b"}, false);  // 0=blank, 1=a, 2=b
+    // 段 1 = [0, 16) -> t [0, 2)；一个时间步的分隔；段 2 = [24, 40) -> t [3, 5)
+    std::vector<int> path = {2, 1, 0, 1, 2};
+    auto logits = makeLogits(path, 3);
+
+    auto results = decoder.decodeColumns(logits.data(), 5, 40, {{0, 16}, {24, 40}});
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].first, "ba");
+    EXPECT_EQ(results[1].first, "ab");
+
+    // 不留分隔、紧贴的段也不共享时间步
+    path = {2, 1, 1, 2};
+    logits = makeLogits(path, 3);
+    results = decoder.decodeColumns(logits.data(), 4, 32, {{0, 16}, {16, 32}});
+    EXPECT_EQ(results[0].first, "ba");
+    EXPECT_EQ(results[1].first, "ab");
+}
+
+/**
+ * @brief 空段、越界段输出空串和 0 置信度，不影响其他段
+ */
+TEST(CTCDecoder, DecodeColumnsEmptySegment) {
+    CTCDecoder decoder(std::vector<std::string>{"a", "b"}, false);
+    std::vector<int> path = {1, 0, 2, 0};
+    auto logits = makeLogits(path, 3);
+
+    auto results = decoder.decodeColumns(logits.data(), 4, 32, {{0, 8}, {12, 12}, {40, 48}, {16, 24}});
+    ASSERT_EQ(results.size(), 4u);
+    EXPECT_EQ(results[0].first, "a");
+    EXPECT_EQ(results[1].first, "");
+    EXPECT_EQ(results[1].second, 0.0f);
+    EXPECT_EQ(results[2].first, "");
+    EXPECT_EQ(results[2].second, 0.0f);
+    EXPECT_EQ(results[3].first, "b");
+
+    EXPECT_TRUE(decoder.decodeColumns(logits.data(), 4, 32, {}).empty());
+    results = decoder.decodeColumns(logits.data(), 4, 0, {{0, 8}});
+    EXPECT_EQ(results[0].first, "");
+}
@@ -0,0 +1,327 @@
+/**
+ * @file test_db_postprocess.cpp
+ * @brief DBNet 后处理测试（二值化内核、连通域统计、框打分）
+ * 
+ * 使用合成概率图验证 SIMD 二值化与 OpenCV 参考实现逐像素一致
+ */
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include "detection/db_kernels.h"
+#include "detection/db_components.h"
+#include "detection/db_postprocess.h"
+
+using namespace ocr;
+
+namespace {
+
+// 参考实现：原 DBPostProcessor::process 中的 threshold + convertTo
+cv::Mat referenceBitmap(const cv::Mat& pred, float thresh) {
+    cv::Mat bitmap;
+    cv::threshold(pred, bitmap, thresh, 255, cv::THRESH_BINARY);
+    bitmap.convertTo(bitmap, CV_8UC1);
+    return bitmap;
+}
+
+cv::Mat randomProbMap(int rows, int cols, uint64_t seed) {
+    cv::Mat pred(rows, cols, CV_32FC1);
+    cv::RNG rng(seed);
+    rng.fill(pred, cv::RNG::UNIFORM, -0.05, 1.05);  // 覆盖 [0,1] 之外的值
+    return pred;
+}
+
+// 单个高概率矩形文本区域
+cv::Mat syntheticTextMap(int size, const cv::Rect& text, float prob) {
+    cv::Mat pred = cv::Mat::zeros(size, size, CV_32FC1);
+    pred(text).setTo(prob);
+    return pred;
+}
+
+} // namespace
+
+// ==================== db_kernels::binarize 测试 ====================
+
+/**
+ * @brief 非 SIMD 宽度对齐的尺寸：二值图与 OpenCV 参考实现完全一致
+ */
+TEST(DBKernels, BinarizeMatchesOpenCV) {
+    const cv::Size sizes[] = {{1, 1}, {7, 3}, {33, 17}, {640, 640}, {961, 5}};
+    for (const auto& size : sizes) {
+        cv::Mat pred = randomProbMap(size.height, size.width, size.area());
+        cv::Mat bitmap;
+        db_kernels::binarize(pred, 0.3f, bitmap);
+
+        cv::Mat expected = referenceBitmap(pred, 0.3f);
+        ASSERT_EQ(bitmap.type(), CV_8UC1);
+        EXPECT_EQ(cv::countNonZero(bitmap != expected), 0)
+            << "size " << size.width << "x" << size.height
+            << " isa " << db_kernels::binarizeIsaName();
+    }
+}
+
+/**
+ * @brief 恰好等于阈值的像素不应被置为前景（严格大于）
+ */
+TEST(DBKernels, BinarizeThresholdIsExclusive) {
+    cv::Mat pred(1, 64, CV_32FC1, cv::Scalar(0.3f));
+    pred.at<float>(0, 40) = std::nextafter(0.3f, 1.0f);
+
+    cv::Mat bitmap;
+    db_kernels::binarize(pred, 0.3f, bitmap);
+
+    EXPECT_EQ(cv::countNonZero(bitmap), 1);
+    EXPECT_EQ(bitmap.at<uint8_t>(0, 40), 255);
+}
+
+/**
+ * @brief 非连续内存（ROI 子矩阵）按行处理
+ */
+TEST(DBKernels, BinarizeNonContinuousRoi) {
+    cv::Mat full = randomProbMap(100, 100, 42);
+    cv::Mat roi = full(cv::Rect(3, 5, 61, 47));
+    ASSERT_FALSE(roi.isContinuous());
+
+    cv::Mat bitmap, quantized;
+    db_kernels::binarize(roi, 0.5f, bitmap, &quantized);
+
+    EXPECT_EQ(cv::countNonZero(bitmap != referenceBitmap(roi, 0.5f)), 0);
+    EXPECT_EQ(quantized.size(), roi.size());
+}
+
+/**
+ * @brief 量化概率图：round(clamp(p, 0, 1) * 255)
+ */
+TEST(DBKernels, QuantizedMatchesReference) {
+    cv::Mat pred = randomProbMap(31, 77, 7);
+    cv::Mat bitmap, quantized;
+    db_kernels::binarize(pred, 0.3f, bitmap, &quantized);
+
+    ASSERT_EQ(quantized.type(), CV_8UC1);
+    for (int y = 0; y < pred.rows; y++) {
+        for (int x = 0; x < pred.cols; x++) {
+            float p = std::min(std::max(pred.at<float>(y, x), 0.0f), 1.0f);
+            int expected = static_cast<int>(std::lrint(p * 255.0f));
+            ASSERT_EQ(quantized.at<uint8_t>(y, x), expected) << "at (" << x << "," << y << ")";
+        }
+    }
+}
+
+// ==================== db_components::label 测试 ====================
+
+/**
+ * @brief 8 邻域连通：对角相邻的像素属于同一连通域，统计量正确
+ */
+TEST(DBComponents, EightConnectedStats) {
+    const char* rows[] = {
+        "11..1....",
+        ".1..1..11",
+        "..1.1....",
+        "....11...",
+        "1........",
+        "1.1.1.1.1",
+        ".1.1.1.1.",
+    };
+    cv::Mat bitmap(7, 9, CV_8UC1, cv::Scalar(0));
+    cv::Mat score(7, 9, CV_32FC1);
+    for (int y = 0; y < bitmap.rows; y++) {
+        for (int x = 0; x < bitmap.cols; x++) {
+            bitmap.at<uint8_t>(y, x) = rows[y][x] == '1' ? 255 : 0;
+            score.at<float>(y, x) = 0.1f * (y + 1);
+        }
+    }
+
+    auto comps = db_components::label(bitmap, score);
+    ASSERT_EQ(comps.size(), 4u);
+
+    // 按首个像素的扫描顺序输出
+    EXPECT_EQ(comps[0].bbox, cv::Rect(0, 0, 3, 3));
+    EXPECT_EQ(comps[0].pixelCount, 4);
+    EXPECT_NEAR(comps[0].probSum, 0.7, 1e-5);
+
+    EXPECT_EQ(comps[1].bbox, cv::Rect(4, 0, 2, 4));
+    EXPECT_EQ(comps[1].pixelCount, 5);
+
+    EXPECT_EQ(comps[2].bbox, cv::Rect(7, 1, 2, 1));
+    EXPECT_EQ(comps[2].pixelCount, 2);
+
+    // 锯齿形对角连接合并为一个连通域
+    EXPECT_EQ(comps[3].bbox, cv::Rect(0, 4, 9, 3));
+    EXPECT_EQ(comps[3].pixelCount, 10);
+    EXPECT_NEAR(comps[3].meanProb(), 0.63, 1e-5);
+}
+
+/**
+ * @brief run 端点的 minAreaRect 与 findContours 轮廓的 minAreaRect 一致
+ */
+TEST(DBComponents, PointsMatchContourMinAreaRect) {
+    cv::Mat bitmap = cv::Mat::zeros(120, 200, CV_8UC1);
+    cv::RotatedRect slanted(cv::Point2f(100, 60), cv::Size2f(140, 24), 17.0f);
+    cv::Point2f vertices[4];
+    slanted.points(vertices);
+    std::vector<cv::Point> poly(vertices, vertices + 4);
+    cv::fillConvexPoly(bitmap, poly, cv::Scalar(255));
+
+    std::vector<std::vector<cv::Point>> contours;
+    cv::findContours(bitmap, contours, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+    ASSERT_EQ(contours.size(), 1u);
+
+    cv::Mat score;
+    bitmap.convertTo(score, CV_32FC1, 1.0 / 255.0);
+    auto comps = db_components::label(bitmap, score);
+    ASSERT_EQ(comps.size(), 1u);
+    EXPECT_EQ(comps[0].pixelCount, cv::countNonZero(bitmap));
+
+    cv::RotatedRect expected = cv::minAreaRect(contours[0]);
+    cv::RotatedRect actual = cv::minAreaRect(comps[0].points);
+    EXPECT_NEAR(actual.size.area(), expected.size.area(), 1e-3);
+    EXPECT_NEAR(actual.center.x, expected.center.x, 1e-3);
+    EXPECT_NEAR(actual.center.y, expected.center.y, 1e-3);
+}
+
+// ==================== DBPostProcessor 测试 ====================
+
+/**
+ * @brief 量化打分与 float 打分检测到相同的框，分数误差在 1/255 以内
+ */
+TEST(DBPostProcessor, QuantizedScoreMatchesFloatScore) {
+    cv::Mat pred = syntheticTextMap(160, cv::Rect(20, 40, 100, 16), 0.87f);
+
+    DBPostProcessor floatScorer(0.3f, 0.6f, 1000, 1.5f, false);
+    DBPostProcessor quantScorer(0.3f, 0.6f, 1000, 1.5f, true);
+
+    auto expected = floatScorer.process(pred, 160, 160);
+    auto actual = quantScorer.process(pred, 160, 160);
+
+    ASSERT_EQ(expected.size(), 1u);
+    ASSERT_EQ(actual.size(), expected.size());
+    EXPECT_NEAR(actual[0].confidence, expected[0].confidence, 1.0f / 255.0f);
+    for (int k = 0; k < 4; k++) {
+        EXPECT_FLOAT_EQ(actual[0].points[k].x, expected[0].points[k].x);
+        EXPECT_FLOAT_EQ(actual[0].points[k].y, expected[0].points[k].y);
+    }
+}
+
+/**
+ * @brief 低于 box_thresh 的区域被过滤
+ */
+TEST(DBPostProcessor, LowScoreRegionFiltered) {
+    cv::Mat pred = syntheticTextMap(160, cv::Rect(20, 40, 100, 16), 0.45f);
+
+    DBPostProcessor postprocessor(0.3f, 0.6f, 1000, 1.5f, true);
+    EXPECT_TRUE(postprocessor.process(pred, 160, 160).empty());
+}
+
+/**
+ * @brief 连通域打分模式与逐轮廓打分模式输出相同的框
+ */
+TEST(DBPostProcessor, ComponentScoreMatchesContourScore) {
+    cv::Mat pred = cv::Mat::zeros(320, 320, CV_32FC1);
+    pred(cv::Rect(20, 40, 100, 16)).setTo(0.87f);
+    pred(cv::Rect(150, 40, 140, 20)).setTo(0.92f);
+    pred(cv::Rect(20, 200, 260, 30)).setTo(0.75f);
+    pred(cv::Rect(30, 280, 60, 12)).setTo(0.4f);  // 低分，应被过滤
+
+    DBPostProcessor contourScorer(0.3f, 0.6f, 1000, 1.5f, false, false);
+    DBPostProcessor componentScorer(0.3f, 0.6f, 1000, 1.5f, false, true);
+
+    auto expected = contourScorer.process(pred, 320, 320);
+    auto actual = componentScorer.process(pred, 320, 320);
+    ASSERT_EQ(expected.size(), 3u);
+    ASSERT_EQ(actual.size(), expected.size());
+
+    // findContours 与扫描顺序不同，按左上角匹配
+    auto byTopLeft = [](const DeepXOCR::TextBox& a, const DeepXOCR::TextBox& b) {
+        return std::make_pair(a.points[0].y, a.points[0].x) < std::make_pair(b.points[0].y, b.points[0].x);
+    };
+    std::sort(expected.begin(), expected.end(), byTopLeft);
+    std::sort(actual.begin(), actual.end(), byTopLeft);
+
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_NEAR(actual[i].confidence, expected[i].confidence, 1e-4);
+        for (int k = 0; k < 4; k++) {
+            EXPECT_NEAR(actual[i].points[k].x, expected[i].points[k].x, 1e-3);
+            EXPECT_NEAR(actual[i].points[k].y, expected[i].points[k].y, 1e-3);
+        }
+    }
+}
+
+/**
+ * @brief 并行后处理与串行结果完全一致（包括顺序）
+ */
+TEST(DBPostProcessor, ParallelMatchesSerial) {
+    // 表格类页面：大量小文本块
+    cv::Mat pred = cv::Mat::zeros(640, 640, CV_32FC1);
+    for (int row = 0; row < 40; row++) {
+        for (int col = 0; col < 8; col++) {
+            int w = 30 + (row * 7 + col * 13) % 40;
+            pred(cv::Rect(8 + col * 78, 4 + row * 16, w, 8)).setTo(0.6f + 0.01f * ((row + col) % 30));
+        }
+    }
+
+    for (bool component_score : {false, true}) {
+        DBPostProcessor serial(0.3f, 0.6f, 1000, 1.5f, false, component_score, 1);
+        DBPostProcessor parallel(0.3f, 0.6f, 1000, 1.5f, false, component_score, 4);
+
+        auto expected = serial.process(pred, 1280, 1280, 1280, 1280);
+        auto actual = parallel.process(pred, 1280, 1280, 1280, 1280);
+
+        ASSERT_GT(expected.size(), 200u);
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            EXPECT_EQ(actual[i].confidence, expected[i].confidence) << "box " << i;
+            for (int k = 0; k < 4; k++) {
+                EXPECT_EQ(actual[i].points[k].x, expected[i].points[k].x);
+                EXPECT_EQ(actual[i].points[k].y, expected[i].points[k].y);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 解析外扩与 Clipper2 圆角外扩 + minAreaRect 的结果一致
+ * 
+ * Clipper2 路径在第二次 minAreaRect 前把顶点截断为整数，因此允许约 1 像素的偏差
+ */
+TEST(DBPostProcessor, RectUnclipMatchesClipper) {
+    // 不同角度、长宽比的文本行
+    cv::Mat pred = cv::Mat::zeros(640, 640, CV_32FC1);
+    const struct { cv::Point2f center; cv::Size2f size; float angle; } lines[] = {
+        {{160, 60}, {260, 24}, 0.0f},
+        {{460, 70}, {200, 30}, 3.5f},
+        {{320, 180}, {420, 40}, -8.0f},
+        {{150, 330}, {180, 18}, 27.0f},
+        {{460, 330}, {120, 60}, -25.0f},
+        {{320, 480}, {500, 22}, 1.2f},
+        {{110, 580}, {90, 14}, 60.0f},
+        {{470, 590}, {30, 150}, 88.0f},
+    };
+    for (const auto& line : lines) {
+        cv::Point2f vertices[4];
+        cv::RotatedRect(line.center, line.size, line.angle).points(vertices);
+        std::vector<cv::Point> poly;
+        for (const auto& v : vertices) poly.emplace_back(cvRound(v.x), cvRound(v.y));
+        cv::fillConvexPoly(pred, poly, cv::Scalar(0.9));
+    }
+
+    for (float unclip_ratio : {1.5f, 2.0f}) {
+        DBPostProcessor clipper(0.3f, 0.6f, 1000, unclip_ratio, false, false, 1, false);
+        DBPostProcessor analytic(0.3f, 0.6f, 1000, unclip_ratio, false, false, 1, true);
+
+        auto expected = clipper.process(pred, 640, 640);
+        auto actual = analytic.process(pred, 640, 640);
+        ASSERT_EQ(expected.size(), std::size(lines));
+        ASSERT_EQ(actual.size(), expected.size());
+
+        for (size_t i = 0; i < expected.size(); i++) {
+            EXPECT_EQ(actual[i].confidence, expected[i].confidence);
+            for (int k = 0; k < 4; k++) {
+                EXPECT_NEAR(actual[i].points[k].x, expected[i].points[k].x, 2.0f)
+                    << "box " << i << " point " << k << " ratio " << unclip_ratio;
+                EXPECT_NEAR(actual[i].points[k].y, expected[i].points[k].y, 2.0f)
+                    << "box " << i << " point " << k << " ratio " << unclip_ratio;
+            }
+        }
+    }
+}
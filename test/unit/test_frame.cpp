@@ -0,0 +1,126 @@
+/**
+ * @file test_frame.cpp
+ * @brief 不可变帧与任务队列测试
+ * 
+ * 验证帧共享不拷贝像素、剩余深拷贝被计数，以及队列支持只能移动的任务类型
+ */
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include "common/frame.hpp"
+#include "common/concurrent_queue.hpp"
+
+using namespace ocr;
+
+// ==================== Frame 测试 ====================
+
+/**
+ * @brief share() 与调用者共享像素缓冲，不计入拷贝
+ */
+TEST(Frame, ShareDoesNotCopy) {
+    cv::Mat image(480, 640, CV_8UC3, cv::Scalar(1, 2, 3));
+    uint64_t before = Frame::totalDeepCopies();
+
+    FramePtr frame = Frame::share(image);
+    FramePtr other = frame;  // 传递引用计数，不拷贝
+
+    EXPECT_EQ(frame->image().data, image.data);
+    EXPECT_EQ(other->image().data, image.data);
+    EXPECT_EQ(frame->deepCopies(), 0);
+    EXPECT_EQ(Frame::totalDeepCopies(), before);
+}
+
+/**
+ * @brief copy() / clone() 产生独立缓冲，并计入本帧和全局计数
+ */
+TEST(Frame, DeepCopiesAreCounted) {
+    cv::Mat image(100, 200, CV_8UC3, cv::Scalar(7, 7, 7));
+    uint64_t before = Frame::totalDeepCopies();
+    uint64_t beforeBytes = Frame::totalDeepCopyBytes();
+
+    FramePtr frame = Frame::copy(image);
+    EXPECT_NE(frame->image().data, image.data);
+    EXPECT_EQ(frame->deepCopies(), 1);
+    EXPECT_EQ(frame->deepCopyBytes(), 100u * 200u * 3u);
+
+    cv::Mat writable = frame->clone();
+    EXPECT_NE(writable.data, frame->image().data);
+    EXPECT_EQ(frame->deepCopies(), 2);
+
+    EXPECT_EQ(Frame::totalDeepCopies(), before + 2);
+    EXPECT_EQ(Frame::totalDeepCopyBytes(), beforeBytes + 2 * 100u * 200u * 3u);
+}
+
+/**
+ * @brief derive() 继承源帧的计数并计入派生图像；recordCopy() 记录帧外的拷贝
+ */
+TEST(Frame, DerivedFramesAndExternalCopiesAreCounted) {
+    cv::Mat image(100, 200, CV_8UC3, cv::Scalar(7, 7, 7));
+    uint64_t before = Frame::totalDeepCopies();
+
+    FramePtr source = Frame::share(image);
+    cv::Mat resized(50, 100, CV_8UC3, cv::Scalar(7, 7, 7));
+    source->recordCopy(resized.total() * resized.elemSize());
+    EXPECT_EQ(source->deepCopies(), 1);
+    EXPECT_EQ(source->deepCopyBytes(), 50u * 100u * 3u);
+
+    cv::Mat processed(120, 200, CV_8UC3, cv::Scalar(9, 9, 9));
+    FramePtr derived = Frame::derive(processed, source);
+    EXPECT_EQ(derived->image().data, processed.data);  // 派生图像本身不再拷贝
+    EXPECT_EQ(derived->deepCopies(), 2);
+    EXPECT_EQ(derived->deepCopyBytes(), 50u * 100u * 3u + 120u * 200u * 3u);
+    EXPECT_EQ(source->deepCopies(), 1);
+
+    EXPECT_EQ(Frame::totalDeepCopies(), before + 2);
+}
+
+/**
+ * @brief 帧在所有持有者释放后才释放像素缓冲
+ */
+TEST(Frame, KeepsBufferAliveWhileReferenced) {
+    FramePtr frame;
+    const uint8_t* data = nullptr;
+    {
+        cv::Mat image(64, 64, CV_8UC1, cv::Scalar(42));
+        data = image.data;
+        frame = Frame::share(image);
+    }
+    ASSERT_EQ(frame->image().data, data);
+    EXPECT_EQ(frame->image().at<uint8_t>(10, 10), 42);
+}
+
+// ==================== ConcurrentQueue 测试 ====================
+
+/**
+ * @brief 只能移动的任务可以入队/出队
+ */
+TEST(ConcurrentQueue, MoveOnlyTasks) {
+    ConcurrentQueue<std::unique_ptr<int>> queue(4);
+
+    queue.push(std::make_unique<int>(1));
+    ASSERT_TRUE(queue.try_push(std::make_unique<int>(2)));
+
+    auto first = queue.pop();
+    ASSERT_TRUE(first);
+    EXPECT_EQ(*first, 1);
+
+    std::unique_ptr<int> second;
+    ASSERT_TRUE(queue.try_pop(second));
+    ASSERT_TRUE(second);
+    EXPECT_EQ(*second, 2);
+    EXPECT_TRUE(queue.empty());
+}
+
+/**
+ * @brief 队列满时 try_push 失败且不移走参数
+ */
+TEST(ConcurrentQueue, FailedTryPushKeepsValue) {
+    ConcurrentQueue<std::unique_ptr<int>> queue(1);
+    queue.push(std::make_unique<int>(1));
+
+    auto value = std::make_unique<int>(2);
+    EXPECT_FALSE(queue.try_push(std::move(value), std::chrono::milliseconds(1)));
+    ASSERT_TRUE(value);
+    EXPECT_EQ(*value, 2);
+}
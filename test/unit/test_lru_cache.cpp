@@ -0,0 +1,151 @@
+/**
+ * @file test_lru_cache.cpp
+ * @brief 内容哈希与分段 LRU 缓存测试
+ *
+ * 验证 XXH64 与参考实现一致、ROI 与连续拷贝哈希相同，以及缓存的命中、淘汰和计数
+ */
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/hash.hpp"
+#include "common/lru_cache.hpp"
+
+using namespace ocr;
+
+/**
+ * @brief 参考实现的测试向量
+ */
+TEST(Hash, Xxh64ReferenceVectors) {
+    EXPECT_EQ(xxh64("", 0), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(xxh64("abc", 3), 0x44BC2CF5AD770999ULL);
+    const char* text = "Nobody inspects the spammish repetition";
+    EXPECT_EQ(xxh64(text, std::strlen(text)), 0xFBCEA83C8A378BF1ULL);
+    const char* fox = "The quick brown fox jumps over the lazy dog";
+    EXPECT_EQ(xxh64(fox, std::strlen(fox)), 0x0B242D361FDA71BCULL);
+    EXPECT_NE(xxh64(fox, std::strlen(fox), 1), xxh64(fox, std::strlen(fox), 0));
+}
+
+/**
+ * @brief 非连续 ROI 与其连续拷贝哈希相同；像素或尺寸不同则哈希不同
+ */
+TEST(Hash, MatRoiMatchesClone) {
+    cv::Mat image(64, 200, CV_8UC3);
+    cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(255));
+
+    cv::Mat roi = image(cv::Rect(10, 5, 120, 48));
+    ASSERT_FALSE(roi.isContinuous());
+    EXPECT_EQ(hashMat(roi), hashMat(roi.clone()));
+
+    cv::Mat changed = roi.clone();
+    changed.at<cv::Vec3b>(20, 30)[1] ^= 1;
+    EXPECT_NE(hashMat(roi), hashMat(changed));
+
+    // 同样的字节，不同的形状
+    cv::Mat reshaped = roi.clone().reshape(3, 24);
+    EXPECT_NE(hashMat(roi), hashMat(reshaped));
+}
+
+/**
+ * @brief 命中返回存入的值，未命中计数
+ */
+TEST(StripedLruCache, HitAndMiss) {
+    StripedLruCache<std::string> cache(8, 2);
+
+    std::string value;
+    EXPECT_FALSE(cache.get(1, value));
+    cache.put(1, "one");
+    ASSERT_TRUE(cache.get(1, value));
+    EXPECT_EQ(value, "one");
+
+    cache.put(1, "uno");
+    ASSERT_TRUE(cache.get(1, value));
+    EXPECT_EQ(value, "uno");
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.entries, 1u);
+    EXPECT_EQ(stats.capacity, 8u);
+}
+
+/**
+ * @brief 分段满时淘汰最久未使用的条目，最近访问过的保留
+ */
+TEST(StripedLruCache, EvictsLeastRecentlyUsed) {
+    StripedLruCache<int> cache(3, 1);
+
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.put(3, 30);
+
+    int value = 0;
+    ASSERT_TRUE(cache.get(1, value));  // 1 变为最近使用
+    cache.put(4, 40);                  // 淘汰 2
+
+    EXPECT_TRUE(cache.get(1, value));
+    EXPECT_FALSE(cache.get(2, value));
+    EXPECT_TRUE(cache.get(3, value));
+    EXPECT_TRUE(cache.get(4, value));
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.entries, 3u);
+    EXPECT_EQ(stats.evictions, 1u);
+}
+
+/**
+ * @brief 条目总数不超过容量（容量分摊到各分段）
+ */
+TEST(StripedLruCache, BoundedAcrossStripes) {
+    StripedLruCache<int> cache(100, 16);
+    for (uint64_t key = 0; key < 10000; key++) {
+        cache.put(xxh64(&key, sizeof(key)), static_cast<int>(key));
+    }
+    EXPECT_LE(cache.stats().entries, 100u);
+    EXPECT_GT(cache.stats().entries, 50u);
+}
+
+/**
+ * @brief 容量为 0 时关闭
+ */
+TEST(StripedLruCache, DisabledWhenZeroCapacity) {
+    StripedLruCache<int> cache(0);
+    EXPECT_FALSE(cache.enabled());
+
+    cache.put(1, 1);
+    int value = 0;
+    EXPECT_FALSE(cache.get(1, value));
+    EXPECT_EQ(cache.stats().entries, 0u);
+    EXPECT_EQ(cache.stats().misses, 0u);
+}
+
+/**
+ * @brief 多线程并发读写
+ */
+TEST(StripedLruCache, ConcurrentAccess) {
+    StripedLruCache<int> cache(256, 8);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&cache, t]() {
+            for (int i = 0; i < 2000; i++) {
+                uint64_t key = static_cast<uint64_t>((i * 7 + t) % 300);
+                int value = 0;
+                if (!cache.get(key, value)) {
+                    cache.put(key, static_cast<int>(key));
+                } else {
+                    EXPECT_EQ(value, static_cast<int>(key));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits + stats.misses, 8000u);
+    EXPECT_LE(stats.entries, 256u);
+}
@@ -0,0 +1,19 @@
+/**
+ * @file test_main.cpp
+ * @brief Google Test 主入口文件
+ * 
+ * OCR 核心库单元测试入口（不依赖 NPU / 模型文件）
+ */
+
+#include <gtest/gtest.h>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    std::cout << "========================================" << std::endl;
+    std::cout << "DeepX OCR Core - Unit Tests" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    ::testing::InitGoogleTest(&argc, argv);
+    
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,88 @@
+/**
+ * @file test_mosaic.cpp
+ * @brief Mosaic 检测的画布排布与检测框分回测试
+ *
+ * 验证小图在画布上不重叠且留有隔离带、画布放满时的截断，以及检测框按区域分回源图像坐标
+ */
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include "detection/mosaic.h"
+
+using namespace ocr;
+
+namespace {
+
+DeepXOCR::TextBox makeBox(float x0, float y0, float x1, float y1) {
+    DeepXOCR::TextBox box;
+    box.points[0] = cv::Point2f(x0, y0);
+    box.points[1] = cv::Point2f(x1, y0);
+    box.points[2] = cv::Point2f(x1, y1);
+    box.points[3] = cv::Point2f(x0, y1);
+    return box;
+}
+
+bool separated(const cv::Rect& a, const cv::Rect& b, int margin) {
+    return a.x + a.width + margin <= b.x || b.x + b.width + margin <= a.x ||
+           a.y + a.height + margin <= b.y || b.y + b.height + margin <= a.y;
+}
+
+} // namespace
+
+/**
+ * @brief 按行排布：位置保持输入尺寸，互不重叠且间隔不小于隔离带，全部在画布内
+ */
+TEST(Mosaic, PacksRowsWithMargin) {
+    std::vector<cv::Size> sizes = {{300, 100}, {250, 80}, {200, 150}, {320, 60}, {100, 100}};
+    auto placements = mosaic::pack(sizes, 640, 16);
+    ASSERT_EQ(placements.size(), sizes.size());
+
+    for (size_t i = 0; i < placements.size(); i++) {
+        EXPECT_EQ(placements[i].width, sizes[i].width);
+        EXPECT_EQ(placements[i].height, sizes[i].height);
+        EXPECT_GE(placements[i].x, 0);
+        EXPECT_GE(placements[i].y, 0);
+        EXPECT_LE(placements[i].x + placements[i].width, 640);
+        EXPECT_LE(placements[i].y + placements[i].height, 640);
+        for (size_t j = 0; j < i; j++) {
+            EXPECT_TRUE(separated(placements[i], placements[j], 16)) << i << " vs " << j;
+        }
+    }
+    // 前两张在第一行，第三张换行
+    EXPECT_EQ(placements[1].y, 0);
+    EXPECT_EQ(placements[2].x, 0);
+    EXPECT_EQ(placements[2].y, 100 + 16);
+}
+
+/**
+ * @brief 画布放满时只返回能放下的前缀；超过画布的图像放不下
+ */
+TEST(Mosaic, StopsWhenCanvasIsFull) {
+    std::vector<cv::Size> sizes(10, cv::Size(300, 300));
+    EXPECT_EQ(mosaic::pack(sizes, 640, 16).size(), 4u);
+
+    EXPECT_TRUE(mosaic::pack({cv::Size(700, 100)}, 640, 16).empty());
+}
+
+/**
+ * @brief 检测框按中心点分回源图像，坐标减去偏移并裁剪；落在隔离带的框丢弃
+ */
+TEST(Mosaic, SplitsBoxesBackToSources) {
+    std::vector<cv::Rect> placements = {cv::Rect(0, 0, 300, 100), cv::Rect(316, 0, 250, 80)};
+    std::vector<DeepXOCR::TextBox> boxes = {
+        makeBox(10, 10, 200, 40),    // 第一张
+        makeBox(330, 20, 560, 50),   // 第二张
+        makeBox(280, 60, 310, 90),   // 中心在第一张内，外扩到隔离带：裁剪到源图像范围
+        makeBox(302, 10, 314, 30),   // 中心在隔离带
+    };
+
+    auto split = mosaic::splitBoxes(boxes, placements);
+    ASSERT_EQ(split.size(), 2u);
+    ASSERT_EQ(split[0].size(), 2u);
+    ASSERT_EQ(split[1].size(), 1u);
+
+    EXPECT_FLOAT_EQ(split[1][0].points[0].x, 14.0f);
+    EXPECT_FLOAT_EQ(split[1][0].points[0].y, 20.0f);
+    EXPECT_FLOAT_EQ(split[1][0].points[2].x, 244.0f);
+    EXPECT_FLOAT_EQ(split[0][1].points[1].x, 300.0f);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file test_task_config.cpp
+ * @brief 任务级配置测试（检测前边长限制 textDetLimitSideLen / textDetLimitType、感兴趣区域）
+ */
+
+#include <gtest/gtest.h>
+#include "pipeline/ocr_pipeline.h"
+
+using namespace ocr;
+
+namespace {
+
+OCRTaskConfig makeLimit(int sideLen, DetLimitType type) {
+    OCRTaskConfig config;
+    config.textDetLimitSideLen = sideLen;
+    config.textDetLimitType = type;
+    return config;
+}
+
+} // namespace
+
+/**
+ * @brief 默认不限制
+ */
+TEST(DetResizeRatio, DisabledByDefault) {
+    OCRTaskConfig config;
+    EXPECT_DOUBLE_EQ(config.detResizeRatio(32, 4000), 1.0);
+    EXPECT_DOUBLE_EQ(config.detResizeRatio(4000, 3000), 1.0);
+}
+
+/**
+ * @brief max：只缩小长边超过限制的图像
+ */
+TEST(DetResizeRatio, MaxShrinksLongSide) {
+    OCRTaskConfig config = makeLimit(960, DetLimitType::Max);
+    EXPECT_DOUBLE_EQ(config.detResizeRatio(1920, 1080), 0.5);
+    EXPECT_DOUBLE_EQ(config.detResizeRatio(960, 720), 1.0);
+    EXPECT_DOUBLE_EQ(config.detResizeRatio(100, 200), 1.0);
+}
+
+/**
+ * @brief min：放大短边不足的图像，长边不超过 kMaxDetUpscaleSide，从不缩小
+ */
+TEST(DetResizeRatio, MinEnlargesShortSide) {
+    OCRTaskConfig config = makeLimit(64, DetLimitType::Min);
+    EXPECT_DOUBLE_EQ(config.detResizeRatio(32, 100), 2.0);
+    EXPECT_DOUBLE_EQ(config.detResizeRatio(64, 100), 1.0);
+    EXPECT_DOUBLE_EQ(config.detResizeRatio(2000, 3000), 1.0);
+
+    // 细长图像：受长边上限约束
+    EXPECT_DOUBLE_EQ(config.detResizeRatio(32, 800), OCRTaskConfig::kMaxDetUpscaleSide / 800.0);
+    EXPECT_DOUBLE_EQ(config.detResizeRatio(16, 2000), 1.0);
+}
+
+/**
+ * @brief 像素 ROI 裁剪到页面内，完全在页面外的丢弃
+ */
+TEST(RoiRects, PixelRectsClippedToPage) {
+    OCRTaskConfig config;
+    config.rois = {cv::Rect2f(10, 20, 100, 50), cv::Rect2f(900, 700, 200, 200), cv::Rect2f(2000, 0, 10, 10)};
+
+    auto rects = config.roiRects(800, 1000);
+    ASSERT_EQ(rects.size(), 2u);
+    EXPECT_EQ(rects[0].x, 10);
+    EXPECT_EQ(rects[0].y, 20);
+    EXPECT_EQ(rects[0].width, 100);
+    EXPECT_EQ(rects[0].height, 50);
+    EXPECT_EQ(rects[1].x, 900);
+    EXPECT_EQ(rects[1].width, 100);
+    EXPECT_EQ(rects[1].height, 100);
+}
+
+/**
+ * @brief 归一化 ROI 按页面宽高换算，向外取整
+ */
+TEST(RoiRects, NormalizedRectsScaledToPage) {
+    OCRTaskConfig config;
+    config.roisNormalized = true;
+    config.rois = {cv::Rect2f(0.25f, 0.5f, 0.5f, 0.5f), cv::Rect2f(0.0f, 0.0f, 0.0005f, 0.0005f)};
+
+    auto rects = config.roiRects(300, 1000);
+    ASSERT_EQ(rects.size(), 2u);
+    EXPECT_EQ(rects[0].x, 250);
+    EXPECT_EQ(rects[0].y, 150);
+    EXPECT_EQ(rects[0].width, 500);
+    EXPECT_EQ(rects[0].height, 150);
+    EXPECT_EQ(rects[1].width, 1);
+    EXPECT_EQ(rects[1].height, 1);
+}
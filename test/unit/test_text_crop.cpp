@@ -0,0 +1,171 @@
+/**
+ * @file test_text_crop.cpp
+ * @brief 融合文本框裁剪采样测试
+ * 
+ * 验证一次采样得到的识别/分类输入与原先"透视裁剪 -> 旋转 -> 补边 -> resize"的结果一致
+ */
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include "preprocessing/text_crop.h"
+#include "common/geometry.h"
+
+using namespace ocr;
+
+namespace {
+
+constexpr int kTargetHeight = 48;
+
+// 平滑的测试图：插值方式（cubic+linear vs 单次 linear）只带来很小的差异
+cv::Mat smoothImage(int rows, int cols) {
+    cv::Mat image(rows, cols, CV_8UC3);
+    cv::RNG rng(rows * 31 + cols);
+    rng.fill(image, cv::RNG::UNIFORM, 0, 256);
+    cv::GaussianBlur(image, image, cv::Size(0, 0), 4.0);
+    cv::normalize(image, image, 0, 255, cv::NORM_MINMAX);
+    return image;
+}
+
+// 参考实现：原流程 cropTextRegion -> (rotate 180) -> PPOCR pad + resize
+cv::Mat referenceInput(const cv::Mat& image, const std::vector<cv::Point2f>& box,
+                       bool rotate180, int target_width) {
+    cv::Mat crop = Geometry::cropTextRegion(image, box);
+    if (rotate180) {
+        cv::rotate(crop, crop, cv::ROTATE_180);
+    }
+    float target_ratio = static_cast<float>(target_width) / kTargetHeight;
+    float orig_ratio = static_cast<float>(crop.cols) / crop.rows;
+    cv::Mat padded = crop;
+    if (orig_ratio < target_ratio) {
+        int pad_w = static_cast<int>(crop.rows * target_ratio) - crop.cols;
+        cv::copyMakeBorder(crop, padded, 0, 0, 0, pad_w, cv::BORDER_CONSTANT, cv::Scalar(114, 114, 114));
+    }
+    cv::Mat resized;
+    cv::resize(padded, resized, cv::Size(target_width, kTargetHeight));
+    return resized;
+}
+
+// 比较内容区（去掉与补边相邻的接缝列），平均误差应很小
+void expectClose(const cv::Mat& fused, const cv::Mat& expected, int content_w, double tolerance) {
+    ASSERT_EQ(fused.size(), expected.size());
+    ASSERT_EQ(fused.type(), expected.type());
+    int interior_w = content_w < fused.cols ? content_w - 2 : content_w;
+    cv::Rect interior(0, 0, interior_w, fused.rows);
+    cv::Mat diff;
+    cv::absdiff(fused(interior), expected(interior), diff);
+    cv::Scalar mean = cv::mean(diff);
+    EXPECT_LT((mean[0] + mean[1] + mean[2]) / 3.0, tolerance);
+}
+
+int contentWidth(const TextCropGeometry& geom, int target_width) {
+    float target_ratio = static_cast<float>(target_width) / kTargetHeight;
+    float orig_ratio = static_cast<float>(geom.outWidth()) / geom.outHeight();
+    int padded_w = orig_ratio < target_ratio ? static_cast<int>(geom.outHeight() * target_ratio)
+                                             : geom.outWidth();
+    return std::min(target_width, cvRound(geom.outWidth() * static_cast<double>(target_width) / padded_w));
+}
+
+} // namespace
+
+/**
+ * @brief 倾斜框：透视裁剪 + 补边 + resize 合成一次采样
+ */
+TEST(TextCrop, RotatedBoxMatchesReference) {
+    cv::Mat image = smoothImage(400, 600);
+    std::vector<cv::Point2f> box = {{100, 120}, {400, 80}, {406, 130}, {106, 170}};
+
+    TextCropGeometry geom;
+    ASSERT_TRUE(computeTextCropGeometry(box, geom));
+    EXPECT_FALSE(geom.axisAligned);
+    EXPECT_FALSE(geom.vertical);
+
+    cv::Mat fused;
+    renderRecognitionInput(image, geom, false, 480, kTargetHeight, fused);
+    expectClose(fused, referenceInput(image, box, false, 480), contentWidth(geom, 480), 2.0);
+
+    // 补边区全部为 114
+    int content_w = contentWidth(geom, 480);
+    ASSERT_LT(content_w + 1, 480);
+    cv::Mat pad = fused(cv::Rect(content_w + 1, 0, 480 - content_w - 1, kTargetHeight)).reshape(1);
+    EXPECT_EQ(cv::countNonZero(pad != 114), 0);
+}
+
+/**
+ * @brief 竖排文本：旋转 90 度并入采样
+ */
+TEST(TextCrop, VerticalBoxMatchesReference) {
+    cv::Mat image = smoothImage(500, 300);
+    std::vector<cv::Point2f> box = {{120, 40}, {160, 40}, {160, 400}, {120, 400}};
+    // 轻微倾斜，避免走轴对齐快速路径
+    box[1].y += 3;
+    box[2].y += 3;
+
+    TextCropGeometry geom;
+    ASSERT_TRUE(computeTextCropGeometry(box, geom));
+    EXPECT_TRUE(geom.vertical);
+    EXPECT_GT(geom.outWidth(), geom.outHeight());
+
+    cv::Mat fused;
+    renderRecognitionInput(image, geom, false, 480, kTargetHeight, fused);
+    expectClose(fused, referenceInput(image, box, false, 480), contentWidth(geom, 480), 2.0);
+}
+
+/**
+ * @brief 分类结果为 180 度时，翻转并入采样
+ */
+TEST(TextCrop, Rotate180MatchesReference) {
+    cv::Mat image = smoothImage(300, 500);
+    std::vector<cv::Point2f> box = {{50, 100}, {450, 110}, {449, 160}, {49, 150}};
+
+    TextCropGeometry geom;
+    ASSERT_TRUE(computeTextCropGeometry(box, geom));
+
+    cv::Mat fused;
+    renderRecognitionInput(image, geom, true, 480, kTargetHeight, fused);
+    expectClose(fused, referenceInput(image, box, true, 480), contentWidth(geom, 480), 2.0);
+}
+
+/**
+ * @brief 轴对齐框走 ROI + resize 快速路径，并直接写入预分配缓冲
+ */
+TEST(TextCrop, AxisAlignedFastPath) {
+    cv::Mat image = smoothImage(300, 500);
+    std::vector<cv::Point2f> box = {{40, 60}, {340, 60}, {340, 100}, {40, 100}};
+
+    TextCropGeometry geom;
+    ASSERT_TRUE(computeTextCropGeometry(box, geom));
+    EXPECT_TRUE(geom.axisAligned);
+
+    cv::Mat fused(kTargetHeight, 480, CV_8UC3);
+    uint8_t* data = fused.data;
+    renderRecognitionInput(image, geom, false, 480, kTargetHeight, fused);
+    EXPECT_EQ(fused.data, data);
+    expectClose(fused, referenceInput(image, box, false, 480), contentWidth(geom, 480), 1.0);
+}
+
+/**
+ * @brief 分类输入：裁剪图拉伸到固定尺寸
+ */
+TEST(TextCrop, ClassifierInputMatchesReference) {
+    cv::Mat image = smoothImage(400, 600);
+    std::vector<cv::Point2f> box = {{100, 120}, {400, 80}, {406, 130}, {106, 170}};
+
+    TextCropGeometry geom;
+    ASSERT_TRUE(computeTextCropGeometry(box, geom));
+
+    cv::Mat fused(80, 160, CV_8UC3);
+    renderTextCrop(image, geom, false, fused);
+
+    cv::Mat expected;
+    cv::resize(Geometry::cropTextRegion(image, box), expected, cv::Size(160, 80));
+    expectClose(fused, expected, 160, 2.0);
+}
+
+/**
+ * @brief 退化框返回 false
+ */
+TEST(TextCrop, DegenerateBoxRejected) {
+    TextCropGeometry geom;
+    EXPECT_FALSE(computeTextCropGeometry({{10, 10}, {10, 10}, {10, 10}, {10, 10}}, geom));
+    EXPECT_FALSE(computeTextCropGeometry({{10, 10}, {20, 10}, {20, 20}}, geom));
+}
@@ -0,0 +1,232 @@
+/**
+ * @file test_text_detector.cpp
+ * @brief TextDetector 前处理与概率图缓存测试（不加载模型）
+ * 
+ * 验证融合的 pad + resize 与原先"先补成正方形再缩放"的结果一致，
+ * 以及概率图缓存的量化精度、缓存键和命中时的后处理结果
+ */
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include "detection/text_detector.h"
+#include "detection/db_postprocess.h"
+
+using namespace ocr;
+
+namespace {
+
+// 参考实现：copyMakeBorder 补成正方形后整体缩放
+cv::Mat referencePreprocess(const cv::Mat& image, int target_size, int& padded_size) {
+    padded_size = std::max(image.rows, image.cols);
+    cv::Mat padded;
+    cv::copyMakeBorder(image, padded, 0, padded_size - image.rows, 0, padded_size - image.cols,
+                       cv::BORDER_CONSTANT, cv::Scalar(114, 114, 114));
+    cv::Mat resized;
+    cv::resize(padded, resized, cv::Size(target_size, target_size));
+    return resized;
+}
+
+cv::Mat randomImage(int rows, int cols) {
+    cv::Mat image(rows, cols, CV_8UC3);
+    cv::RNG rng(rows * 131 + cols);
+    rng.fill(image, cv::RNG::UNIFORM, 0, 256);
+    return image;
+}
+
+void expectMatchesReference(const cv::Mat& image, int target_size) {
+    TextDetector detector{DetectorConfig{}};
+    int resized_h = 0, resized_w = 0;
+    BufferLease input = detector.preprocessAsync(image, target_size, resized_h, resized_w);
+    const cv::Mat& fused = input.mat();
+
+    int padded_size = 0;
+    cv::Mat expected = referencePreprocess(image, target_size, padded_size);
+
+    // 坐标映射使用的尺寸不变
+    EXPECT_EQ(resized_h, padded_size);
+    EXPECT_EQ(resized_w, padded_size);
+    ASSERT_EQ(fused.size(), expected.size());
+    ASSERT_EQ(fused.type(), expected.type());
+
+    double scale = static_cast<double>(target_size) / padded_size;
+    int content_w = cvRound(image.cols * scale);
+    int content_h = cvRound(image.rows * scale);
+
+    // 图像区域：除去与填充区相邻的接缝行/列外逐像素一致
+    int interior_w = content_w < target_size ? content_w - 2 : content_w;
+    int interior_h = content_h < target_size ? content_h - 2 : content_h;
+    cv::Rect interior(0, 0, interior_w, interior_h);
+    cv::Mat diff;
+    cv::absdiff(fused(interior), expected(interior), diff);
+    EXPECT_EQ(cv::countNonZero(diff.reshape(1)), 0)
+        << image.cols << "x" << image.rows << " -> " << target_size;
+
+    // 填充区域全部为 114
+    if (content_w + 1 < target_size) {
+        cv::Rect right(content_w + 1, 0, target_size - content_w - 1, target_size);
+        cv::Mat pad = fused(right).reshape(1);
+        EXPECT_EQ(cv::countNonZero(pad != 114), 0);
+    }
+    if (content_h + 1 < target_size) {
+        cv::Rect bottom(0, content_h + 1, target_size, target_size - content_h - 1);
+        cv::Mat pad = fused(bottom).reshape(1);
+        EXPECT_EQ(cv::countNonZero(pad != 114), 0);
+    }
+}
+
+} // namespace
+
+TEST(TextDetectorPreprocess, WideImageDownscale) {
+    expectMatchesReference(randomImage(900, 1600), 960);
+}
+
+TEST(TextDetectorPreprocess, TallImageDownscale) {
+    expectMatchesReference(randomImage(1800, 1349), 960);
+}
+
+TEST(TextDetectorPreprocess, SmallImageUpscale) {
+    expectMatchesReference(randomImage(200, 300), 640);
+}
+
+TEST(TextDetectorPreprocess, SquareImage) {
+    expectMatchesReference(randomImage(700, 700), 640);
+}
+
+// ==================== 概率图缓存 ====================
+
+namespace {
+
+DetectorConfig cachedConfig() {
+    DetectorConfig config;
+    config.probMapCacheSize = 4;
+    return config;
+}
+
+// 640 概率图上的两行文字（背景 0.02）
+cv::Mat syntheticProbMap() {
+    cv::Mat pred(640, 640, CV_32FC1, cv::Scalar(0.02));
+    pred(cv::Rect(64, 128, 192, 32)).setTo(0.9);
+    pred(cv::Rect(320, 400, 160, 24)).setTo(0.75);
+    return pred;
+}
+
+} // namespace
+
+/**
+ * @brief u8 量化往返：[0, 1] 内误差不超过半个量化步长，越界值饱和到 0 / 1
+ */
+TEST(TextDetectorProbMapCache, QuantizeRoundtrip) {
+    TextDetector detector{cachedConfig()};
+
+    cv::Mat pred(96, 128, CV_32FC1);
+    cv::RNG rng(7);
+    rng.fill(pred, cv::RNG::UNIFORM, 0.0, 1.0);
+    pred.at<float>(0, 0) = -0.5f;
+    pred.at<float>(0, 1) = 1.5f;
+    pred.at<float>(0, 2) = 1.0f;
+
+    detector.storeProbMap(42, pred);
+    cv::Mat restored;
+    ASSERT_TRUE(detector.lookupProbMap(42, restored));
+    ASSERT_EQ(restored.size(), pred.size());
+    ASSERT_EQ(restored.type(), CV_32FC1);
+
+    EXPECT_FLOAT_EQ(restored.at<float>(0, 0), 0.0f);
+    EXPECT_FLOAT_EQ(restored.at<float>(0, 1), 1.0f);
+    EXPECT_FLOAT_EQ(restored.at<float>(0, 2), 1.0f);
+    for (int y = 1; y < pred.rows; y++) {
+        for (int x = 0; x < pred.cols; x++) {
+            ASSERT_NEAR(restored.at<float>(y, x), pred.at<float>(y, x), 0.5f / 255.0f + 1e-6f);
+        }
+    }
+
+    EXPECT_FALSE(detector.lookupProbMap(43, restored));
+}
+
+/**
+ * @brief 同一图像在 640 / 960 下使用不同的键；相同像素（不同缓冲）键相同；缓存关闭时键为 0
+ */
+TEST(TextDetectorProbMapCache, KeysPerModelSize) {
+    TextDetector detector{cachedConfig()};
+    cv::Mat image = randomImage(300, 400);
+
+    uint64_t key640 = detector.probMapKey(image, 640);
+    uint64_t key960 = detector.probMapKey(image, 960);
+    EXPECT_NE(key640, 0u);
+    EXPECT_NE(key960, 0u);
+    EXPECT_NE(key640, key960);
+    EXPECT_EQ(detector.probMapKey(image.clone(), 640), key640);
+    EXPECT_NE(detector.probMapKey(randomImage(300, 401), 640), key640);
+
+    // 640 的概率图不会被 960 的请求取到
+    detector.storeProbMap(key640, syntheticProbMap());
+    cv::Mat pred;
+    EXPECT_TRUE(detector.lookupProbMap(key640, pred));
+    EXPECT_FALSE(detector.lookupProbMap(key960, pred));
+
+    TextDetector uncached{DetectorConfig{}};
+    EXPECT_EQ(uncached.probMapKey(image, 640), 0u);
+}
+
+/**
+ * @brief 命中缓存时的框与不经缓存的后处理一致（原图坐标），未命中时不触发回调
+ */
+TEST(TextDetectorProbMapCache, RunCachedMatchesPostprocess) {
+    DetectorConfig config = cachedConfig();
+    TextDetector detector{config};
+
+    std::vector<DeepXOCR::TextBox> boxes;
+    int64_t callbackTask = -1;
+    int callbacks = 0;
+    detector.setCallback([&](std::vector<DeepXOCR::TextBox> result, int64_t taskId, FramePtr,
+                             double, double, double) {
+        boxes = std::move(result);
+        callbackTask = taskId;
+        callbacks++;
+    });
+
+    const int orig_h = 300, orig_w = 400;
+    cv::Mat pred = syntheticProbMap();
+    const float thresh = 0.3f, boxThresh = 0.5f, unclipRatio = 2.0f;
+
+    EXPECT_FALSE(detector.runCached(0, orig_h, orig_w, 1, nullptr, 0.0, thresh, boxThresh, unclipRatio));
+    EXPECT_FALSE(detector.runCached(99, orig_h, orig_w, 1, nullptr, 0.0, thresh, boxThresh, unclipRatio));
+    EXPECT_EQ(callbacks, 0);
+
+    detector.storeProbMap(99, pred);
+    ASSERT_TRUE(detector.runCached(99, orig_h, orig_w, 7, nullptr, 0.0, thresh, boxThresh, unclipRatio));
+    EXPECT_EQ(callbacks, 1);
+    EXPECT_EQ(callbackTask, 7);
+
+    // 推理路径的后处理：float 概率图，坐标按补成正方形的原图映射
+    DBPostProcessor reference(config.thresh, config.boxThresh, config.maxCandidates, config.unclipRatio,
+                              config.quantizedBoxScore, config.componentBoxScore, config.postprocessWorkers,
+                              config.rectUnclip);
+    int padded = std::max(orig_h, orig_w);
+    auto expected = reference.process(pred, orig_h, orig_w, padded, padded, thresh, boxThresh, unclipRatio);
+
+    ASSERT_EQ(expected.size(), 2u);
+    ASSERT_EQ(boxes.size(), expected.size());
+    for (size_t i = 0; i < boxes.size(); i++) {
+        EXPECT_NEAR(boxes[i].confidence, expected[i].confidence, 1.0f / 255.0f);
+        for (int k = 0; k < 4; k++) {
+            EXPECT_FLOAT_EQ(boxes[i].points[k].x, expected[i].points[k].x);
+            EXPECT_FLOAT_EQ(boxes[i].points[k].y, expected[i].points[k].y);
+            EXPECT_GE(boxes[i].points[k].x, 0.0f);
+            EXPECT_LE(boxes[i].points[k].x, static_cast<float>(orig_w));
+            EXPECT_GE(boxes[i].points[k].y, 0.0f);
+            EXPECT_LE(boxes[i].points[k].y, static_cast<float>(orig_h));
+        }
+    }
+
+    // 640 图上 (64, 128) 起的文字行在原图中约为 (40, 80) 起（400 / 640 缩放）
+    float minX = orig_w, minY = orig_h;
+    for (const auto& box : boxes) {
+        for (const auto& p : box.points) {
+            minX = std::min(minX, p.x);
+            minY = std::min(minY, p.y);
+        }
+    }
+    EXPECT_NEAR(minX, 40.0f, 6.0f);
+    EXPECT_NEAR(minY, 80.0f, 6.0f);
+}
@@ -0,0 +1,134 @@
+/**
+ * @file test_text_recognizer.cpp
+ * @brief TextRecognizer 多 crop 拼接测试（不加载模型）
+ *
+ * 验证贪心分组、单 crop 回退，以及分组列范围经 CTC 分段解码后各 crop 互不串字
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "recognition/text_recognizer.h"
+
+using namespace DeepXOCR;
+using namespace ocr;
+
+namespace {
+
+constexpr int kAlign = 8;  // rec 模型 CTC 步长（列/时间步）
+
+} // namespace
+
+/**
+ * @brief 从左到右贪心填充：起点按 8 列对齐并留出分隔，放不下时开新组
+ */
+TEST(TextRecognizerPacking, GreedyGrouping) {
+    // 容量 240 列（ratio_5），分隔 24 列
+    auto groups = TextRecognizer::PlanPacking({100, 60, 90, 50}, 240, 24, kAlign);
+    ASSERT_EQ(groups.size(), 2u);
+
+    EXPECT_EQ(groups[0].begin, 0u);
+    ASSERT_EQ(groups[0].columns.size(), 2u);
+    EXPECT_EQ(groups[0].columns[0], std::make_pair(0, 100));
+    EXPECT_EQ(groups[0].columns[1], std::make_pair(128, 188));  // 100 + 24 = 124 -> 128
+
+    // 188 + 24 = 212 -> 216，216 + 90 > 240：第三个 crop 开新组，第四个跟随
+    EXPECT_EQ(groups[1].begin, 2u);
+    ASSERT_EQ(groups[1].columns.size(), 2u);
+    EXPECT_EQ(groups[1].columns[0], std::make_pair(0, 90));
+    EXPECT_EQ(groups[1].columns[1], std::make_pair(120, 170));  // 90 + 24 = 114 -> 120
+
+    // 每段都在容量内，段起点对齐到时间步，段与段之间至少隔 separator 列
+    for (const auto& group : groups) {
+        for (size_t i = 0; i < group.columns.size(); i++) {
+            EXPECT_EQ(group.columns[i].first % kAlign, 0);
+            EXPECT_LE(group.columns[i].second, 240);
+            if (i > 0) {
+                EXPECT_GE(group.columns[i].first - group.columns[i - 1].second, 24);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 放不下其他 crop 的组只含一个 crop（提交时回退为普通单 crop 输入）；
+ *        超过容量的 crop 单独成组，不与其他 crop 拼接
+ */
+TEST(TextRecognizerPacking, SingleCropGroups) {
+    auto groups = TextRecognizer::PlanPacking({200}, 240, 24, kAlign);
+    ASSERT_EQ(groups.size(), 1u);
+    EXPECT_EQ(groups[0].columns.size(), 1u);
+
+    groups = TextRecognizer::PlanPacking({200, 300, 30, 220}, 240, 24, kAlign);
+    ASSERT_EQ(groups.size(), 4u);
+    for (size_t i = 0; i < groups.size(); i++) {
+        EXPECT_EQ(groups[i].begin, i);
+        EXPECT_EQ(groups[i].columns.size(), 1u);  // 200 后放不下 300；超宽的 300 单独一组；30 后放不下 220
+        EXPECT_EQ(groups[i].columns[0].first, 0);
+    }
+    EXPECT_EQ(groups[1].columns[0].second, 300);
+
+    EXPECT_TRUE(TextRecognizer::PlanPacking({}, 240, 24, kAlign).empty());
+}
+
+/**
+ * @brief 没有可拼接的宽模型时每个 crop 的回调恰好触发一次（空结果）
+ */
+TEST(TextRecognizerPacking, NoWideModelFailsEveryCrop) {
+    TextRecognizer recognizer{RecognizerConfig{}};  // 未 Initialize：没有加载任何模型
+    std::vector<void*> called;
+    recognizer.RegisterCallback([&](const std::string& text, float confidence, void* userArg) {
+        EXPECT_TRUE(text.empty());
+        EXPECT_EQ(confidence, 0.0f);
+        called.push_back(userArg);
+    });
+
+    TextCropGeometry geom;
+    geom.width = 40;
+    geom.height = 20;
+    int args[3];
+    std::vector<PackedCrop> crops;
+    for (int& arg : args) {
+        crops.push_back(PackedCrop{&geom, false, &arg});
+    }
+    cv::Mat image(64, 64, CV_8UC3, cv::Scalar(255, 255, 255));
+    EXPECT_EQ(recognizer.RecognizePackedAsync(image, crops), 0);
+    ASSERT_EQ(called.size(), 3u);
+    for (size_t i = 0; i < 3; i++) {
+        EXPECT_EQ(called[i], &args[i]);
+    }
+}
+
+/**
+ * @brief 分组得到的列范围经 CTC 分段解码后，每个 crop 只得到自己的字符
+ */
+TEST(TextRecognizerPacking, PlannedColumnsDecodePerCrop) {
+    CTCDecoder decoder(std::vector<std::string>{"a", "b", "c"}, false);  // 0=blank, 1=a, 2=b, 3=c
+    const int numClasses = 4;
+    const int inputWidth = 240;
+    const int timeSteps = inputWidth / kAlign;
+
+    // 三个 crop 各自的字符，crop 内容满铺自己的列范围（包括最后一个时间步）
+    std::vector<int> widths = {40, 30, 50};
+    std::vector<int> labels = {1, 2, 3};
+    auto groups = TextRecognizer::PlanPacking(widths, inputWidth, 8, kAlign);
+    ASSERT_EQ(groups.size(), 1u);
+    const auto& columns = groups[0].columns;
+
+    std::vector<float> logits(static_cast<size_t>(timeSteps) * numClasses, 0.0001f);
+    for (int t = 0; t < timeSteps; t++) {
+        int label = 0;  // 分隔和右侧空白为 blank
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (t * kAlign < columns[i].second && (t + 1) * kAlign > columns[i].first) {
+                label = labels[i];
+            }
+        }
+        logits[static_cast<size_t>(t) * numClasses + label] = 0.9f;
+    }
+
+    auto results = decoder.decodeColumns(logits.data(), timeSteps, inputWidth, columns);
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0].first, "a");
+    EXPECT_EQ(results[1].first, "b");
+    EXPECT_EQ(results[2].first, "c");
+}
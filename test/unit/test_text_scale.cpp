@@ -0,0 +1,72 @@
+/**
+ * @file test_text_scale.cpp
+ * @brief 文字笔画宽度估计测试（检测模型分辨率自适应选择使用）
+ *
+ * 用已知笔画宽度的合成"文字"（竖笔画）验证估计值、缩略图缩放后的换算和浅色文字
+ */
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include "detection/text_scale.h"
+
+using namespace ocr;
+
+namespace {
+
+// 白底黑色竖笔画，笔画宽 stroke，高 6 * stroke，按行排列
+cv::Mat syntheticText(int size, int stroke) {
+    cv::Mat image(size, size, CV_8UC3, cv::Scalar::all(255));
+    int height = stroke * 6;
+    for (int y = stroke * 2; y + height < size; y += height + stroke * 4) {
+        for (int x = stroke * 2; x + stroke < size; x += stroke * 3) {
+            cv::rectangle(image, cv::Rect(x, y, stroke, height), cv::Scalar::all(0), cv::FILLED);
+        }
+    }
+    return image;
+}
+
+} // namespace
+
+/**
+ * @brief 原尺寸下估计值等于笔画宽度
+ */
+TEST(TextScale, MeasuresStrokeWidth) {
+    auto estimate = estimateTextScale(syntheticText(600, 3));
+    ASSERT_TRUE(estimate.valid);
+    EXPECT_NEAR(estimate.strokeWidth, 3.0f, 0.5f);
+}
+
+/**
+ * @brief 大图在缩略图上测量，结果换算回原图像素
+ */
+TEST(TextScale, ScalesBackFromThumbnail) {
+    auto estimate = estimateTextScale(syntheticText(3000, 15));
+    ASSERT_TRUE(estimate.valid);
+    EXPECT_NEAR(estimate.strokeWidth, 15.0f, 3.5f);
+
+    auto thin = estimateTextScale(syntheticText(3000, 4));
+    ASSERT_TRUE(thin.valid);
+    EXPECT_LT(thin.strokeWidth, estimate.strokeWidth / 2);
+}
+
+/**
+ * @brief 深色背景上的浅色文字与白底黑字结果相同
+ */
+TEST(TextScale, LightTextOnDarkBackground) {
+    cv::Mat image = syntheticText(600, 5);
+    cv::Mat inverted;
+    cv::bitwise_not(image, inverted);
+    auto normal = estimateTextScale(image);
+    auto light = estimateTextScale(inverted);
+    ASSERT_TRUE(light.valid);
+    EXPECT_FLOAT_EQ(light.strokeWidth, normal.strokeWidth);
+}
+
+/**
+ * @brief 空白图像墨迹不足，估计无效（回退到尺寸规则）
+ */
+TEST(TextScale, BlankImageIsInconclusive) {
+    cv::Mat blank(800, 600, CV_8UC3, cv::Scalar::all(255));
+    EXPECT_FALSE(estimateTextScale(blank).valid);
+    EXPECT_FALSE(estimateTextScale(cv::Mat()).valid);
+}
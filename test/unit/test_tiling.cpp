@@ -0,0 +1,159 @@
+/**
+ * @file test_tiling.cpp
+ * @brief 大图分块检测的分块规划与检测框合并测试
+ *
+ * 验证分块完整覆盖页面且相邻重叠不小于设定值、块数上限，以及重叠带内重复框和截断文本行的合并
+ */
+
+#include <gtest/gtest.h>
+#include <opencv2/opencv.hpp>
+#include "detection/tiling.h"
+
+using namespace ocr;
+using namespace ocr::tiling;
+
+namespace {
+
+DeepXOCR::TextBox makeBox(float x0, float y0, float x1, float y1, float score = 0.9f) {
+    DeepXOCR::TextBox box;
+    box.points[0] = cv::Point2f(x0, y0);
+    box.points[1] = cv::Point2f(x1, y0);
+    box.points[2] = cv::Point2f(x1, y1);
+    box.points[3] = cv::Point2f(x0, y1);
+    box.confidence = score;
+    return box;
+}
+
+// 采样点（含最后一行/列）至少被一个分块覆盖；落在某个独占区域内的点只被一个分块覆盖
+void expectCovers(const std::vector<Tile>& tiles, int height, int width) {
+    for (const auto& tile : tiles) {
+        ASSERT_GE(tile.rect.x, 0);
+        ASSERT_GE(tile.rect.y, 0);
+        ASSERT_LE(tile.rect.x + tile.rect.width, width);
+        ASSERT_LE(tile.rect.y + tile.rect.height, height);
+    }
+    auto check = [&tiles](int x, int y) {
+        cv::Point point(x, y);
+        int covering = 0;
+        bool exclusive = false;
+        for (const auto& tile : tiles) {
+            covering += tile.rect.contains(point) ? 1 : 0;
+            exclusive = exclusive || tile.exclusive.contains(point);
+        }
+        EXPECT_GE(covering, 1) << "(" << x << ", " << y << ")";
+        if (exclusive) {
+            EXPECT_EQ(covering, 1) << "(" << x << ", " << y << ")";
+        }
+    };
+    for (int y = 0; y < height; y += 37) {
+        for (int x = 0; x < width; x += 37) {
+            check(x, y);
+        }
+        check(width - 1, y);
+    }
+    check(width - 1, height - 1);
+}
+
+} // namespace
+
+// ==================== 分块规划 ====================
+
+/**
+ * @brief 不超过分块边长的页面只有一块
+ */
+TEST(Tiling, SmallPageIsSingleTile) {
+    auto tiles = planTiles(700, 900, 960, 128, 64);
+    ASSERT_EQ(tiles.size(), 1u);
+    EXPECT_EQ(tiles[0].rect, cv::Rect(0, 0, 900, 700));
+    EXPECT_EQ(tiles[0].exclusive, tiles[0].rect);
+}
+
+/**
+ * @brief 长票据：单列多行，覆盖整页，相邻重叠不小于设定值
+ */
+TEST(Tiling, LongReceiptOverlap) {
+    const int height = 12000, width = 800;
+    auto tiles = planTiles(height, width, 960, 128, 64);
+    ASSERT_GT(tiles.size(), 1u);
+    expectCovers(tiles, height, width);
+
+    for (size_t i = 0; i < tiles.size(); i++) {
+        EXPECT_EQ(tiles[i].rect.x, 0);
+        EXPECT_EQ(tiles[i].rect.width, width);
+        EXPECT_EQ(tiles[i].rect.height, 960);
+        if (i > 0) {
+            int overlap = tiles[i - 1].rect.y + tiles[i - 1].rect.height - tiles[i].rect.y;
+            EXPECT_GE(overlap, 128);
+        }
+    }
+    EXPECT_EQ(tiles.back().rect.y + tiles.back().rect.height, height);
+}
+
+/**
+ * @brief 超过块数上限时分块放大，块数不超过上限且仍覆盖整页
+ */
+TEST(Tiling, MaxTilesGrowsTiles) {
+    const int height = 14000, width = 20000;
+    auto unbounded = planTiles(height, width, 960, 128, 0);
+    EXPECT_GT(unbounded.size(), 64u);
+
+    auto tiles = planTiles(height, width, 960, 128, 64);
+    EXPECT_LE(tiles.size(), 64u);
+    EXPECT_GT(tiles[0].rect.width, 960);
+    expectCovers(tiles, height, width);
+}
+
+// ==================== 检测框合并 ====================
+
+/**
+ * @brief 两个分块在重叠带里检测到的同一个框只保留一个
+ */
+TEST(Tiling, MergesDuplicateInOverlap) {
+    // 页面 1800 宽，两块 [0, 960) 和 [840, 1800)，重叠带 [840, 960)
+    auto tiles = planTiles(500, 1800, 960, 120, 0);
+    ASSERT_EQ(tiles.size(), 2u);
+
+    std::vector<std::vector<DeepXOCR::TextBox>> boxes(2);
+    boxes[0] = {makeBox(100, 100, 300, 130), makeBox(860, 200, 940, 230, 0.7f)};
+    boxes[1] = {makeBox(861, 201, 941, 229, 0.8f), makeBox(1500, 100, 1700, 130)};
+
+    auto merged = mergeTileBoxes(boxes, tiles);
+    ASSERT_EQ(merged.size(), 3u);
+    EXPECT_FLOAT_EQ(merged[1].confidence, 0.8f);
+    cv::Rect rect = merged[1].GetRect();
+    EXPECT_NEAR(rect.x, 860, 1);
+    EXPECT_NEAR(rect.x + rect.width, 941, 1);
+}
+
+/**
+ * @brief 被分块边界截断的长文本行拼回一个框
+ */
+TEST(Tiling, JoinsLineCutByTileBorder) {
+    auto tiles = planTiles(500, 1800, 960, 120, 0);
+    ASSERT_EQ(tiles.size(), 2u);
+
+    std::vector<std::vector<DeepXOCR::TextBox>> boxes(2);
+    boxes[0] = {makeBox(200, 300, 959, 330)};   // 在第一块右边缘截断
+    boxes[1] = {makeBox(841, 301, 1600, 331)};  // 在第二块左边缘截断
+
+    auto merged = mergeTileBoxes(boxes, tiles);
+    ASSERT_EQ(merged.size(), 1u);
+    cv::Rect rect = merged[0].GetRect();
+    EXPECT_NEAR(rect.x, 200, 1);
+    EXPECT_NEAR(rect.x + rect.width, 1600, 1);
+}
+
+/**
+ * @brief 上下相邻的两行、同一分块内相交的框都不合并
+ */
+TEST(Tiling, KeepsDistinctBoxes) {
+    auto tiles = planTiles(500, 1800, 960, 120, 0);
+    ASSERT_EQ(tiles.size(), 2u);
+
+    std::vector<std::vector<DeepXOCR::TextBox>> boxes(2);
+    boxes[0] = {makeBox(700, 100, 950, 130), makeBox(700, 125, 950, 155)};  // 同一分块，边缘相交
+    boxes[1] = {makeBox(850, 152, 1200, 182)};                              // 下一行，与上一行仅边缘接触
+
+    auto merged = mergeTileBoxes(boxes, tiles);
+    EXPECT_EQ(merged.size(), 3u);
+}